@@ -33,6 +33,19 @@ enum class TokenType
     ORDERBY,
     AUTO_INCREMENT,
     NULL_T,UNIQUE,
+    JOIN,
+    ON,
+    VACUUM,
+    ANALYZE,
+    EXPLAIN,
+    ALTER,
+    ADD,
+    COLUMN,
+    DEFAULT,
+    ENGINE,
+    INDEX,
+    USING,
+    INCLUDE,
     
      INT, VARCHAR, PRIMARY, KEY,
 
@@ -79,6 +92,17 @@ static const std::unordered_map<std::string, TokenType> keywords = {
     {"table", TokenType::TABLE},
     {"delete", TokenType::DELETE},
     {"update", TokenType::UPDATE},
+    {"vacuum", TokenType::VACUUM},
+    {"analyze", TokenType::ANALYZE},
+    {"explain", TokenType::EXPLAIN},
+    {"alter", TokenType::ALTER},
+    {"add", TokenType::ADD},
+    {"column", TokenType::COLUMN},
+    {"default", TokenType::DEFAULT},
+    {"engine", TokenType::ENGINE},
+    {"index", TokenType::INDEX},
+    {"using", TokenType::USING},
+    {"include", TokenType::INCLUDE},
     {"set", TokenType::SET},
     {"and", TokenType::AND},
     {"or", TokenType::OR},
@@ -95,7 +119,9 @@ static const std::unordered_map<std::string, TokenType> keywords = {
     {"key",TokenType::KEY},
     {"auto_increment",TokenType::AUTO_INCREMENT},
     {"null",TokenType::NULL_T},
-    {"unique",TokenType::UNIQUE}
+    {"unique",TokenType::UNIQUE},
+    {"join",TokenType::JOIN},
+    {"on",TokenType::ON}
 };
 
 static const std::unordered_map<char, TokenType> singleCharTokens = {
@@ -125,6 +151,17 @@ std::string typeToString(TokenType TYPE)
     case TokenType::TABLE: return "TABLE";
     case TokenType::DELETE: return "DELETE";
     case TokenType::UPDATE: return "UPDATE";
+    case TokenType::VACUUM: return "VACUUM";
+    case TokenType::ANALYZE: return "ANALYZE";
+    case TokenType::EXPLAIN: return "EXPLAIN";
+    case TokenType::ALTER: return "ALTER";
+    case TokenType::ADD: return "ADD";
+    case TokenType::COLUMN: return "COLUMN";
+    case TokenType::DEFAULT: return "DEFAULT";
+    case TokenType::ENGINE: return "ENGINE";
+    case TokenType::INDEX: return "INDEX";
+    case TokenType::USING: return "USING";
+    case TokenType::INCLUDE: return "INCLUDE";
     case TokenType::SET: return "SET";
     case TokenType::AND: return "AND";
     case TokenType::OR: return "OR";
@@ -137,6 +174,8 @@ std::string typeToString(TokenType TYPE)
     case TokenType::AUTO_INCREMENT: return "AUTO_INCREMENT";
     case TokenType::NULL_T : return "NULL";
     case TokenType::UNIQUE : return "UNIQUE";
+    case TokenType::JOIN: return "JOIN";
+    case TokenType::ON: return "ON";
     
     // Data types
     case TokenType::INT: return "INT";             // Added this
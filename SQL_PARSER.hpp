@@ -13,6 +13,7 @@
 #include "global.hpp"
 #include "utility.hpp"
 #include "generator.hpp"
+#include "queryExecutor.hpp"
 namespace fs = std::filesystem; // Shorthand for std::filesystem
 
 bool fileExists(const std::string &filename)
@@ -67,6 +68,58 @@ private:
         return false;
     }
 
+    // Keywords that only mean something inside their own clause. Anywhere a
+    // name is expected they are read as one, so tables and columns created
+    // before these statements existed (index, default, ...) still parse.
+    static bool isContextualKeyword(TokenType type)
+    {
+        switch (type)
+        {
+        case TokenType::VACUUM:
+        case TokenType::ANALYZE:
+        case TokenType::EXPLAIN:
+        case TokenType::ALTER:
+        case TokenType::ADD:
+        case TokenType::COLUMN:
+        case TokenType::DEFAULT:
+        case TokenType::ENGINE:
+        case TokenType::INDEX:
+        case TokenType::USING:
+        case TokenType::INCLUDE:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    static bool isIdentifier(const Token *token)
+    {
+        return token && (token->TYPE == TokenType::IDENTIFIER || isContextualKeyword(token->TYPE));
+    }
+
+    bool matchIdentifier()
+    {
+        if (!isIdentifier(current()))
+            return false;
+        advance();
+        return true;
+    }
+
+    Token *expectIdentifier(const std::string &message)
+    {
+        if (matchIdentifier())
+            return previous();
+        throw std::runtime_error("Parse error: " + message);
+    }
+
+    // Writes must not drop a clause they failed to parse, that would widen their WHERE
+    void expectEnd(const std::string &statement)
+    {
+        match(TokenType::SEMICOLON);
+        if (current() && current()->TYPE != TokenType::END_OF_FILE)
+            throw std::runtime_error("Parse error: Unexpected '" + current()->VALUE + "' in " + statement);
+    }
+
     Token *expect(TokenType expected, const std::string &message)
     {
         if (match(expected))
@@ -121,25 +174,21 @@ public:
             in.close();
             std::string jsonContent = buffer.str();
 
-            JSONParser jsonParser;
-            if (!jsonParser.appendFromString(jsonContent))
+            JSONDocument document;
+            try
+            {
+                document.parse(std::move(jsonContent));
+            }
+            catch (const std::exception &)
             {
                 throw std::runtime_error("Failed to parse current_db.meta JSON.");
             }
-            JSONParser::JSONValue obj = jsonParser.getObject(0);
 
-            if (std::holds_alternative<JSONParser::JSONObject>(obj.value))
+            auto value = document.root().find("current_db");
+            if (value && value->isString())
             {
-                auto jsonObj = std::get<JSONParser::JSONObject>(obj.value);
-                if (jsonObj.find("current_db") != jsonObj.end())
-                {
-                    const auto &val = jsonObj["current_db"];
-                    if (std::holds_alternative<std::string>(val.value))
-                    {
-                        this->currentDb = std::get<std::string>(val.value); // store it inside parser
-                        currentDatabase = this->currentDb;
-                    }
-                }
+                this->currentDb = std::string(value->getString()); // store it inside parser
+                currentDatabase = this->currentDb;
             }
         }
     }
@@ -149,7 +198,7 @@ public:
         expect(TokenType::INSERT, "Expected 'INSERT'");
         expect(TokenType::INTO, "Expected 'INTO'");
 
-        Token *tableToken = expect(TokenType::IDENTIFIER, "Expected table name");
+        Token *tableToken = expectIdentifier("Expected table name");
         std::unique_ptr<InsertStatement> stmt = std::make_unique<InsertStatement>();
         stmt->tableName = tableToken->VALUE;
 
@@ -158,7 +207,7 @@ public:
         // Parse columns
         do
         {
-            Token *col = expect(TokenType::IDENTIFIER, "Expected column name");
+            Token *col = expectIdentifier("Expected column name");
             stmt->columns.push_back(col->VALUE);
         } while (match(TokenType::COMMA));
 
@@ -186,70 +235,95 @@ public:
         return stmt;
     }
 
-    std::unique_ptr<CreateStatement> parseCreateStatement()
+    // name type [(size)] followed by constraints and DEFAULT in any order
+    ColumnDefinition parseColumnDefinition()
     {
-        expect(TokenType::CREATE, "Expected CREATE keyword");
-        std::unique_ptr<CreateStatement> stmt = std::make_unique<CreateStatement>();
+        Token *colName = expectIdentifier("Expected column name");
 
-        if (match(TokenType::TABLE))
+        Token *typeToken = current();
+        if (match(TokenType::INT) || match(TokenType::VARCHAR))
         {
-            Token *tableName = expect(TokenType::IDENTIFIER, "Expected table name");
-            stmt->name = tableName->VALUE;
+            typeToken = previous();
+        }
+        else
+        {
+            throw std::runtime_error("Parse error: Expected column type (int or varchar)");
+        }
 
-            expect(TokenType::OPEN_PAREN, "Expected '(' after table name");
+        ColumnDefinition column(colName->VALUE, typeToken->VALUE);
 
-            while (!match(TokenType::CLOSE_PAREN))
-            {
-                Token *colName = expect(TokenType::IDENTIFIER, "Expected column name");
+        // Handle VARCHAR(255) size syntax
+        if (typeToken->TYPE == TokenType::VARCHAR && match(TokenType::OPEN_PAREN))
+        {
+            Token *size = expect(TokenType::NUMBER, "Expected size in VARCHAR()");
+            expect(TokenType::CLOSE_PAREN, "Expected ')' after VARCHAR size");
+            column.type += "(" + size->VALUE + ")";
+        }
 
-                Token *typeToken = current();
-                if (match(TokenType::INT) || match(TokenType::VARCHAR))
+        // Parse optional constraints
+        while (true)
+        {
+            if (match(TokenType::NOT))
+            {
+                expect(TokenType::NULL_T, "Expected NULL after NOT");
+                column.constraints.push_back(ColumnConstraint::NOT_NULL);
+            }
+            else if (match(TokenType::PRIMARY))
+            {
+                expect(TokenType::KEY, "Expected KEY after PRIMARY");
+                column.constraints.push_back(ColumnConstraint::PRIMARY_KEY);
+            }
+            else if (match(TokenType::AUTO_INCREMENT))
+            {
+                column.constraints.push_back(ColumnConstraint::AUTO_INCREMENT);
+            }
+            else if (match(TokenType::UNIQUE))
+            {
+                column.constraints.push_back(ColumnConstraint::UNIQUE);
+            }
+            else if (match(TokenType::DEFAULT))
+            {
+                bool negative = match(TokenType::MINUS);
+                if (match(TokenType::NUMBER))
                 {
-                    typeToken = previous();
+                    column.defaultValue = std::stoi((negative ? "-" : "") + previous()->VALUE);
                 }
-                else
+                else if (!negative && match(TokenType::STRING))
                 {
-                    throw std::runtime_error("Parse error: Expected column type (int or varchar)");
+                    column.defaultValue = previous()->VALUE;
                 }
-
-                ColumnDefinition column(colName->VALUE, typeToken->VALUE);
-
-                // Handle VARCHAR(255) size syntax
-                if (typeToken->TYPE == TokenType::VARCHAR && match(TokenType::OPEN_PAREN))
+                else if (!negative && match(TokenType::NULL_T))
                 {
-                    Token *size = expect(TokenType::NUMBER, "Expected size in VARCHAR()");
-                    expect(TokenType::CLOSE_PAREN, "Expected ')' after VARCHAR size");
-                    column.type += "(" + size->VALUE + ")";
+                    column.defaultValue = nullptr;
                 }
-
-                // Parse optional constraints
-                while (true)
+                else
                 {
-                    if (match(TokenType::NOT))
-                    {
-                        expect(TokenType::NULL_T, "Expected NULL after NOT");
-                        column.constraints.push_back(ColumnConstraint::NOT_NULL);
-                    }
-                    else if (match(TokenType::PRIMARY))
-                    {
-                        expect(TokenType::KEY, "Expected KEY after PRIMARY");
-                        column.constraints.push_back(ColumnConstraint::PRIMARY_KEY);
-                    }
-                    else if (match(TokenType::AUTO_INCREMENT))
-                    {
-                        column.constraints.push_back(ColumnConstraint::AUTO_INCREMENT);
-                    }
-                    else if (match(TokenType::UNIQUE))
-                    {
-                        column.constraints.push_back(ColumnConstraint::UNIQUE);
-                    }
-                    else
-                    {
-                        break;
-                    }
+                    throw std::runtime_error("Expected a number, string or NULL after DEFAULT");
                 }
+            }
+            else
+            {
+                break;
+            }
+        }
+        return column;
+    }
+
+    std::unique_ptr<CreateStatement> parseCreateStatement()
+    {
+        expect(TokenType::CREATE, "Expected CREATE keyword");
+        std::unique_ptr<CreateStatement> stmt = std::make_unique<CreateStatement>();
 
-                stmt->columns.push_back(column);
+        if (match(TokenType::TABLE))
+        {
+            Token *tableName = expectIdentifier("Expected table name");
+            stmt->name = tableName->VALUE;
+
+            expect(TokenType::OPEN_PAREN, "Expected '(' after table name");
+
+            while (!match(TokenType::CLOSE_PAREN))
+            {
+                stmt->columns.push_back(parseColumnDefinition());
 
                 if (match(TokenType::COMMA))
                 {
@@ -265,12 +339,24 @@ public:
                 }
             }
 
+            // ENGINE [=] ROW | COLUMNAR
+            if (match(TokenType::ENGINE))
+            {
+                match(TokenType::EQUAL);
+                std::string engine = expectIdentifier("Expected storage engine after ENGINE")->VALUE;
+                std::transform(engine.begin(), engine.end(), engine.begin(), ::tolower);
+                if (engine == "columnar")
+                    stmt->engine = StorageEngine::COLUMNAR;
+                else if (engine != "row")
+                    throw std::runtime_error("Unknown storage engine '" + engine + "', expected ROW or COLUMNAR");
+            }
+
             CommandRunner::generateCreateTableStatement(stmt);
         }
         else if (match(TokenType::DATABASE))
         {
             stmt->isDatabase = true;
-            stmt->name = expect(TokenType::IDENTIFIER, "Expected database name")->VALUE;
+            stmt->name = expectIdentifier("Expected database name")->VALUE;
             std::stringstream filename;
             filename << "./db/";
             filename << stmt->name;
@@ -291,6 +377,7 @@ public:
 }
 )";
                 MyUtility::createFile(filename.str(), s.str());
+                Catalog::addDatabase(stmt->name);
                 currentDatabase = stmt->name;
                 MyUtility::changeCurrentDb(currentDatabase);
             }
@@ -312,7 +399,7 @@ public:
         {
         case TokenType::TABLE:
         {
-            Token *identifier = expect(TokenType::IDENTIFIER, "not a identifier\n");
+            Token *identifier = expectIdentifier("not a identifier\n");
             stmt->name = identifier->VALUE;
             stmt->istable = true;
         }
@@ -320,7 +407,7 @@ public:
         break;
         case TokenType::DATABASE:
         {
-            Token *identifier = expect(TokenType::IDENTIFIER, "not a identifier\n");
+            Token *identifier = expectIdentifier("not a identifier\n");
             stmt->name = identifier->VALUE;
             stmt->istable = false;
         }
@@ -339,22 +426,60 @@ public:
 
         while (true)
         {
-            Token *column = expect(TokenType::IDENTIFIER, "Expected column name");
-            stmt->columns.push_back(column->VALUE);
+            if (match(TokenType::MULTIPLY))
+            {
+                stmt->columns.push_back("*");
+            }
+            else
+            {
+                stmt->columns.push_back(parseColumnReference());
+            }
             if (!match(TokenType::COMMA))
                 break;
         }
 
         expect(TokenType::FROM, "Expected FROM keyword");
-        Token *table = expect(TokenType::IDENTIFIER, "Expected table name");
+        Token *table = expectIdentifier("Expected table name");
         stmt->table = table->VALUE;
 
+        if (match(TokenType::JOIN))
+        {
+            auto join = std::make_unique<JoinClause>();
+            join->table = expectIdentifier("Expected table name after JOIN")->VALUE;
+            expect(TokenType::ON, "Expected ON after JOIN table");
+
+            join->leftTable = expectIdentifier("Expected table name in JOIN condition")->VALUE;
+            expect(TokenType::DOT, "Expected '.' in JOIN condition");
+            join->leftColumn = expectIdentifier("Expected column name in JOIN condition")->VALUE;
+            expect(TokenType::EQUAL, "Only equi-joins are supported");
+            join->rightTable = expectIdentifier("Expected table name in JOIN condition")->VALUE;
+            expect(TokenType::DOT, "Expected '.' in JOIN condition");
+            join->rightColumn = expectIdentifier("Expected column name in JOIN condition")->VALUE;
+
+            stmt->joinClause = std::move(join);
+        }
+
         if (match(TokenType::WHERE))
         {
             auto condition = parseExpression();
             stmt->whereClause = std::make_unique<WhereClause>(std::move(condition));
         }
 
+        if (match(TokenType::ORDER))
+        {
+            expect(TokenType::BY, "Expected BY after ORDER");
+            std::string column = parseColumnReference();
+            bool descending = false;
+            Token *direction = current();
+            if (direction && direction->TYPE == TokenType::IDENTIFIER &&
+                (direction->VALUE == "asc" || direction->VALUE == "desc"))
+            {
+                descending = direction->VALUE == "desc";
+                advance();
+            }
+            stmt->orderByClause = std::make_unique<OrderByClause>(column, descending);
+        }
+
         // Optional: limit
         if (match(TokenType::IDENTIFIER) && previous()->VALUE == "limit")
         {
@@ -362,6 +487,131 @@ public:
             stmt->limitClause = std::make_unique<LimitClause>(std::stoi(limitValue->VALUE));
         }
 
+        match(TokenType::SEMICOLON);
+        return stmt;
+    }
+
+    // column or table.column
+    std::string parseColumnReference()
+    {
+        std::string name = expectIdentifier("Expected column name")->VALUE;
+        if (match(TokenType::DOT))
+        {
+            name += "." + expectIdentifier("Expected column name after '.'")->VALUE;
+        }
+        return name;
+    }
+
+    std::unique_ptr<UpdateStatement> parseUpdateStatement()
+    {
+        expect(TokenType::UPDATE, "Expected UPDATE keyword");
+        auto stmt = std::make_unique<UpdateStatement>();
+        stmt->table = expectIdentifier("Expected table name")->VALUE;
+
+        expect(TokenType::SET, "Expected SET keyword");
+        do
+        {
+            std::string column = expectIdentifier("Expected column name in SET")->VALUE;
+            expect(TokenType::EQUAL, "Expected '=' after column name in SET");
+            stmt->assignments.emplace_back(column, parsePrimary());
+        } while (match(TokenType::COMMA));
+
+        if (match(TokenType::WHERE))
+        {
+            stmt->whereClause = std::make_unique<WhereClause>(parseExpression());
+        }
+
+        expectEnd("UPDATE");
+        return stmt;
+    }
+
+    std::unique_ptr<DeleteStatement> parseDeleteStatement()
+    {
+        expect(TokenType::DELETE, "Expected DELETE keyword");
+        expect(TokenType::FROM, "Expected FROM keyword");
+        auto stmt = std::make_unique<DeleteStatement>();
+        stmt->table = expectIdentifier("Expected table name")->VALUE;
+
+        if (match(TokenType::WHERE))
+        {
+            stmt->whereClause = std::make_unique<WhereClause>(parseExpression());
+        }
+
+        expectEnd("DELETE");
+        return stmt;
+    }
+
+    std::unique_ptr<VacuumStatement> parseVacuumStatement()
+    {
+        expect(TokenType::VACUUM, "Expected VACUUM keyword");
+        auto stmt = std::make_unique<VacuumStatement>();
+        stmt->table = expectIdentifier("Expected table name")->VALUE;
+        match(TokenType::SEMICOLON);
+        return stmt;
+    }
+
+    std::unique_ptr<AlterStatement> parseAlterStatement()
+    {
+        expect(TokenType::ALTER, "Expected ALTER keyword");
+        expect(TokenType::TABLE, "Expected TABLE after ALTER");
+        auto stmt = std::make_unique<AlterStatement>();
+        stmt->table = expectIdentifier("Expected table name")->VALUE;
+        expect(TokenType::ADD, "Expected ADD after table name");
+        // ADD COLUMN x INT, but ADD column INT names the new column "column"
+        if (current() && current()->TYPE == TokenType::COLUMN && isIdentifier(peek(1)))
+            advance();
+        stmt->column = parseColumnDefinition();
+        match(TokenType::SEMICOLON);
+        return stmt;
+    }
+
+    // CREATE INDEX [name] ON table (column, ...) [INCLUDE (column, ...)] [USING BTREE | HASH | ART]
+    std::unique_ptr<CreateIndexStatement> parseCreateIndexStatement()
+    {
+        expect(TokenType::CREATE, "Expected CREATE keyword");
+        expect(TokenType::INDEX, "Expected INDEX after CREATE");
+        auto stmt = std::make_unique<CreateIndexStatement>();
+        if (isIdentifier(peek()))
+            stmt->name = advance()->VALUE;
+        expect(TokenType::ON, "Expected ON after index name");
+        stmt->table = expectIdentifier("Expected table name")->VALUE;
+        expect(TokenType::OPEN_PAREN, "Expected '(' after table name");
+        do
+        {
+            stmt->columns.push_back(expectIdentifier("Expected column name")->VALUE);
+        } while (match(TokenType::COMMA));
+        expect(TokenType::CLOSE_PAREN, "Expected ')' after column list");
+        if (match(TokenType::INCLUDE))
+        {
+            expect(TokenType::OPEN_PAREN, "Expected '(' after INCLUDE");
+            do
+            {
+                stmt->include.push_back(expectIdentifier("Expected column name")->VALUE);
+            } while (match(TokenType::COMMA));
+            expect(TokenType::CLOSE_PAREN, "Expected ')' after INCLUDE column list");
+        }
+        if (match(TokenType::USING))
+        {
+            std::string method = expectIdentifier("Expected index method after USING")->VALUE;
+            std::transform(method.begin(), method.end(), method.begin(), ::tolower);
+            if (method == "hash")
+                stmt->kind = IndexKind::HASH;
+            else if (method == "art")
+                stmt->kind = IndexKind::ART;
+            else if (method != "btree")
+                throw std::runtime_error("Unknown index method '" + method + "', expected BTREE, HASH or ART");
+        }
+        match(TokenType::SEMICOLON);
+        return stmt;
+    }
+
+    std::unique_ptr<AnalyzeStatement> parseAnalyzeStatement()
+    {
+        expect(TokenType::ANALYZE, "Expected ANALYZE keyword");
+        auto stmt = std::make_unique<AnalyzeStatement>();
+        if (isIdentifier(peek()))
+            stmt->table = advance()->VALUE;
+        match(TokenType::SEMICOLON);
         return stmt;
     }
 
@@ -436,13 +686,17 @@ public:
             return std::make_unique<ParenthesizedExpression>(std::move(expr));
         }
 
-        if (match(TokenType::IDENTIFIER))
+        if (matchIdentifier())
         {
             std::string val = previous()->VALUE;
             if (val == "true" || val == "false")
             {
                 return std::make_unique<BoolLiteral>(val == "true");
             }
+            if (match(TokenType::DOT))
+            {
+                val += "." + expectIdentifier("Expected column name after '.'")->VALUE;
+            }
             return std::make_unique<Identifier>(val);
         }
 
@@ -549,9 +803,18 @@ public:
     {
         if (match(TokenType::CREATE))
         {
+            bool createIndex = peek()->TYPE == TokenType::INDEX;
             rewind(); // Go back one token to reprocess CREATE in parseCreateStatement
-            auto stmt = parseCreateStatement();
-            printCreateStatement(*stmt);
+            if (createIndex)
+            {
+                auto stmt = parseCreateIndexStatement();
+                CommandRunner::generateCreateIndexStatement(stmt);
+            }
+            else
+            {
+                auto stmt = parseCreateStatement();
+                printCreateStatement(*stmt);
+            }
         }
         else if (match(TokenType::INSERT))
         {
@@ -562,16 +825,55 @@ public:
                 throw std::runtime_error(check.second);
 
             printInsertStatement(*stmt);
+            CommandRunner::generateInsertStatement(stmt);
         }
         else if (match(TokenType::SELECT))
         {
             rewind();
             auto stmt = parseSelectStatement();
             // printSelectStatement(*stmt);
+            QueryExecutor::Cursor cursor(*stmt);
+            QueryExecutor::printCursor(cursor);
+        }
+        else if (match(TokenType::UPDATE))
+        {
+            rewind();
+            auto stmt = parseUpdateStatement();
+            CommandRunner::generateUpdateStatement(stmt);
+        }
+        else if (match(TokenType::DELETE))
+        {
+            rewind();
+            auto stmt = parseDeleteStatement();
+            CommandRunner::generateDeleteStatement(stmt);
+        }
+        else if (match(TokenType::VACUUM))
+        {
+            rewind();
+            auto stmt = parseVacuumStatement();
+            CommandRunner::generateVacuumStatement(stmt);
+        }
+        else if (match(TokenType::EXPLAIN))
+        {
+            bool analyze = match(TokenType::ANALYZE);
+            auto stmt = parseSelectStatement();
+            QueryExecutor::explainSelect(*stmt, analyze);
+        }
+        else if (match(TokenType::ANALYZE))
+        {
+            rewind();
+            auto stmt = parseAnalyzeStatement();
+            CommandRunner::generateAnalyzeStatement(stmt);
+        }
+        else if (match(TokenType::ALTER))
+        {
+            rewind();
+            auto stmt = parseAlterStatement();
+            CommandRunner::generateAlterStatement(stmt);
         }
         else
         {
-            throw std::runtime_error("Unsupported SQL statement or missing statement type (CREATE, INSERT, SELECT)");
+            throw std::runtime_error("Unsupported SQL statement or missing statement type (CREATE, INSERT, SELECT, UPDATE, DELETE, VACUUM, ANALYZE, EXPLAIN, ALTER)");
         }
     }
 
@@ -594,6 +896,14 @@ public:
         pad();
         std::cout << "  From: " << stmt.table << "\n";
 
+        if (stmt.joinClause)
+        {
+            const JoinClause &join = *stmt.joinClause;
+            pad();
+            std::cout << "  Join: " << join.table << " ON " << join.leftTable << "." << join.leftColumn
+                      << " = " << join.rightTable << "." << join.rightColumn << "\n";
+        }
+
         if (stmt.whereClause)
         {
             pad();
@@ -651,6 +961,8 @@ public:
                     std::cout << "    Constraint: " << constraintStr << "\n";
                 }
             }
+            if (stmt.engine == StorageEngine::COLUMNAR)
+                std::cout << "  Engine: COLUMNAR\n";
         }
     }
 
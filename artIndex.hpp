@@ -0,0 +1,862 @@
+#ifndef __ART_INDEX
+#define __ART_INDEX
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <algorithm>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Keys as byte strings that sort like the keys, none a prefix of another
+template <typename K>
+struct ArtKeyBytes;
+
+template <>
+struct ArtKeyBytes<int>
+{
+    // Big endian with the sign bit flipped, so negative keys sort first
+    static void encode(int key, std::string &out)
+    {
+        uint32_t bits = static_cast<uint32_t>(key) ^ 0x80000000u;
+        out.resize(4);
+        out[0] = static_cast<char>(bits >> 24);
+        out[1] = static_cast<char>(bits >> 16);
+        out[2] = static_cast<char>(bits >> 8);
+        out[3] = static_cast<char>(bits);
+    }
+};
+
+template <>
+struct ArtKeyBytes<std::string>
+{
+    // 0x00 is escaped as 0x00 0xFF and every key ends with 0x00 0x00
+    static void encode(const std::string &key, std::string &out)
+    {
+        out.clear();
+        out.reserve(key.size() + 2);
+        for (char c : key)
+        {
+            out.push_back(c);
+            if (c == 0)
+                out.push_back('\xFF');
+        }
+        out.push_back(0);
+        out.push_back(0);
+    }
+};
+
+// Adaptive radix tree (CREATE INDEX ... USING ART). Inner nodes branch on one
+// key byte and come in four sizes, 4, 16, 48 and 256 children, that grow and
+// shrink with their fan-out. Chains of single-child nodes are collapsed into
+// a prefix on the node below (path compression); up to MAX_PREFIX bytes of it
+// are kept in the node and lookups check only those, the leaf holds the full
+// key. Children are kept in byte order, so an in-order walk yields the keys
+// sorted, which serves range scans like the B+ tree's leaf chain.
+template <typename K, typename V>
+class AdaptiveRadixTree
+{
+public:
+    using key_type = K;
+
+private:
+    static constexpr uint32_t MAX_PREFIX = 10;
+
+    enum NodeType : uint8_t
+    {
+        LEAF,
+        NODE4,
+        NODE16,
+        NODE48,
+        NODE256
+    };
+
+    struct Node
+    {
+        uint8_t type;
+    };
+
+    struct Leaf : Node
+    {
+        K key;
+        V value;
+        Leaf(const K &key, const V &value) : Node{LEAF}, key(key), value(value) {}
+    };
+
+    struct Inner : Node
+    {
+        uint16_t count = 0;
+        uint32_t prefixLen = 0;
+        uint8_t prefix[MAX_PREFIX] = {};
+        explicit Inner(uint8_t type) : Node{type} {}
+    };
+
+    // Node4 and Node16 keep their key bytes sorted
+    struct Node4 : Inner
+    {
+        uint8_t keys[4] = {};
+        Node *children[4] = {};
+        Node4() : Inner(NODE4) {}
+    };
+
+    struct Node16 : Inner
+    {
+        uint8_t keys[16] = {};
+        Node *children[16] = {};
+        Node16() : Inner(NODE16) {}
+    };
+
+    // Key byte -> slot + 1 in children, 0 = no child
+    struct Node48 : Inner
+    {
+        uint8_t index[256] = {};
+        Node *children[48] = {};
+        Node48() : Inner(NODE48) {}
+    };
+
+    struct Node256 : Inner
+    {
+        Node *children[256] = {};
+        Node256() : Inner(NODE256) {}
+    };
+
+    Node *root = nullptr;
+    std::atomic<size_t> count{0};
+    mutable std::shared_mutex mutex;
+
+    static bool isLeaf(const Node *node)
+    {
+        return node->type == LEAF;
+    }
+
+    static void destroy(Node *node)
+    {
+        if (!node)
+            return;
+        switch (node->type)
+        {
+        case LEAF:
+            delete static_cast<Leaf *>(node);
+            return;
+        case NODE4:
+        {
+            auto *n = static_cast<Node4 *>(node);
+            for (int i = 0; i < n->count; ++i)
+                destroy(n->children[i]);
+            delete n;
+            return;
+        }
+        case NODE16:
+        {
+            auto *n = static_cast<Node16 *>(node);
+            for (int i = 0; i < n->count; ++i)
+                destroy(n->children[i]);
+            delete n;
+            return;
+        }
+        case NODE48:
+        {
+            auto *n = static_cast<Node48 *>(node);
+            for (Node *child : n->children)
+                destroy(child);
+            delete n;
+            return;
+        }
+        default:
+        {
+            auto *n = static_cast<Node256 *>(node);
+            for (Node *child : n->children)
+                destroy(child);
+            delete n;
+            return;
+        }
+        }
+    }
+
+    static Node **findChild(Node *node, uint8_t byte)
+    {
+        switch (node->type)
+        {
+        case NODE4:
+        {
+            auto *n = static_cast<Node4 *>(node);
+            for (int i = 0; i < n->count; ++i)
+            {
+                if (n->keys[i] == byte)
+                    return &n->children[i];
+            }
+            return nullptr;
+        }
+        case NODE16:
+        {
+            auto *n = static_cast<Node16 *>(node);
+#ifdef __SSE2__
+            // Compare the byte against all 16 keys at once
+            __m128i matches = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(byte)),
+                                             _mm_loadu_si128(reinterpret_cast<const __m128i *>(n->keys)));
+            int mask = _mm_movemask_epi8(matches) & ((1 << n->count) - 1);
+            return mask ? &n->children[__builtin_ctz(mask)] : nullptr;
+#else
+            for (int i = 0; i < n->count; ++i)
+            {
+                if (n->keys[i] == byte)
+                    return &n->children[i];
+            }
+            return nullptr;
+#endif
+        }
+        case NODE48:
+        {
+            auto *n = static_cast<Node48 *>(node);
+            return n->index[byte] ? &n->children[n->index[byte] - 1] : nullptr;
+        }
+        default:
+        {
+            auto *n = static_cast<Node256 *>(node);
+            return n->children[byte] ? &n->children[byte] : nullptr;
+        }
+        }
+    }
+
+    // Child in the first occupied slot >= pos, pos is moved to that slot.
+    // Slots are array positions in Node4/16 and key bytes in Node48/256.
+    static const Node *childFrom(const Inner *node, int &pos)
+    {
+        switch (node->type)
+        {
+        case NODE4:
+        {
+            auto *n = static_cast<const Node4 *>(node);
+            return pos < n->count ? n->children[pos] : nullptr;
+        }
+        case NODE16:
+        {
+            auto *n = static_cast<const Node16 *>(node);
+            return pos < n->count ? n->children[pos] : nullptr;
+        }
+        case NODE48:
+        {
+            auto *n = static_cast<const Node48 *>(node);
+            for (; pos < 256; ++pos)
+            {
+                if (n->index[pos])
+                    return n->children[n->index[pos] - 1];
+            }
+            return nullptr;
+        }
+        default:
+        {
+            auto *n = static_cast<const Node256 *>(node);
+            for (; pos < 256; ++pos)
+            {
+                if (n->children[pos])
+                    return n->children[pos];
+            }
+            return nullptr;
+        }
+        }
+    }
+
+    // First slot whose key byte is >= byte, as a childFrom position
+    static int slotFrom(const Inner *node, uint8_t byte)
+    {
+        const uint8_t *keys;
+        if (node->type == NODE4)
+            keys = static_cast<const Node4 *>(node)->keys;
+        else if (node->type == NODE16)
+            keys = static_cast<const Node16 *>(node)->keys;
+        else
+            return byte;
+        int pos = 0;
+        while (pos < node->count && keys[pos] < byte)
+            pos++;
+        return pos;
+    }
+
+    static uint8_t slotByte(const Inner *node, int pos)
+    {
+        if (node->type == NODE4)
+            return static_cast<const Node4 *>(node)->keys[pos];
+        if (node->type == NODE16)
+            return static_cast<const Node16 *>(node)->keys[pos];
+        return static_cast<uint8_t>(pos);
+    }
+
+    static const Leaf *minimumLeaf(const Node *node)
+    {
+        while (!isLeaf(node))
+        {
+            int pos = 0;
+            node = childFrom(static_cast<const Inner *>(node), pos);
+        }
+        return static_cast<const Leaf *>(node);
+    }
+
+    static void copyHeader(Inner *to, const Inner *from)
+    {
+        to->count = from->count;
+        to->prefixLen = from->prefixLen;
+        std::memcpy(to->prefix, from->prefix, std::min(from->prefixLen, MAX_PREFIX));
+    }
+
+    // Stored prefix bytes that match the key, lookups trust the rest to the leaf
+    static uint32_t checkPrefix(const Inner *node, const std::string &bytes, size_t depth)
+    {
+        uint32_t limit = static_cast<uint32_t>(std::min<size_t>(std::min(node->prefixLen, MAX_PREFIX), bytes.size() - depth));
+        uint32_t i = 0;
+        while (i < limit && node->prefix[i] == static_cast<uint8_t>(bytes[depth + i]))
+            i++;
+        return i;
+    }
+
+    // Length of the full prefix that matches the key, reading a leaf past MAX_PREFIX
+    static uint32_t prefixMismatch(const Inner *node, const std::string &bytes, size_t depth)
+    {
+        uint32_t i = checkPrefix(node, bytes, depth);
+        if (i < MAX_PREFIX || node->prefixLen <= MAX_PREFIX)
+            return i;
+        std::string leafBytes;
+        ArtKeyBytes<K>::encode(minimumLeaf(node)->key, leafBytes);
+        size_t limit = std::min(leafBytes.size(), bytes.size()) - depth;
+        while (i < limit && i < node->prefixLen && leafBytes[depth + i] == bytes[depth + i])
+            i++;
+        return i;
+    }
+
+    static uint8_t prefixByte(const Inner *node, size_t depth, uint32_t i)
+    {
+        if (i < MAX_PREFIX)
+            return node->prefix[i];
+        std::string leafBytes;
+        ArtKeyBytes<K>::encode(minimumLeaf(node)->key, leafBytes);
+        return static_cast<uint8_t>(leafBytes[depth + i]);
+    }
+
+    // Insert into a sorted key array of a Node4 or Node16 with room left
+    template <typename N>
+    static void insertSorted(N *n, uint8_t byte, Node *child)
+    {
+        int pos = 0;
+        while (pos < n->count && n->keys[pos] < byte)
+            pos++;
+        std::memmove(n->keys + pos + 1, n->keys + pos, n->count - pos);
+        std::memmove(n->children + pos + 1, n->children + pos, (n->count - pos) * sizeof(Node *));
+        n->keys[pos] = byte;
+        n->children[pos] = child;
+        n->count++;
+    }
+
+    // Add a child, replacing ref with the next larger node type when full
+    static void addChild(Node *&ref, uint8_t byte, Node *child)
+    {
+        switch (ref->type)
+        {
+        case NODE4:
+        {
+            auto *n = static_cast<Node4 *>(ref);
+            if (n->count < 4)
+            {
+                insertSorted(n, byte, child);
+                return;
+            }
+            auto *grown = new Node16();
+            copyHeader(grown, n);
+            std::memcpy(grown->keys, n->keys, n->count);
+            std::memcpy(grown->children, n->children, n->count * sizeof(Node *));
+            delete n;
+            ref = grown;
+            insertSorted(grown, byte, child);
+            return;
+        }
+        case NODE16:
+        {
+            auto *n = static_cast<Node16 *>(ref);
+            if (n->count < 16)
+            {
+                insertSorted(n, byte, child);
+                return;
+            }
+            auto *grown = new Node48();
+            copyHeader(grown, n);
+            for (int i = 0; i < n->count; ++i)
+            {
+                grown->children[i] = n->children[i];
+                grown->index[n->keys[i]] = static_cast<uint8_t>(i + 1);
+            }
+            delete n;
+            ref = grown;
+            addChild(ref, byte, child);
+            return;
+        }
+        case NODE48:
+        {
+            auto *n = static_cast<Node48 *>(ref);
+            if (n->count < 48)
+            {
+                int slot = 0;
+                while (n->children[slot])
+                    slot++;
+                n->children[slot] = child;
+                n->index[byte] = static_cast<uint8_t>(slot + 1);
+                n->count++;
+                return;
+            }
+            auto *grown = new Node256();
+            copyHeader(grown, n);
+            for (int i = 0; i < 256; ++i)
+            {
+                if (n->index[i])
+                    grown->children[i] = n->children[n->index[i] - 1];
+            }
+            delete n;
+            ref = grown;
+            addChild(ref, byte, child);
+            return;
+        }
+        default:
+        {
+            auto *n = static_cast<Node256 *>(ref);
+            n->children[byte] = child;
+            n->count++;
+            return;
+        }
+        }
+    }
+
+    // Remove the child in slot, replacing ref with the next smaller node type
+    // when sparse enough. A Node4 left with one child is merged into it.
+    static void removeChild(Node *&ref, uint8_t byte, Node **slot)
+    {
+        switch (ref->type)
+        {
+        case NODE4:
+        {
+            auto *n = static_cast<Node4 *>(ref);
+            int pos = static_cast<int>(slot - n->children);
+            std::memmove(n->keys + pos, n->keys + pos + 1, n->count - pos - 1);
+            std::memmove(n->children + pos, n->children + pos + 1, (n->count - pos - 1) * sizeof(Node *));
+            n->count--;
+            if (n->count != 1)
+                return;
+
+            Node *child = n->children[0];
+            if (!isLeaf(child))
+            {
+                // The child's prefix becomes this prefix + the branch byte + its own prefix
+                auto *inner = static_cast<Inner *>(child);
+                uint32_t len = n->prefixLen;
+                if (len < MAX_PREFIX)
+                    n->prefix[len++] = n->keys[0];
+                if (len < MAX_PREFIX)
+                {
+                    uint32_t take = std::min(inner->prefixLen, MAX_PREFIX - len);
+                    std::memcpy(n->prefix + len, inner->prefix, take);
+                    len += take;
+                }
+                std::memcpy(inner->prefix, n->prefix, std::min(len, MAX_PREFIX));
+                inner->prefixLen += n->prefixLen + 1;
+            }
+            ref = child;
+            delete n;
+            return;
+        }
+        case NODE16:
+        {
+            auto *n = static_cast<Node16 *>(ref);
+            int pos = static_cast<int>(slot - n->children);
+            std::memmove(n->keys + pos, n->keys + pos + 1, n->count - pos - 1);
+            std::memmove(n->children + pos, n->children + pos + 1, (n->count - pos - 1) * sizeof(Node *));
+            n->count--;
+            if (n->count != 3)
+                return;
+            auto *shrunk = new Node4();
+            copyHeader(shrunk, n);
+            std::memcpy(shrunk->keys, n->keys, 3);
+            std::memcpy(shrunk->children, n->children, 3 * sizeof(Node *));
+            delete n;
+            ref = shrunk;
+            return;
+        }
+        case NODE48:
+        {
+            auto *n = static_cast<Node48 *>(ref);
+            n->children[n->index[byte] - 1] = nullptr;
+            n->index[byte] = 0;
+            n->count--;
+            if (n->count != 12)
+                return;
+            auto *shrunk = new Node16();
+            copyHeader(shrunk, n);
+            int pos = 0;
+            for (int i = 0; i < 256; ++i)
+            {
+                if (n->index[i])
+                {
+                    shrunk->keys[pos] = static_cast<uint8_t>(i);
+                    shrunk->children[pos++] = n->children[n->index[i] - 1];
+                }
+            }
+            delete n;
+            ref = shrunk;
+            return;
+        }
+        default:
+        {
+            auto *n = static_cast<Node256 *>(ref);
+            n->children[byte] = nullptr;
+            n->count--;
+            if (n->count != 37)
+                return;
+            auto *shrunk = new Node48();
+            copyHeader(shrunk, n);
+            int pos = 0;
+            for (int i = 0; i < 256; ++i)
+            {
+                if (n->children[i])
+                {
+                    shrunk->children[pos] = n->children[i];
+                    shrunk->index[i] = static_cast<uint8_t>(++pos);
+                }
+            }
+            delete n;
+            ref = shrunk;
+            return;
+        }
+        }
+    }
+
+    // True if the key was added, false if it was present (then replaced when
+    // `replace`, else its value goes to `existing`)
+    bool insertAt(Node *&ref, const K &key, const std::string &bytes, size_t depth, const V &value,
+                  bool replace, V *existing)
+    {
+        if (!ref)
+        {
+            ref = new Leaf(key, value);
+            return true;
+        }
+
+        if (isLeaf(ref))
+        {
+            auto *leaf = static_cast<Leaf *>(ref);
+            if (leaf->key == key)
+            {
+                if (replace)
+                    leaf->value = value;
+                else if (existing)
+                    *existing = leaf->value;
+                return false;
+            }
+            // Two keys under one byte: a Node4 holding the bytes they share as its prefix
+            std::string leafBytes;
+            ArtKeyBytes<K>::encode(leaf->key, leafBytes);
+            size_t shared = 0;
+            while (leafBytes[depth + shared] == bytes[depth + shared])
+                shared++;
+            auto *split = new Node4();
+            split->prefixLen = static_cast<uint32_t>(shared);
+            std::memcpy(split->prefix, bytes.data() + depth, std::min<size_t>(shared, MAX_PREFIX));
+            Node *splitRef = split;
+            addChild(splitRef, static_cast<uint8_t>(leafBytes[depth + shared]), leaf);
+            addChild(splitRef, static_cast<uint8_t>(bytes[depth + shared]), new Leaf(key, value));
+            ref = splitRef;
+            return true;
+        }
+
+        auto *node = static_cast<Inner *>(ref);
+        if (node->prefixLen)
+        {
+            uint32_t match = prefixMismatch(node, bytes, depth);
+            if (match < node->prefixLen)
+            {
+                // The key leaves the prefix early: a Node4 above the node takes
+                // the matching part, the node keeps what follows the branch byte
+                auto *split = new Node4();
+                split->prefixLen = match;
+                std::memcpy(split->prefix, node->prefix, std::min(match, MAX_PREFIX));
+                Node *splitRef = split;
+                if (node->prefixLen <= MAX_PREFIX)
+                {
+                    addChild(splitRef, node->prefix[match], node);
+                    node->prefixLen -= match + 1;
+                    std::memmove(node->prefix, node->prefix + match + 1, std::min(node->prefixLen, MAX_PREFIX));
+                }
+                else
+                {
+                    std::string leafBytes;
+                    ArtKeyBytes<K>::encode(minimumLeaf(node)->key, leafBytes);
+                    addChild(splitRef, static_cast<uint8_t>(leafBytes[depth + match]), node);
+                    node->prefixLen -= match + 1;
+                    std::memcpy(node->prefix, leafBytes.data() + depth + match + 1, std::min(node->prefixLen, MAX_PREFIX));
+                }
+                addChild(splitRef, static_cast<uint8_t>(bytes[depth + match]), new Leaf(key, value));
+                ref = splitRef;
+                return true;
+            }
+            depth += node->prefixLen;
+        }
+
+        uint8_t byte = static_cast<uint8_t>(bytes[depth]);
+        if (Node **child = findChild(node, byte))
+            return insertAt(*child, key, bytes, depth + 1, value, replace, existing);
+        addChild(ref, byte, new Leaf(key, value));
+        return true;
+    }
+
+    bool removeAt(Node *&ref, const K &key, const std::string &bytes, size_t depth)
+    {
+        if (!ref)
+            return false;
+        if (isLeaf(ref))
+        {
+            // Only the root is reached as a leaf, deeper leaves are removed by their parent
+            auto *leaf = static_cast<Leaf *>(ref);
+            if (!(leaf->key == key))
+                return false;
+            delete leaf;
+            ref = nullptr;
+            return true;
+        }
+
+        auto *node = static_cast<Inner *>(ref);
+        if (node->prefixLen)
+        {
+            if (checkPrefix(node, bytes, depth) != std::min(node->prefixLen, MAX_PREFIX))
+                return false;
+            depth += node->prefixLen;
+        }
+        if (depth >= bytes.size())
+            return false;
+        uint8_t byte = static_cast<uint8_t>(bytes[depth]);
+        Node **child = findChild(node, byte);
+        if (!child)
+            return false;
+        if (!isLeaf(*child))
+            return removeAt(*child, key, bytes, depth + 1);
+
+        auto *leaf = static_cast<Leaf *>(*child);
+        if (!(leaf->key == key))
+            return false;
+        removeChild(ref, byte, child);
+        delete leaf;
+        return true;
+    }
+
+public:
+    // In-order cursor, holds the tree's shared lock while it lives
+    class LeafIterator
+    {
+    private:
+        friend class AdaptiveRadixTree;
+
+        struct Frame
+        {
+            const Inner *node;
+            int next; // slot to continue from
+        };
+
+        std::shared_lock<std::shared_mutex> lock;
+        std::vector<Frame> stack;
+        const Leaf *leaf = nullptr;
+
+        explicit LeafIterator(std::shared_mutex &mutex) : lock(mutex) {}
+
+        void descendMin(const Node *node)
+        {
+            while (!isLeaf(node))
+            {
+                const auto *inner = static_cast<const Inner *>(node);
+                int pos = 0;
+                node = childFrom(inner, pos);
+                stack.push_back(Frame{inner, pos + 1});
+            }
+            leaf = static_cast<const Leaf *>(node);
+        }
+
+        void advance()
+        {
+            leaf = nullptr;
+            while (!stack.empty())
+            {
+                Frame &frame = stack.back();
+                int pos = frame.next;
+                if (const Node *child = childFrom(frame.node, pos))
+                {
+                    frame.next = pos + 1;
+                    descendMin(child);
+                    return;
+                }
+                stack.pop_back();
+            }
+        }
+
+        // Position at the first key >= key. A subtree whose prefix sorts
+        // before the key is skipped whole, one that sorts after starts at its minimum.
+        void seek(const Node *node, const K &key, const std::string &bytes)
+        {
+            size_t depth = 0;
+            while (node)
+            {
+                if (isLeaf(node))
+                {
+                    const auto *found = static_cast<const Leaf *>(node);
+                    if (found->key < key)
+                        advance();
+                    else
+                        leaf = found;
+                    return;
+                }
+
+                const auto *inner = static_cast<const Inner *>(node);
+                uint32_t match = prefixMismatch(inner, bytes, depth);
+                if (match < inner->prefixLen)
+                {
+                    if (depth + match >= bytes.size() || prefixByte(inner, depth, match) > static_cast<uint8_t>(bytes[depth + match]))
+                        descendMin(inner);
+                    else
+                        advance();
+                    return;
+                }
+                depth += inner->prefixLen;
+                if (depth >= bytes.size())
+                {
+                    descendMin(inner);
+                    return;
+                }
+
+                uint8_t byte = static_cast<uint8_t>(bytes[depth]);
+                int pos = slotFrom(inner, byte);
+                const Node *child = childFrom(inner, pos);
+                if (!child)
+                {
+                    advance();
+                    return;
+                }
+                stack.push_back(Frame{inner, pos + 1});
+                if (slotByte(inner, pos) != byte)
+                {
+                    descendMin(child);
+                    return;
+                }
+                node = child;
+                depth++;
+            }
+        }
+
+    public:
+        bool valid() const { return leaf != nullptr; }
+        const K &key() const { return leaf->key; }
+        const V &value() const { return leaf->value; }
+
+        void next()
+        {
+            if (leaf)
+                advance();
+        }
+    };
+
+    AdaptiveRadixTree() = default;
+    AdaptiveRadixTree(const AdaptiveRadixTree &) = delete;
+    AdaptiveRadixTree &operator=(const AdaptiveRadixTree &) = delete;
+
+    ~AdaptiveRadixTree()
+    {
+        destroy(root);
+    }
+
+    void insert(const K &key, const V &value)
+    {
+        std::string bytes;
+        ArtKeyBytes<K>::encode(key, bytes);
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        if (insertAt(root, key, bytes, 0, value, true, nullptr))
+            count++;
+    }
+
+    // Insert unless the key is present, false if it was (its value goes to `existing`)
+    bool insert_if_absent(const K &key, const V &value, V *existing = nullptr)
+    {
+        std::string bytes;
+        ArtKeyBytes<K>::encode(key, bytes);
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        if (!insertAt(root, key, bytes, 0, value, false, existing))
+            return false;
+        count++;
+        return true;
+    }
+
+    bool search(const K &key, V &value) const
+    {
+        std::string bytes;
+        ArtKeyBytes<K>::encode(key, bytes);
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        const Node *node = root;
+        size_t depth = 0;
+        while (node)
+        {
+            if (isLeaf(node))
+            {
+                const auto *leaf = static_cast<const Leaf *>(node);
+                if (!(leaf->key == key))
+                    return false;
+                value = leaf->value;
+                return true;
+            }
+            const auto *inner = static_cast<const Inner *>(node);
+            if (inner->prefixLen)
+            {
+                if (checkPrefix(inner, bytes, depth) != std::min(inner->prefixLen, MAX_PREFIX))
+                    return false;
+                depth += inner->prefixLen;
+            }
+            if (depth >= bytes.size())
+                return false;
+            Node *const *child = findChild(const_cast<Node *>(node), static_cast<uint8_t>(bytes[depth]));
+            node = child ? *child : nullptr;
+            depth++;
+        }
+        return false;
+    }
+
+    bool remove(const K &key)
+    {
+        std::string bytes;
+        ArtKeyBytes<K>::encode(key, bytes);
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        if (!removeAt(root, key, bytes, 0))
+            return false;
+        count--;
+        return true;
+    }
+
+    size_t size() const
+    {
+        return count.load();
+    }
+
+    // Iterator positioned at the smallest key in the tree
+    LeafIterator begin()
+    {
+        LeafIterator it(mutex);
+        if (root)
+            it.descendMin(root);
+        return it;
+    }
+
+    // Iterator positioned at the first key that is not less than `key`
+    LeafIterator lower_bound(const K &key)
+    {
+        std::string bytes;
+        ArtKeyBytes<K>::encode(key, bytes);
+        LeafIterator it(mutex);
+        it.seek(root, key, bytes);
+        return it;
+    }
+};
+
+#endif // __ART_INDEX
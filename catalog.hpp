@@ -0,0 +1,464 @@
+#ifndef __CATALOG
+#define __CATALOG
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <unordered_map>
+#include <algorithm>
+#include "global.hpp"
+#include "rowStorage.hpp"
+#include "compositeIndex.hpp"
+
+// Databases, tables, their columns and indexes. Names are interned into
+// dense integer ids when an object is created; ids are never reused, so a
+// handle resolves to its entry with one vector index.
+//
+// Readers take the current Snapshot with a single atomic load and never
+// lock. DDL copies the snapshot (entries are shared, only the id vectors
+// and name maps are copied), edits the copy and publishes it. Readers still
+// holding the old snapshot finish on it and the last one frees it (RCU style).
+namespace Catalog
+{
+    using DatabaseId = uint32_t;
+    using TableId = uint32_t;
+    using ColumnId = uint32_t; // position of the column in its table
+    constexpr uint32_t INVALID_ID = UINT32_MAX;
+
+    // Immutable once published. The storage handle is opened on first use and
+    // shared with the entries that later replace this one (ALTER TABLE).
+    struct TableEntry
+    {
+        TableId id = INVALID_ID;
+        DatabaseId database = INVALID_ID;
+        std::string databaseName;
+        std::string name;
+        StorageEngine engine = StorageEngine::ROW;
+        std::vector<std::shared_ptr<TableGlobalColumnNode>> columns;
+        std::unordered_map<std::string, ColumnId> columnIds;
+        std::unordered_map<std::string, TreeVariant> indexes; // column name -> index
+        std::vector<const TreeVariant *> indexByColumn;       // ColumnId -> index or nullptr
+        std::vector<CompositeIndex> compositeIndexes;         // indexes over several columns
+
+        TableEntry() = default;
+        TableEntry(const TableEntry &) = delete;
+        TableEntry &operator=(const TableEntry &) = delete;
+
+        ColumnId column(const std::string &columnName) const
+        {
+            auto it = columnIds.find(columnName);
+            return it == columnIds.end() ? INVALID_ID : it->second;
+        }
+
+        // nullptr when the column is not indexed
+        const TreeVariant *index(ColumnId column) const
+        {
+            return column < indexByColumn.size() ? indexByColumn[column] : nullptr;
+        }
+
+        const TreeVariant *index(const std::string &columnName) const
+        {
+            return index(column(columnName));
+        }
+
+        const CompositeIndex *compositeIndex(const std::string &indexName) const
+        {
+            for (const auto &index : compositeIndexes)
+            {
+                if (index.definition.name == indexName)
+                    return &index;
+            }
+            return nullptr;
+        }
+
+        std::shared_ptr<TableStorage> storage() const
+        {
+            std::call_once(slot->once, [this]
+                           { slot->storage = std::make_shared<TableStorage>(databaseName, name,
+                                                                           tableDirectory + "/" + databaseName + "/" + name, columns,
+                                                                           engine);
+                             slot->opened.store(true); });
+            return slot->storage;
+        }
+
+        // Storage if a statement already opened it, without opening it
+        std::shared_ptr<TableStorage> openStorage() const
+        {
+            return slot->opened.load() ? slot->storage : nullptr;
+        }
+
+        void shareStorage(const TableEntry &previous)
+        {
+            slot = previous.slot;
+        }
+
+    private:
+        struct StorageSlot
+        {
+            std::once_flag once;
+            std::shared_ptr<TableStorage> storage;
+            std::atomic<bool> opened{false};
+        };
+        std::shared_ptr<StorageSlot> slot = std::make_shared<StorageSlot>();
+    };
+
+    struct DatabaseEntry
+    {
+        DatabaseId id = INVALID_ID;
+        std::string name;
+        std::unordered_map<std::string, TableId> tables;
+    };
+
+    struct Snapshot
+    {
+        uint64_t version = 0;
+        std::vector<std::shared_ptr<const DatabaseEntry>> databases; // by DatabaseId
+        std::vector<std::shared_ptr<const TableEntry>> tables;       // by TableId
+        std::unordered_map<std::string, DatabaseId> databaseIds;
+
+        const DatabaseEntry *database(const std::string &dbName) const
+        {
+            auto it = databaseIds.find(dbName);
+            return it == databaseIds.end() ? nullptr : databases[it->second].get();
+        }
+
+        std::shared_ptr<const TableEntry> table(TableId id) const
+        {
+            return id < tables.size() ? tables[id] : nullptr;
+        }
+
+        std::shared_ptr<const TableEntry> table(const std::string &dbName, const std::string &tableName) const
+        {
+            const DatabaseEntry *db = database(dbName);
+            if (!db)
+                return nullptr;
+            auto it = db->tables.find(tableName);
+            return it == db->tables.end() ? nullptr : tables[it->second];
+        }
+    };
+
+    inline std::shared_ptr<const Snapshot> published = std::make_shared<const Snapshot>();
+    inline std::mutex ddlMutex; // serializes writers only
+
+    inline std::shared_ptr<const Snapshot> current()
+    {
+        return std::atomic_load(&published);
+    }
+
+    // Copy, edit under the writer lock, publish
+    template <typename Edit>
+    inline void update(Edit edit)
+    {
+        std::lock_guard<std::mutex> lock(ddlMutex);
+        auto next = std::make_shared<Snapshot>(*current());
+        next->version++;
+        edit(*next);
+        std::atomic_store(&published, std::shared_ptr<const Snapshot>(std::move(next)));
+    }
+
+    inline DatabaseId internDatabase(Snapshot &snapshot, const std::string &dbName)
+    {
+        auto it = snapshot.databaseIds.find(dbName);
+        if (it != snapshot.databaseIds.end())
+            return it->second;
+        auto db = std::make_shared<DatabaseEntry>();
+        db->id = static_cast<DatabaseId>(snapshot.databases.size());
+        db->name = dbName;
+        snapshot.databases.push_back(db);
+        snapshot.databaseIds[dbName] = db->id;
+        return db->id;
+    }
+
+    // Registers the database if it is new
+    inline DatabaseId addDatabase(const std::string &dbName)
+    {
+        DatabaseId id = INVALID_ID;
+        update([&](Snapshot &snapshot)
+               { id = internDatabase(snapshot, dbName); });
+        return id;
+    }
+
+    inline void linkIndexes(TableEntry &entry)
+    {
+        entry.indexByColumn.assign(entry.columns.size(), nullptr);
+        for (const auto &index : entry.indexes)
+            entry.indexByColumn[entry.columnIds[index.first]] = &index.second;
+    }
+
+    // An empty index for a definition, false when its columns or kind cannot be indexed
+    inline bool makeCompositeIndex(const TableEntry &entry, const IndexDefinition &definition, CompositeIndex &index)
+    {
+        index.definition = definition;
+        index.columns.clear();
+        index.included.clear();
+        for (const auto &columnName : definition.columns)
+        {
+            ColumnId position = entry.column(columnName);
+            if (position == INVALID_ID)
+                return false;
+            index.columns.push_back(position);
+        }
+        for (const auto &columnName : definition.include)
+        {
+            ColumnId position = entry.column(columnName);
+            if (position == INVALID_ID)
+                return false;
+            index.included.push_back(position);
+        }
+        return makeCompositeTree(definition.kind, index.tree);
+    }
+
+    // An unpublished entry with empty indexes on its primary and unique
+    // columns and for every composite index definition. Every UNIQUE constraint is
+    // enforced through its index.
+    inline std::shared_ptr<TableEntry> makeTableEntry(const std::string &dbName, const std::string &tableName,
+                                                      std::vector<std::shared_ptr<TableGlobalColumnNode>> columns,
+                                                      StorageEngine engine = StorageEngine::ROW,
+                                                      const std::vector<IndexDefinition> &definitions = {})
+    {
+        auto entry = std::make_shared<TableEntry>();
+        entry->databaseName = dbName;
+        entry->name = tableName;
+        entry->engine = engine;
+        entry->columns = std::move(columns);
+        for (size_t i = 0; i < entry->columns.size(); ++i)
+        {
+            const auto &column = entry->columns[i];
+            entry->columnIds[column->name] = static_cast<ColumnId>(i);
+            if (!column->isPrimary && !column->isUnique)
+                continue;
+            TreeVariant tree;
+            if (!makeIndexTree(column->type, tree, column->indexKind))
+            {
+                std::cerr << "Unsupported index key type: " << column->type << " for column: " << column->name << std::endl;
+                continue;
+            }
+            entry->indexes[column->name] = std::move(tree);
+        }
+        linkIndexes(*entry);
+        for (const auto &definition : definitions)
+        {
+            CompositeIndex index;
+            if (!makeCompositeIndex(*entry, definition, index))
+            {
+                std::cerr << "Skipping index '" << definition.name << "' of table " << tableName << std::endl;
+                continue;
+            }
+            entry->compositeIndexes.push_back(std::move(index));
+        }
+        return entry;
+    }
+
+    // Publishes several tables of one database with a single snapshot swap,
+    // so loading thousands of tables does not copy the snapshot per table
+    inline void addTables(const std::string &dbName, const std::vector<std::shared_ptr<TableEntry>> &entries)
+    {
+        update([&](Snapshot &snapshot)
+               {
+                   DatabaseId dbId = internDatabase(snapshot, dbName);
+                   auto db = std::make_shared<DatabaseEntry>(*snapshot.databases[dbId]);
+                   for (const auto &entry : entries)
+                   {
+                       if (db->tables.count(entry->name))
+                       {
+                           throw std::runtime_error("❌ Table '" + entry->name + "' already exists in DB '" + dbName + "'");
+                       }
+                       entry->id = static_cast<TableId>(snapshot.tables.size());
+                       entry->database = dbId;
+                       snapshot.tables.push_back(entry);
+                       db->tables[entry->name] = entry->id;
+                   }
+                   snapshot.databases[dbId] = db; });
+    }
+
+    inline std::shared_ptr<const TableEntry> addTable(const std::string &dbName, const std::string &tableName,
+                                                      std::vector<std::shared_ptr<TableGlobalColumnNode>> columns,
+                                                      StorageEngine engine = StorageEngine::ROW)
+    {
+        auto entry = makeTableEntry(dbName, tableName, std::move(columns), engine);
+        addTables(dbName, {entry});
+        return entry;
+    }
+
+    // Unpublished copy of an entry for DDL to edit. Indexes and the storage handle are shared.
+    inline std::shared_ptr<TableEntry> replacementEntry(const TableEntry &previous)
+    {
+        auto entry = std::make_shared<TableEntry>();
+        entry->id = previous.id;
+        entry->database = previous.database;
+        entry->databaseName = previous.databaseName;
+        entry->name = previous.name;
+        entry->engine = previous.engine;
+        entry->columns = previous.columns;
+        entry->columnIds = previous.columnIds;
+        entry->indexes = previous.indexes;
+        entry->compositeIndexes = previous.compositeIndexes;
+        entry->shareStorage(previous);
+        return entry;
+    }
+
+    // ALTER TABLE ADD COLUMN: a new entry with the column appended replaces
+    // the old one under the same id
+    inline std::shared_ptr<const TableEntry> addColumn(const std::shared_ptr<const TableEntry> &previous,
+                                                       const std::shared_ptr<TableGlobalColumnNode> &column)
+    {
+        auto entry = replacementEntry(*previous);
+        entry->columns.push_back(column);
+        entry->columnIds[column->name] = static_cast<ColumnId>(entry->columns.size() - 1);
+        linkIndexes(*entry);
+
+        // Open the storage with the old schema first, so no reader of the old
+        // entry can open it later, then switch it to the new one. Statements
+        // are held off until the new entry is published.
+        auto storage = previous->storage();
+        auto exclusive = storage->exclusiveStatementLock();
+        storage->addColumn(column);
+
+        update([&](Snapshot &snapshot)
+               { snapshot.tables[entry->id] = entry; });
+        return entry;
+    }
+
+    // CREATE INDEX: a new entry whose column carries the new index flags
+    // replaces the old one under the same id. The column gets a fresh index of
+    // its kind, filled from storage while statements are held off; the other
+    // indexes and the storage handle are shared.
+    inline std::shared_ptr<const TableEntry> createIndex(const std::shared_ptr<const TableEntry> &previous,
+                                                         const std::shared_ptr<TableGlobalColumnNode> &column)
+    {
+        ColumnId position = previous->column(column->name);
+        TreeVariant tree;
+        if (position == INVALID_ID || !makeIndexTree(column->type, tree, column->indexKind))
+        {
+            throw std::runtime_error("❌ Column '" + column->name + "' of type " + column->type + " cannot be indexed");
+        }
+
+        auto entry = replacementEntry(*previous);
+        entry->columns[position] = column;
+        entry->indexes[column->name] = tree;
+        linkIndexes(*entry);
+
+        auto storage = previous->storage();
+        auto exclusive = storage->exclusiveStatementLock();
+        storage->replaceColumn(static_cast<int>(position), column);
+        storage->scan([&](int64_t, const IndexNode &location, const Row &row)
+                      {
+                          indexInsert(tree, row[position], location);
+                          return true; });
+
+        update([&](Snapshot &snapshot)
+               { snapshot.tables[entry->id] = entry; });
+        return entry;
+    }
+
+    // CREATE INDEX over several columns: the same replacement, with one more
+    // composite index filled from storage while statements are held off
+    inline std::shared_ptr<const TableEntry> addCompositeIndex(const std::shared_ptr<const TableEntry> &previous,
+                                                               const IndexDefinition &definition)
+    {
+        auto entry = replacementEntry(*previous);
+        linkIndexes(*entry);
+        CompositeIndex index;
+        if (!makeCompositeIndex(*entry, definition, index))
+        {
+            throw std::runtime_error("❌ Index '" + definition.name + "' needs existing columns and USING BTREE or ART");
+        }
+
+        auto storage = previous->storage();
+        auto exclusive = storage->exclusiveStatementLock();
+        storage->scan([&index](int64_t, const IndexNode &location, const Row &row)
+                      {
+                          compositeInsert(index, row, location);
+                          return true; });
+        entry->compositeIndexes.push_back(std::move(index));
+
+        update([&](Snapshot &snapshot)
+               { snapshot.tables[entry->id] = entry; });
+        return entry;
+    }
+
+    inline std::shared_ptr<const TableEntry> findTable(const std::string &dbName, const std::string &tableName)
+    {
+        return current()->table(dbName, tableName);
+    }
+
+    inline std::shared_ptr<const TableEntry> requireTable(const std::string &dbName, const std::string &tableName)
+    {
+        auto entry = findTable(dbName, tableName);
+        if (!entry)
+        {
+            throw std::runtime_error("Table '" + tableName + "' does not exist in DB '" + dbName + "'");
+        }
+        return entry;
+    }
+
+    // A table's entry with its statement lock held. DDL publishes the entry
+    // that replaces it under the exclusive lock, so the entry read after the
+    // shared lock is taken stays current, indexes included, until it is released.
+    struct LockedTable
+    {
+        std::shared_ptr<const TableEntry> entry;
+        std::shared_lock<std::shared_mutex> statement;
+    };
+
+    inline LockedTable lockTable(const std::string &dbName, const std::string &tableName)
+    {
+        LockedTable locked;
+        locked.statement = requireTable(dbName, tableName)->storage()->statementLock();
+        locked.entry = requireTable(dbName, tableName);
+        return locked;
+    }
+
+    // Every table of a database, in creation order
+    inline std::vector<std::shared_ptr<const TableEntry>> tablesOf(const std::string &dbName)
+    {
+        auto snapshot = current();
+        std::vector<std::shared_ptr<const TableEntry>> tables;
+        const DatabaseEntry *db = snapshot->database(dbName);
+        if (!db)
+            return tables;
+        std::vector<TableId> ids;
+        for (const auto &table : db->tables)
+            ids.push_back(table.second);
+        std::sort(ids.begin(), ids.end());
+        for (TableId id : ids)
+            tables.push_back(snapshot->tables[id]);
+        return tables;
+    }
+};
+
+inline std::shared_ptr<TableStorage> getTableStorage(const std::string &dbName, const std::string &tableName)
+{
+    return Catalog::requireTable(dbName, tableName)->storage();
+}
+
+// Indexes only live in memory, refill them from the table's data file
+inline void rebuildTableIndexes(const Catalog::TableEntry &table)
+{
+    if (table.indexes.empty() && table.compositeIndexes.empty())
+        return;
+
+    auto storage = table.storage();
+    std::vector<std::pair<int, const TreeVariant *>> indexes;
+    for (const auto &entry : table.indexes)
+        indexes.emplace_back(static_cast<int>(table.column(entry.first)), &entry.second);
+
+    storage->scan([&indexes, &table](int64_t, const IndexNode &location, const Row &row)
+                  {
+                      for (const auto &index : indexes)
+                      {
+                          indexInsert(*index.second, row[index.first], location);
+                      }
+                      for (const auto &index : table.compositeIndexes)
+                      {
+                          compositeInsert(index, row, location);
+                      }
+                      return true; });
+}
+
+#endif // __CATALOG
@@ -0,0 +1,880 @@
+#ifndef __CATALOG_FILE
+#define __CATALOG_FILE
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <algorithm>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <functional>
+#include <unordered_map>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "global.hpp"
+#include "jsonWriter.hpp"
+#include "catalog.hpp"
+
+// Persistent schema of one database, in two parts:
+//
+// ./db/<db>.catalog is a binary checkpoint. Startup maps it and builds the
+// catalog entries straight from the mapped bytes instead of parsing
+// <db>.shivam.db.
+//
+// ./db/<db>.catalog.log holds the DDL since that checkpoint as small
+// append-only records. Each record is written with one write() and made
+// durable before the change is published. Every CHECKPOINT_RECORDS records
+// the log is folded into a new checkpoint and emptied.
+//
+// <db>.shivam.db is re-exported at every checkpoint and is what tooling edits.
+// When it is newer than the checkpoint it is imported instead.
+//
+// Layout, little endian, strings are a u32 length followed by the bytes:
+//   checkpoint  magic "SHVCAT\0\0", u32 version, u32 table count,
+//               u64 payload size, u32 CRC-32 of the payload, u32 reserved,
+//               u64 LSN of the last log record it contains, then per table:
+//               name, u8 StorageEngine, u32 column count,
+//               per column: name, type, i32 length, u32 constraint count, constraints,
+//               u32 schema version, default (u8 FieldTag, then i32 or string),
+//               then u32 composite index count,
+//               per index: name, u8 IndexKind, u32 column count, column names,
+//               u32 INCLUDE column count, INCLUDE column names
+//   log record  u32 body size, u32 CRC-32 of the body,
+//               body: u64 LSN, u8 type, type-specific payload
+namespace CatalogFile
+{
+    constexpr char MAGIC[8] = {'S', 'H', 'V', 'C', 'A', 'T', 0, 0};
+    constexpr uint32_t VERSION = 6;
+    constexpr size_t CHECKPOINT_RECORDS = 256;
+
+    struct Header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t tableCount;
+        uint64_t payloadSize;
+        uint32_t checksum;
+        uint32_t reserved;
+        uint64_t lsn;
+    };
+    static_assert(sizeof(Header) == 40, "catalog header must stay 40 bytes");
+
+    enum class RecordType : uint8_t
+    {
+        CREATE_TABLE = 1, // payload: one table, encoded as in the checkpoint
+        ADD_COLUMN = 2,   // payload: table name, one column
+        CREATE_INDEX = 3, // payload: table name, the indexed column with its new constraints
+        ADD_INDEX = 4,    // payload: table name, one composite index
+    };
+
+    struct TableSchema
+    {
+        std::string name;
+        std::vector<std::shared_ptr<TableGlobalColumnNode>> columns;
+        StorageEngine engine = StorageEngine::ROW;
+        std::vector<IndexDefinition> indexes; // composite indexes
+    };
+
+    inline uint32_t crc32(const char *data, size_t size)
+    {
+        static const auto table = []
+        {
+            std::vector<uint32_t> t(256);
+            for (uint32_t i = 0; i < 256; ++i)
+            {
+                uint32_t c = i;
+                for (int k = 0; k < 8; ++k)
+                    c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                t[i] = c;
+            }
+            return t;
+        }();
+        uint32_t crc = 0xFFFFFFFFu;
+        for (size_t i = 0; i < size; ++i)
+            crc = table[(crc ^ static_cast<uint8_t>(data[i])) & 0xFF] ^ (crc >> 8);
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+    inline std::string catalogFileName(const std::string &dbName)
+    {
+        return dbDirectoryPath + "/" + dbName + ".catalog";
+    }
+
+    inline std::string logFileName(const std::string &dbName)
+    {
+        return catalogFileName(dbName) + ".log";
+    }
+
+    inline std::string jsonFileName(const std::string &dbName)
+    {
+        return dbDirectoryPath + "/" + dbName + ".shivam.db";
+    }
+
+    // Column flags follow from the constraint names, the same way the JSON loader reads them
+    inline std::shared_ptr<TableGlobalColumnNode> makeColumn(std::string name, std::string type, int length,
+                                                             std::vector<std::string> constraints,
+                                                             FieldValue defaultValue = nullptr, uint32_t schemaVersion = 0)
+    {
+        auto node = std::make_shared<TableGlobalColumnNode>();
+        node->name = std::move(name);
+        node->type = std::move(type);
+        node->length = length;
+        node->defaultValue = std::move(defaultValue);
+        node->schemaVersion = schemaVersion;
+        for (const auto &constraint : constraints)
+        {
+            if (constraint == "primary_key")
+                node->isPrimary = true;
+            if (constraint == "auto_increment")
+                node->autoIncrement = true;
+            if (constraint == "unique")
+                node->isUnique = true;
+            if (constraint == "create_index")
+                node->createIndex = true;
+            if (constraint == "hash_index")
+                node->indexKind = IndexKind::HASH;
+            if (constraint == "art_index")
+                node->indexKind = IndexKind::ART;
+        }
+        node->constraint = std::move(constraints);
+        return node;
+    }
+
+    inline void putU32(std::string &out, uint32_t value)
+    {
+        out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+
+    inline void putString(std::string &out, const std::string &value)
+    {
+        putU32(out, static_cast<uint32_t>(value.size()));
+        out.append(value);
+    }
+
+    inline void putColumn(std::string &out, const TableGlobalColumnNode &column)
+    {
+        putString(out, column.name);
+        putString(out, column.type);
+        putU32(out, static_cast<uint32_t>(column.length));
+        putU32(out, static_cast<uint32_t>(column.constraint.size()));
+        for (const auto &constraint : column.constraint)
+            putString(out, constraint);
+        putU32(out, column.schemaVersion);
+        if (const int *number = std::get_if<int>(&column.defaultValue))
+        {
+            out.push_back(static_cast<char>(FieldTag::INT_VALUE));
+            putU32(out, static_cast<uint32_t>(*number));
+        }
+        else if (const std::string *text = std::get_if<std::string>(&column.defaultValue))
+        {
+            out.push_back(static_cast<char>(FieldTag::STRING_VALUE));
+            putString(out, *text);
+        }
+        else
+        {
+            out.push_back(static_cast<char>(FieldTag::NULL_VALUE));
+        }
+    }
+
+    inline void putTable(std::string &out, const std::string &name,
+                         const std::vector<std::shared_ptr<TableGlobalColumnNode>> &columns, StorageEngine engine)
+    {
+        putString(out, name);
+        out.push_back(static_cast<char>(engine));
+        putU32(out, static_cast<uint32_t>(columns.size()));
+        for (const auto &column : columns)
+            putColumn(out, *column);
+    }
+
+    inline void putIndex(std::string &out, const IndexDefinition &index)
+    {
+        putString(out, index.name);
+        out.push_back(static_cast<char>(index.kind));
+        putU32(out, static_cast<uint32_t>(index.columns.size()));
+        for (const auto &column : index.columns)
+            putString(out, column);
+        putU32(out, static_cast<uint32_t>(index.include.size()));
+        for (const auto &column : index.include)
+            putString(out, column);
+    }
+
+    inline bool writeAll(int fd, const char *data, size_t size)
+    {
+        while (size > 0)
+        {
+            ssize_t written = ::write(fd, data, size);
+            if (written <= 0)
+                return false;
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    // Write, fsync, then rename over the old file: a crash leaves the old or the new file, never a mix
+    inline void replaceFile(const std::string &path, const std::string &contents)
+    {
+        std::string tempPath = path + ".tmp";
+        int fd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        bool ok = fd >= 0 && writeAll(fd, contents.data(), contents.size()) && ::fsync(fd) == 0;
+        if (fd >= 0)
+            ::close(fd);
+        if (!ok)
+            throw std::runtime_error("❌ Failed to write file: " + path);
+        std::filesystem::rename(tempPath, path);
+    }
+
+    inline void save(const std::string &dbName, const std::vector<std::shared_ptr<const Catalog::TableEntry>> &tables,
+                     uint64_t lsn)
+    {
+        std::string payload;
+        for (const auto &table : tables)
+        {
+            putTable(payload, table->name, table->columns, table->engine);
+            putU32(payload, static_cast<uint32_t>(table->compositeIndexes.size()));
+            for (const auto &index : table->compositeIndexes)
+                putIndex(payload, index.definition);
+        }
+
+        Header header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.tableCount = static_cast<uint32_t>(tables.size());
+        header.payloadSize = payload.size();
+        header.checksum = crc32(payload.data(), payload.size());
+        header.lsn = lsn;
+
+        std::string contents(reinterpret_cast<const char *>(&header), sizeof(header));
+        contents += payload;
+        replaceFile(catalogFileName(dbName), contents);
+    }
+
+    // Bounds-checked walk over the mapped payload
+    class Reader
+    {
+    private:
+        const char *pos;
+        const char *end;
+
+    public:
+        Reader(const char *begin, const char *end) : pos(begin), end(end) {}
+
+        bool u32(uint32_t &value)
+        {
+            if (end - pos < static_cast<ptrdiff_t>(sizeof(value)))
+                return false;
+            std::memcpy(&value, pos, sizeof(value));
+            pos += sizeof(value);
+            return true;
+        }
+
+        bool string(std::string &value)
+        {
+            uint32_t size;
+            if (!u32(size) || static_cast<uint64_t>(end - pos) < size)
+                return false;
+            value.assign(pos, size);
+            pos += size;
+            return true;
+        }
+
+        bool u64(uint64_t &value)
+        {
+            if (end - pos < static_cast<ptrdiff_t>(sizeof(value)))
+                return false;
+            std::memcpy(&value, pos, sizeof(value));
+            pos += sizeof(value);
+            return true;
+        }
+
+        bool u8(uint8_t &value)
+        {
+            if (pos == end)
+                return false;
+            value = static_cast<uint8_t>(*pos++);
+            return true;
+        }
+
+        bool done() const
+        {
+            return pos == end;
+        }
+    };
+
+    inline std::shared_ptr<TableGlobalColumnNode> readColumn(Reader &reader)
+    {
+        std::string name, type;
+        uint32_t length, constraintCount, schemaVersion;
+        if (!reader.string(name) || !reader.string(type) || !reader.u32(length) || !reader.u32(constraintCount))
+            return nullptr;
+        std::vector<std::string> constraints(constraintCount);
+        for (auto &constraint : constraints)
+        {
+            if (!reader.string(constraint))
+                return nullptr;
+        }
+
+        uint8_t tag;
+        FieldValue defaultValue = nullptr;
+        if (!reader.u32(schemaVersion) || !reader.u8(tag))
+            return nullptr;
+        if (tag == static_cast<uint8_t>(FieldTag::INT_VALUE))
+        {
+            uint32_t number;
+            if (!reader.u32(number))
+                return nullptr;
+            defaultValue = static_cast<int>(number);
+        }
+        else if (tag == static_cast<uint8_t>(FieldTag::STRING_VALUE))
+        {
+            std::string text;
+            if (!reader.string(text))
+                return nullptr;
+            defaultValue = std::move(text);
+        }
+        else if (tag != static_cast<uint8_t>(FieldTag::NULL_VALUE))
+        {
+            return nullptr;
+        }
+        return makeColumn(std::move(name), std::move(type), static_cast<int>(length), std::move(constraints),
+                          std::move(defaultValue), schemaVersion);
+    }
+
+    inline bool readTable(Reader &reader, TableSchema &table)
+    {
+        uint32_t columnCount;
+        uint8_t engine;
+        if (!reader.string(table.name) || !reader.u8(engine) || !reader.u32(columnCount) ||
+            engine > static_cast<uint8_t>(StorageEngine::COLUMNAR))
+            return false;
+        table.engine = static_cast<StorageEngine>(engine);
+        for (uint32_t c = 0; c < columnCount; ++c)
+        {
+            auto column = readColumn(reader);
+            if (!column)
+                return false;
+            table.columns.push_back(std::move(column));
+        }
+        return true;
+    }
+
+    inline bool readIndex(Reader &reader, IndexDefinition &index)
+    {
+        uint8_t kind;
+        uint32_t columnCount, includeCount;
+        if (!reader.string(index.name) || !reader.u8(kind) || !reader.u32(columnCount) ||
+            kind > static_cast<uint8_t>(IndexKind::ART))
+            return false;
+        index.kind = static_cast<IndexKind>(kind);
+        index.columns.resize(columnCount);
+        for (auto &column : index.columns)
+        {
+            if (!reader.string(column))
+                return false;
+        }
+        if (!reader.u32(includeCount))
+            return false;
+        index.include.resize(includeCount);
+        for (auto &column : index.include)
+        {
+            if (!reader.string(column))
+                return false;
+        }
+        return true;
+    }
+
+    inline bool parsePayload(const char *data, const Header &header, std::vector<TableSchema> &tables)
+    {
+        Reader reader(data, data + header.payloadSize);
+        tables.reserve(header.tableCount);
+        for (uint32_t t = 0; t < header.tableCount; ++t)
+        {
+            TableSchema table;
+            uint32_t indexCount;
+            if (!readTable(reader, table) || !reader.u32(indexCount))
+                return false;
+            table.indexes.resize(indexCount);
+            for (auto &index : table.indexes)
+            {
+                if (!readIndex(reader, index))
+                    return false;
+            }
+            tables.push_back(std::move(table));
+        }
+        return reader.done();
+    }
+
+    // False when the file is missing, from another version or corrupt
+    inline bool load(const std::string &dbName, std::vector<TableSchema> &tables, uint64_t &lsn)
+    {
+        std::string path = catalogFileName(dbName);
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat info;
+        if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Header))
+        {
+            ::close(fd);
+            return false;
+        }
+        size_t size = static_cast<size_t>(info.st_size);
+        void *mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED)
+            return false;
+
+        const char *data = static_cast<const char *>(mapped);
+        Header header;
+        std::memcpy(&header, data, sizeof(header));
+        bool ok = std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 && header.version == VERSION &&
+                  header.payloadSize == size - sizeof(Header) &&
+                  crc32(data + sizeof(Header), header.payloadSize) == header.checksum &&
+                  parsePayload(data + sizeof(Header), header, tables);
+        ::munmap(mapped, size);
+        if (!ok)
+        {
+            std::cerr << "Ignoring invalid catalog file: " << path << std::endl;
+            tables.clear();
+        }
+        lsn = ok ? header.lsn : 0;
+        return ok;
+    }
+
+    // The binary file is only trusted when the JSON has not been edited since it was written
+    inline bool isCurrent(const std::string &dbName)
+    {
+        std::error_code ec;
+        auto binaryTime = std::filesystem::last_write_time(catalogFileName(dbName), ec);
+        if (ec)
+            return false;
+        auto jsonTime = std::filesystem::last_write_time(jsonFileName(dbName), ec);
+        return ec || binaryTime >= jsonTime;
+    }
+
+    // Write <db>.shivam.db from the catalog, for tooling that reads the JSON format.
+    // Keys are emitted in sorted order, the layout JSONParser always produced.
+    inline void exportJson(const std::string &dbName)
+    {
+        JSONWriter writer(JSONWriter::Style::Pretty);
+        writer.beginArray().beginObject();
+        writer.key("name").value(dbName);
+        writer.key("tables").beginArray();
+        for (const auto &table : Catalog::tablesOf(dbName))
+        {
+            writer.beginObject().key("columns").beginArray();
+            for (const auto &column : table->columns)
+            {
+                writer.beginObject().key("constraints").beginArray();
+                for (const auto &constraint : column->constraint)
+                    writer.value(constraint);
+                writer.endArray();
+                if (const int *number = std::get_if<int>(&column->defaultValue))
+                    writer.key("default").value(*number);
+                else if (const std::string *text = std::get_if<std::string>(&column->defaultValue))
+                    writer.key("default").value(*text);
+                if (column->length != INT_MAX)
+                    writer.key("length").value(column->length);
+                writer.key("name").value(column->name);
+                if (column->schemaVersion != 0)
+                    writer.key("schema_version").value(static_cast<uint64_t>(column->schemaVersion));
+                writer.key("type").value(column->type);
+                writer.endObject();
+            }
+            writer.endArray();
+            if (table->engine == StorageEngine::COLUMNAR)
+                writer.key("engine").value("columnar");
+            if (!table->compositeIndexes.empty())
+            {
+                writer.key("indexes").beginArray();
+                for (const auto &index : table->compositeIndexes)
+                {
+                    writer.beginObject().key("columns").beginArray();
+                    for (const auto &column : index.definition.columns)
+                        writer.value(column);
+                    writer.endArray();
+                    if (!index.definition.include.empty())
+                    {
+                        writer.key("include").beginArray();
+                        for (const auto &column : index.definition.include)
+                            writer.value(column);
+                        writer.endArray();
+                    }
+                    writer.key("name").value(index.definition.name);
+                    writer.key("using").value(index.definition.kind == IndexKind::ART ? "art" : "btree");
+                    writer.endObject();
+                }
+                writer.endArray();
+            }
+            writer.key("name").value(table->name);
+            writer.endObject();
+        }
+        writer.endArray().endObject().endArray();
+        replaceFile(jsonFileName(dbName), writer.str());
+    }
+
+    // --- DDL log ---
+    struct LogRecord
+    {
+        uint64_t lsn = 0;
+        RecordType type = RecordType::CREATE_TABLE;
+        TableSchema table; // CREATE_TABLE: the table, ADD_COLUMN / CREATE_INDEX: its name and the column,
+                           // ADD_INDEX: its name and the index
+    };
+
+    inline bool readRecord(Reader &reader, LogRecord &record)
+    {
+        uint8_t type;
+        if (!reader.u64(record.lsn) || !reader.u8(type))
+            return false;
+        record.type = static_cast<RecordType>(type);
+        switch (record.type)
+        {
+        case RecordType::CREATE_TABLE:
+            return readTable(reader, record.table) && reader.done();
+        case RecordType::ADD_COLUMN:
+        case RecordType::CREATE_INDEX:
+        {
+            if (!reader.string(record.table.name))
+                return false;
+            auto column = readColumn(reader);
+            if (!column)
+                return false;
+            record.table.columns.push_back(std::move(column));
+            return reader.done();
+        }
+        case RecordType::ADD_INDEX:
+            record.table.indexes.emplace_back();
+            return reader.string(record.table.name) && readIndex(reader, record.table.indexes[0]) && reader.done();
+        }
+        return false;
+    }
+
+    struct LogState
+    {
+        uint64_t lastLsn = 0;  // last LSN written to the log or the checkpoint
+        size_t records = 0;    // records in the log since the checkpoint
+    };
+
+    // db_name -> log position, guarded by logMutex together with the files
+    inline std::unordered_map<std::string, LogState> logStates;
+    inline std::mutex logMutex;
+
+    // Every intact record in log order. A torn or corrupt tail, left by a crash
+    // in the middle of an append, is cut off so later appends follow valid records.
+    inline std::vector<LogRecord> readLog(const std::string &dbName)
+    {
+        std::vector<LogRecord> records;
+        std::string path = logFileName(dbName);
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+            return records;
+        std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+        size_t pos = 0;
+        while (contents.size() - pos >= 8)
+        {
+            uint32_t size, checksum;
+            std::memcpy(&size, contents.data() + pos, 4);
+            std::memcpy(&checksum, contents.data() + pos + 4, 4);
+            if (contents.size() - pos - 8 < size || crc32(contents.data() + pos + 8, size) != checksum)
+                break;
+
+            Reader reader(contents.data() + pos + 8, contents.data() + pos + 8 + size);
+            LogRecord record;
+            if (!readRecord(reader, record))
+                break;
+            records.push_back(std::move(record));
+            pos += 8 + size;
+        }
+        if (pos < contents.size())
+        {
+            std::cerr << "Discarding " << contents.size() - pos << " bytes of torn catalog log: " << path << std::endl;
+            std::filesystem::resize_file(path, pos);
+        }
+        return records;
+    }
+
+    inline void appendRecord(const std::string &dbName, RecordType type, const std::string &payload, LogState &state)
+    {
+        std::string body;
+        uint64_t lsn = state.lastLsn + 1;
+        body.append(reinterpret_cast<const char *>(&lsn), sizeof(lsn));
+        body.push_back(static_cast<char>(type));
+        body += payload;
+
+        std::string record;
+        putU32(record, static_cast<uint32_t>(body.size()));
+        putU32(record, crc32(body.data(), body.size()));
+        record += body;
+
+        std::string path = logFileName(dbName);
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        bool ok = fd >= 0 && writeAll(fd, record.data(), record.size()) && ::fdatasync(fd) == 0;
+        if (fd >= 0)
+            ::close(fd);
+        if (!ok)
+            throw std::runtime_error("❌ Failed to append to catalog log: " + path);
+        state.lastLsn = lsn;
+        state.records++;
+    }
+
+    // Fold the log into a new checkpoint: JSON export first, so the checkpoint
+    // is never older than the JSON, then the binary file, then an empty log.
+    // A crash before the log is emptied only leaves records the checkpoint
+    // already covers, and replay skips them by LSN.
+    inline void checkpointLocked(const std::string &dbName, LogState &state)
+    {
+        exportJson(dbName);
+        save(dbName, Catalog::tablesOf(dbName), state.lastLsn);
+        std::error_code ec;
+        std::filesystem::remove(logFileName(dbName), ec);
+        state.records = 0;
+    }
+
+    inline void checkpoint(const std::string &dbName)
+    {
+        std::lock_guard<std::mutex> lock(logMutex);
+        checkpointLocked(dbName, logStates[dbName]);
+    }
+
+    // Durably record CREATE TABLE, publish it to the catalog, checkpoint when the log is long
+    inline void createTable(const std::string &dbName, const std::string &tableName,
+                            std::vector<std::shared_ptr<TableGlobalColumnNode>> columns,
+                            StorageEngine engine = StorageEngine::ROW)
+    {
+        std::lock_guard<std::mutex> lock(logMutex);
+        if (Catalog::findTable(dbName, tableName))
+        {
+            throw std::runtime_error("❌ Table '" + tableName + "' already exists in DB '" + dbName + "'");
+        }
+        std::string payload;
+        putTable(payload, tableName, columns, engine);
+        LogState &state = logStates[dbName];
+        appendRecord(dbName, RecordType::CREATE_TABLE, payload, state);
+        Catalog::addTable(dbName, tableName, std::move(columns), engine);
+        if (state.records >= CHECKPOINT_RECORDS)
+            checkpointLocked(dbName, state);
+    }
+
+    // Durably record ALTER TABLE ADD COLUMN and publish the new schema. Stored
+    // rows are not touched, they read the column's default until rewritten.
+    inline void addColumn(const std::string &dbName, const std::string &tableName,
+                          std::shared_ptr<TableGlobalColumnNode> column)
+    {
+        std::lock_guard<std::mutex> lock(logMutex);
+        auto table = Catalog::requireTable(dbName, tableName);
+        if (table->column(column->name) != Catalog::INVALID_ID)
+        {
+            throw std::runtime_error("❌ Column '" + column->name + "' already exists in table '" + tableName + "'");
+        }
+        uint32_t version = 0;
+        for (const auto &existing : table->columns)
+            version = std::max(version, existing->schemaVersion);
+        if (version >= TableStorage::MAX_SCHEMA_VERSION)
+        {
+            throw std::runtime_error("❌ Table '" + tableName + "' has reached the limit of schema versions");
+        }
+        column->schemaVersion = version + 1;
+
+        std::string payload;
+        putString(payload, tableName);
+        putColumn(payload, *column);
+        LogState &state = logStates[dbName];
+        appendRecord(dbName, RecordType::ADD_COLUMN, payload, state);
+        Catalog::addColumn(table, column);
+        if (state.records >= CHECKPOINT_RECORDS)
+            checkpointLocked(dbName, state);
+    }
+
+    // Durably record CREATE INDEX on a primary or unique column, which gives
+    // its index another kind, and publish the column. The index itself lives
+    // in memory like every other index and is filled from the table now and
+    // at each startup; the catalog only keeps its definition.
+    inline void createIndex(const std::string &dbName, const std::string &tableName, const std::string &columnName,
+                            IndexKind kind)
+    {
+        std::lock_guard<std::mutex> lock(logMutex);
+        auto table = Catalog::requireTable(dbName, tableName);
+        Catalog::ColumnId position = table->column(columnName);
+        if (position == Catalog::INVALID_ID)
+        {
+            throw std::runtime_error("❌ Unknown column '" + columnName + "' in table '" + tableName + "'");
+        }
+        const auto &previous = table->columns[position];
+        if (!previous->isPrimary && !previous->isUnique)
+        {
+            throw std::runtime_error("❌ Column '" + columnName + "' is not unique, its index needs a row location per key");
+        }
+        if (table->index(position) && previous->indexKind == kind)
+        {
+            throw std::runtime_error("❌ Column '" + columnName + "' of table '" + tableName + "' is already indexed");
+        }
+
+        std::vector<std::string> constraints;
+        for (const auto &constraint : previous->constraint)
+        {
+            if (constraint != "hash_index" && constraint != "art_index")
+                constraints.push_back(constraint);
+        }
+        if (kind == IndexKind::HASH)
+            constraints.push_back("hash_index");
+        else if (kind == IndexKind::ART)
+            constraints.push_back("art_index");
+        auto column = makeColumn(previous->name, previous->type, previous->length, std::move(constraints),
+                                 previous->defaultValue, previous->schemaVersion);
+
+        std::string payload;
+        putString(payload, tableName);
+        putColumn(payload, *column);
+        LogState &state = logStates[dbName];
+        appendRecord(dbName, RecordType::CREATE_INDEX, payload, state);
+        Catalog::createIndex(table, column);
+        if (state.records >= CHECKPOINT_RECORDS)
+            checkpointLocked(dbName, state);
+    }
+
+    // Durably record CREATE INDEX over several columns or with INCLUDE and publish the filled index
+    inline void addIndex(const std::string &dbName, const std::string &tableName, const IndexDefinition &index)
+    {
+        std::lock_guard<std::mutex> lock(logMutex);
+        auto table = Catalog::requireTable(dbName, tableName);
+        if (table->compositeIndex(index.name))
+        {
+            throw std::runtime_error("❌ Index '" + index.name + "' already exists on table '" + tableName + "'");
+        }
+        for (const auto &columns : {index.columns, index.include})
+        {
+            for (const auto &column : columns)
+            {
+                if (table->column(column) == Catalog::INVALID_ID)
+                    throw std::runtime_error("❌ Unknown column '" + column + "' in table '" + tableName + "'");
+            }
+        }
+        if (index.kind == IndexKind::HASH)
+        {
+            throw std::runtime_error("❌ USING HASH needs a single PRIMARY KEY or UNIQUE column, a hash index holds one row per key");
+        }
+
+        std::string payload;
+        putString(payload, tableName);
+        putIndex(payload, index);
+        LogState &state = logStates[dbName];
+        appendRecord(dbName, RecordType::ADD_INDEX, payload, state);
+        Catalog::addCompositeIndex(table, index);
+        if (state.records >= CHECKPOINT_RECORDS)
+            checkpointLocked(dbName, state);
+    }
+
+    // Catalogs written before non-unique columns got composite indexes mark
+    // them "create_index" and kept one row per key. Such a column becomes a
+    // one-column composite index, true when the schema changed.
+    inline bool migrateColumnIndexes(TableSchema &schema)
+    {
+        bool migrated = false;
+        for (auto &column : schema.columns)
+        {
+            if (!column->createIndex)
+                continue;
+            migrated = true;
+            std::vector<std::string> constraints;
+            for (const auto &constraint : column->constraint)
+            {
+                if (constraint != "create_index" && (column->isPrimary || column->isUnique ||
+                                                     (constraint != "hash_index" && constraint != "art_index")))
+                    constraints.push_back(constraint);
+            }
+            IndexKind kind = column->indexKind == IndexKind::ART ? IndexKind::ART : IndexKind::BTREE;
+            column = makeColumn(column->name, column->type, column->length, std::move(constraints),
+                                column->defaultValue, column->schemaVersion);
+            if (column->isPrimary || column->isUnique)
+                continue;
+
+            IndexDefinition index{schema.name + "_" + column->name + "_idx", {column->name}, kind, {}};
+            bool present = std::any_of(schema.indexes.begin(), schema.indexes.end(), [&](const IndexDefinition &existing)
+                                       { return existing.name == index.name; });
+            if (!present)
+                schema.indexes.push_back(std::move(index));
+        }
+        return migrated;
+    }
+
+    // Startup: tables from the checkpoint (or the imported JSON) plus the log
+    // records past its LSN. A database whose log had records, or that was
+    // imported from JSON, is checkpointed right away. Replay is idempotent:
+    // tables, columns and composite indexes that already exist are skipped,
+    // an index record overwrites the column it names.
+    inline void loadDatabase(const std::string &dbName, std::vector<TableSchema> base, uint64_t baseLsn, bool imported)
+    {
+        std::unordered_map<std::string, size_t> positions;
+        for (size_t i = 0; i < base.size(); ++i)
+            positions[base[i].name] = i;
+
+        uint64_t lastLsn = baseLsn;
+        std::vector<LogRecord> records = readLog(dbName);
+        for (auto &record : records)
+        {
+            lastLsn = std::max(lastLsn, record.lsn);
+            if (record.lsn <= baseLsn)
+                continue;
+            auto it = positions.find(record.table.name);
+            if (record.type == RecordType::CREATE_TABLE && it == positions.end())
+            {
+                positions[record.table.name] = base.size();
+                base.push_back(std::move(record.table));
+            }
+            else if (record.type == RecordType::ADD_COLUMN && it != positions.end())
+            {
+                auto &columns = base[it->second].columns;
+                const auto &column = record.table.columns[0];
+                bool present = std::any_of(columns.begin(), columns.end(), [&](const auto &existing)
+                                           { return existing->name == column->name; });
+                if (!present)
+                    columns.push_back(column);
+            }
+            else if (record.type == RecordType::CREATE_INDEX && it != positions.end())
+            {
+                for (auto &column : base[it->second].columns)
+                {
+                    if (column->name == record.table.columns[0]->name)
+                        column = record.table.columns[0];
+                }
+            }
+            else if (record.type == RecordType::ADD_INDEX && it != positions.end())
+            {
+                auto &indexes = base[it->second].indexes;
+                const auto &index = record.table.indexes[0];
+                bool present = std::any_of(indexes.begin(), indexes.end(), [&](const IndexDefinition &existing)
+                                           { return existing.name == index.name; });
+                if (!present)
+                    indexes.push_back(index);
+            }
+        }
+
+        bool migrated = false;
+        for (auto &schema : base)
+            migrated = migrateColumnIndexes(schema) || migrated;
+
+        std::vector<std::shared_ptr<Catalog::TableEntry>> entries;
+        for (auto &schema : base)
+            entries.push_back(Catalog::makeTableEntry(dbName, schema.name, std::move(schema.columns), schema.engine,
+                                                      schema.indexes));
+
+        Catalog::addDatabase(dbName);
+        Catalog::addTables(dbName, entries);
+
+        std::lock_guard<std::mutex> lock(logMutex);
+        LogState &state = logStates[dbName];
+        state.lastLsn = lastLsn;
+        state.records = records.size();
+        if (imported || migrated || !records.empty())
+            checkpointLocked(dbName, state);
+    }
+};
+
+#endif // __CATALOG_FILE
@@ -0,0 +1,1423 @@
+#ifndef __COLUMN_STORE
+#define __COLUMN_STORE
+
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <filesystem>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+#include "global.hpp"
+
+// Rows of an ENGINE=COLUMNAR table. Row ids are dense like in the row store:
+// rows [0, sealedRows) sit in sealed row groups of ROW_GROUP_ROWS rows, the
+// rest in the tail, the one group still being filled.
+//
+//   <table>.tail    rows of the open group as encoded by TableStorage, each
+//                   framed by a u32 size. When it holds ROW_GROUP_ROWS rows
+//                   they are sealed into segments and the tail is emptied.
+//   <table>.c<N>    segments of the column at position N, one per sealed
+//                   group, appended in group order and never rewritten.
+//   <table>.b<N>    Bloom filters of the column at position N, for the
+//                   groups that have one, appended the same way.
+//   <table>.groups  per-group metadata, replaced through a temporary file at
+//                   every seal: magic "SHVGRP\0\0", u32 version, u32 group
+//                   count, then per group u64 first row, u32 row count,
+//                   u32 column count, per column u64 offset, u32 size,
+//                   u8 encoding, u32 null count, then the zone map: u8 kind
+//                   (0 none, 1 INT, 2 text), INT: i32 min, i32 max, text:
+//                   min and max as u32 length and bytes, then the Bloom
+//                   filter as u64 offset and u32 size (0 = none). Version 1
+//                   files have neither, version 2 files no Bloom filters.
+//
+// Scans decode only the segments of the columns a statement reads, and skip
+// a group without reading it when the zone map of a filtered column rules
+// every row out, or the Bloom filter of a column compared for equality does
+// not hold the literal. Columns
+// added after a group was sealed read as their default. Deleted rows stay in
+// their group and are hidden by the tombstones of the owning TableStorage.
+namespace ColumnStorage
+{
+    constexpr char GROUPS_MAGIC[8] = {'S', 'H', 'V', 'G', 'R', 'P', 0, 0};
+    constexpr uint32_t GROUPS_VERSION = 3;
+    constexpr uint32_t ROW_GROUP_ROWS = 64 * 1024;
+    constexpr size_t ZONE_TEXT_LIMIT = 64; // longer maxima leave a text column without a zone map
+
+    // Every segment starts with a null bitmap (bit i set = row i is NULL).
+    //   PLAIN        INT columns: an i32 per row. Others: (rows + 1) u32 end
+    //                offsets, then the bytes.
+    //   DICTIONARY   non-INT columns: u32 entry count, the distinct values in
+    //                ascending order as (count + 1) u32 end offsets and their
+    //                bytes, u8 code width, then one code per row bit-packed
+    //                LSB first. NULL rows carry code 0.
+    //   FOR          INT columns: i32 minimum, u8 width, then value - minimum
+    //                per row bit-packed.
+    //   DELTA        INT columns: i32 first value, i32 smallest difference,
+    //                u8 width, then for rows 1.. the difference to the previous
+    //                row minus the smallest one, bit-packed.
+    //   RLE          INT columns: u32 run count, then per run i32 value and
+    //                u32 length.
+    // INT encodings give NULL rows the value of the row before them, so they
+    // neither break runs nor widen the packed fields.
+    enum class SegmentEncoding : uint8_t
+    {
+        PLAIN = 0,
+        DICTIONARY = 1,
+        FOR = 2,
+        DELTA = 3,
+        RLE = 4
+    };
+
+    struct SegmentMeta
+    {
+        uint64_t offset = 0;
+        uint32_t size = 0;
+        SegmentEncoding encoding = SegmentEncoding::PLAIN;
+        uint32_t nullCount = 0;
+        FieldValue min = nullptr; // smallest and largest non-NULL value, NULL when unknown
+        FieldValue max = nullptr;
+        uint64_t bloomOffset = 0;
+        uint32_t bloomSize = 0; // 0 = no Bloom filter
+    };
+
+    struct RowGroupMeta
+    {
+        int64_t firstRow = 0;
+        uint32_t rowCount = 0;
+        std::vector<SegmentMeta> segments; // by column position, columns added later have none
+    };
+
+    using ColumnVector = std::vector<FieldValue>;
+
+    // A decoded segment. Dictionary segments stay as codes, a value is looked
+    // up only for the rows a scan produces, and filters run once per entry.
+    struct ColumnData
+    {
+        ColumnVector values;         // PLAIN: one per row. DICTIONARY: the entries, then NULL.
+        std::vector<uint32_t> codes; // DICTIONARY: index into values per row, NULL rows point at the last entry
+        bool dictionary = false;
+
+        const FieldValue &at(size_t row) const
+        {
+            return dictionary ? values[codes[row]] : values[row];
+        }
+    };
+
+    template <typename T>
+    inline void putRaw(std::string &out, T value)
+    {
+        out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    inline T getRaw(const char *data)
+    {
+        T value;
+        std::memcpy(&value, data, sizeof(T));
+        return value;
+    }
+
+    // Bits needed for values up to maxValue, at least 1
+    inline unsigned bitWidth(uint32_t maxValue)
+    {
+        return maxValue == 0 ? 1 : 32 - __builtin_clz(maxValue);
+    }
+
+    inline size_t packedSize(size_t count, unsigned width)
+    {
+        return (count * width + 7) / 8;
+    }
+
+    // Append `values` as `width`-bit fields, LSB first
+    inline void packBits(const std::vector<uint32_t> &values, unsigned width, std::string &out)
+    {
+        size_t start = out.size();
+        out.resize(start + packedSize(values.size(), width), '\0');
+        char *data = out.data() + start;
+        uint64_t buffer = 0;
+        unsigned filled = 0;
+        size_t pos = 0;
+        for (uint32_t value : values)
+        {
+            buffer |= static_cast<uint64_t>(value) << filled;
+            filled += width;
+            while (filled >= 8)
+            {
+                data[pos++] = static_cast<char>(buffer & 0xFF);
+                buffer >>= 8;
+                filled -= 8;
+            }
+        }
+        if (filled > 0)
+            data[pos] = static_cast<char>(buffer & 0xFF);
+    }
+
+    // Read `count` fields of `width` bits, the input holds packedSize(count, width)
+    // bytes. Every field lies in the 8-byte window starting at its first byte;
+    // with AVX2, fields of up to 25 bits are gathered eight at a time from
+    // 4-byte windows, whose offsets and shifts repeat every eight fields.
+    inline void unpackBits(const char *data, size_t count, unsigned width, std::vector<uint32_t> &out)
+    {
+        out.resize(count);
+        size_t bytes = packedSize(count, width);
+        uint64_t mask = (uint64_t(1) << width) - 1;
+        size_t i = 0;
+#ifdef __AVX2__
+        if (width <= 25)
+        {
+            __m256i bits = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(width));
+            __m256i offsets = _mm256_srli_epi32(bits, 3);
+            __m256i shifts = _mm256_and_si256(bits, _mm256_set1_epi32(7));
+            __m256i fieldMask = _mm256_set1_epi32(static_cast<int>(mask));
+            size_t lastWindow = (7 * width) / 8 + sizeof(uint32_t);
+            for (; i + 8 <= count && (i / 8) * width + lastWindow <= bytes; i += 8)
+            {
+                const int *base = reinterpret_cast<const int *>(data + (i / 8) * width);
+                __m256i windows = _mm256_i32gather_epi32(base, offsets, 1);
+                __m256i fields = _mm256_and_si256(_mm256_srlv_epi32(windows, shifts), fieldMask);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out.data() + i), fields);
+            }
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            size_t bit = i * width;
+            size_t byte = bit / 8;
+            uint64_t window = 0;
+            if (byte + sizeof(uint64_t) <= bytes)
+                std::memcpy(&window, data + byte, sizeof(uint64_t));
+            else
+                std::memcpy(&window, data + byte, bytes - byte);
+            out[i] = static_cast<uint32_t>((window >> (bit % 8)) & mask);
+        }
+    }
+
+    // values[i] = start + sum of (base + deltas[j]) for j <= i, in 32-bit
+    // wrap-around arithmetic. Four lanes at a time with SSE2.
+    inline void prefixSum(std::vector<uint32_t> &values, uint32_t start, uint32_t base)
+    {
+        size_t i = 0;
+        uint32_t running = start;
+#ifdef __SSE2__
+        __m128i carry = _mm_set1_epi32(static_cast<int>(start));
+        __m128i step = _mm_set1_epi32(static_cast<int>(base));
+        for (; i + 4 <= values.size(); i += 4)
+        {
+            __m128i *slot = reinterpret_cast<__m128i *>(values.data() + i);
+            __m128i x = _mm_add_epi32(_mm_loadu_si128(slot), step);
+            x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+            x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+            x = _mm_add_epi32(x, carry);
+            _mm_storeu_si128(slot, x);
+            carry = _mm_shuffle_epi32(x, 0xFF);
+        }
+        running = static_cast<uint32_t>(_mm_cvtsi128_si32(carry));
+#endif
+        for (; i < values.size(); ++i)
+        {
+            running += base + values[i];
+            values[i] = running;
+        }
+    }
+
+    // Split-block Bloom filter: 32-byte blocks of eight u32 words. A key picks
+    // one block with the high half of its hash and sets one bit per word from
+    // the low half, so a probe reads a single block, i.e. one page of the file.
+    constexpr size_t BLOOM_BLOCK = 32;
+    constexpr size_t BLOOM_BITS_PER_KEY = 10;
+    constexpr uint32_t BLOOM_SALT[8] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                                        0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+
+    inline uint64_t mixHash(uint64_t x)
+    {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    // Stable across builds, the hashes are stored in the filter files
+    inline uint64_t hashInt(int32_t value)
+    {
+        return mixHash(static_cast<uint32_t>(value));
+    }
+
+    inline uint64_t hashText(std::string_view text)
+    {
+        uint64_t hash = 0xcbf29ce484222325ULL; // FNV-1a
+        for (unsigned char c : text)
+            hash = (hash ^ c) * 0x100000001b3ULL;
+        return mixHash(hash);
+    }
+
+    // Hash of `value` as stored in a column, false when an equality test
+    // against it does not compare the stored form (INT column, text literal)
+    inline bool bloomHash(bool intColumn, const FieldValue &value, uint64_t &hash)
+    {
+        if (const int *number = std::get_if<int>(&value))
+            hash = intColumn ? hashInt(*number) : hashText(std::to_string(*number));
+        else if (const std::string *text = std::get_if<std::string>(&value); text && !intColumn)
+            hash = hashText(*text);
+        else
+            return false;
+        return true;
+    }
+
+    inline size_t bloomBlockOf(uint64_t hash, size_t blocks)
+    {
+        return static_cast<size_t>(((hash >> 32) * blocks) >> 32);
+    }
+
+    inline void bloomInsert(char *block, uint64_t hash)
+    {
+        for (size_t i = 0; i < 8; ++i)
+        {
+            uint32_t word = getRaw<uint32_t>(block + i * 4) | (1u << ((static_cast<uint32_t>(hash) * BLOOM_SALT[i]) >> 27));
+            std::memcpy(block + i * 4, &word, sizeof(word));
+        }
+    }
+
+    inline bool bloomContains(const char *block, uint64_t hash)
+    {
+        for (size_t i = 0; i < 8; ++i)
+        {
+            if (!((getRaw<uint32_t>(block + i * 4) >> ((static_cast<uint32_t>(hash) * BLOOM_SALT[i]) >> 27)) & 1))
+                return false;
+        }
+        return true;
+    }
+
+    // Collects one column of a row group, then encodes it as a segment in
+    // whichever encoding comes out smallest
+    class SegmentBuilder
+    {
+    private:
+        bool intColumn;
+        uint32_t rows = 0;
+        uint32_t nulls = 0;
+        std::string nullBitmap;
+        std::vector<int32_t> ints;
+        std::vector<uint32_t> ends;
+        std::string bytes;
+        bool hasRange = false;
+        int32_t lowInt = 0, highInt = 0;
+        uint32_t lowRow = 0, highRow = 0; // text columns: rows holding the smallest and largest value
+
+        std::string_view text(uint32_t row) const
+        {
+            uint32_t start = row == 0 ? 0 : ends[row - 1];
+            return std::string_view(bytes).substr(start, ends[row] - start);
+        }
+
+        bool isNull(uint32_t row) const
+        {
+            return (static_cast<uint8_t>(nullBitmap[row / 8]) >> (row % 8)) & 1;
+        }
+
+        std::string plain() const
+        {
+            std::string out = nullBitmap;
+            if (intColumn)
+            {
+                out.append(reinterpret_cast<const char *>(ints.data()), ints.size() * sizeof(int32_t));
+                return out;
+            }
+            putRaw<uint32_t>(out, 0);
+            out.append(reinterpret_cast<const char *>(ends.data()), ends.size() * sizeof(uint32_t));
+            out += bytes;
+            return out;
+        }
+
+        // The INT values with each NULL replaced by the value before it
+        std::vector<int32_t> filledInts() const
+        {
+            std::vector<int32_t> filled(ints);
+            uint32_t first = 0;
+            while (first < rows && isNull(first))
+                first++;
+            int32_t previous = first < rows ? ints[first] : 0;
+            for (uint32_t i = 0; i < rows; ++i)
+            {
+                if (isNull(i))
+                    filled[i] = previous;
+                else
+                    previous = filled[i];
+            }
+            return filled;
+        }
+
+        // INT columns: sizes of every encoding from one pass over the values,
+        // then the smallest one is written
+        std::string integers(SegmentEncoding &encoding) const
+        {
+            std::vector<int32_t> values = filledInts();
+            int64_t low = 0, high = 0, lowDelta = 0, highDelta = 0;
+            uint32_t runs = 0;
+            for (uint32_t i = 0; i < rows; ++i)
+            {
+                int64_t value = values[i];
+                if (i == 0)
+                {
+                    low = high = value;
+                    runs = 1;
+                    continue;
+                }
+                low = std::min(low, value);
+                high = std::max(high, value);
+                int64_t delta = value - values[i - 1];
+                lowDelta = i == 1 ? delta : std::min(lowDelta, delta);
+                highDelta = i == 1 ? delta : std::max(highDelta, delta);
+                runs += delta != 0;
+            }
+
+            unsigned forWidth = bitWidth(static_cast<uint32_t>(high - low));
+            unsigned deltaWidth = highDelta - lowDelta <= UINT32_MAX ? bitWidth(static_cast<uint32_t>(highDelta - lowDelta)) : 0;
+            size_t best = nullBitmap.size() + size_t(rows) * sizeof(int32_t);
+            encoding = SegmentEncoding::PLAIN;
+            auto consider = [&](SegmentEncoding candidate, size_t size)
+            {
+                if (size < best)
+                {
+                    best = size;
+                    encoding = candidate;
+                }
+            };
+            if (rows > 0)
+            {
+                consider(SegmentEncoding::FOR, nullBitmap.size() + 4 + 1 + packedSize(rows, forWidth));
+                if (deltaWidth > 0)
+                    consider(SegmentEncoding::DELTA, nullBitmap.size() + 4 + 4 + 1 + packedSize(rows - 1, deltaWidth));
+                consider(SegmentEncoding::RLE, nullBitmap.size() + 4 + size_t(runs) * 8);
+            }
+
+            std::string out = nullBitmap;
+            out.reserve(best);
+            std::vector<uint32_t> fields;
+            switch (encoding)
+            {
+            case SegmentEncoding::FOR:
+                putRaw<int32_t>(out, static_cast<int32_t>(low));
+                out.push_back(static_cast<char>(forWidth));
+                fields.reserve(rows);
+                for (int32_t value : values)
+                    fields.push_back(static_cast<uint32_t>(value - low));
+                packBits(fields, forWidth, out);
+                break;
+            case SegmentEncoding::DELTA:
+                putRaw<int32_t>(out, values[0]);
+                putRaw<int32_t>(out, static_cast<int32_t>(lowDelta));
+                out.push_back(static_cast<char>(deltaWidth));
+                fields.reserve(rows - 1);
+                for (uint32_t i = 1; i < rows; ++i)
+                    fields.push_back(static_cast<uint32_t>(int64_t(values[i]) - values[i - 1] - lowDelta));
+                packBits(fields, deltaWidth, out);
+                break;
+            case SegmentEncoding::RLE:
+            {
+                putRaw<uint32_t>(out, runs);
+                uint32_t start = 0;
+                for (uint32_t i = 1; i <= rows; ++i)
+                {
+                    if (i < rows && values[i] == values[start])
+                        continue;
+                    putRaw<int32_t>(out, values[start]);
+                    putRaw<uint32_t>(out, i - start);
+                    start = i;
+                }
+                break;
+            }
+            default:
+                return plain();
+            }
+            return out;
+        }
+
+        // Empty when the dictionary would not be smaller than PLAIN
+        std::string dictionary() const
+        {
+            std::vector<std::string_view> entries;
+            entries.reserve(rows);
+            for (uint32_t i = 0; i < rows; ++i)
+            {
+                if (!isNull(i))
+                    entries.push_back(text(i));
+            }
+            std::sort(entries.begin(), entries.end());
+            entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+
+            size_t entryBytes = 0;
+            for (std::string_view entry : entries)
+                entryBytes += entry.size();
+            unsigned width = bitWidth(entries.empty() ? 0 : static_cast<uint32_t>(entries.size() - 1));
+            size_t size = nullBitmap.size() + sizeof(uint32_t) * (entries.size() + 2) + entryBytes + 1 +
+                          packedSize(rows, width);
+            size_t plainSize = nullBitmap.size() + sizeof(uint32_t) * (rows + 1) + bytes.size();
+            if (size >= plainSize)
+                return std::string();
+
+            std::unordered_map<std::string_view, uint32_t> codeOf;
+            codeOf.reserve(entries.size());
+            std::string out = nullBitmap;
+            putRaw<uint32_t>(out, static_cast<uint32_t>(entries.size()));
+            putRaw<uint32_t>(out, 0);
+            uint32_t end = 0;
+            for (size_t i = 0; i < entries.size(); ++i)
+            {
+                codeOf[entries[i]] = static_cast<uint32_t>(i);
+                end += static_cast<uint32_t>(entries[i].size());
+                putRaw<uint32_t>(out, end);
+            }
+            for (std::string_view entry : entries)
+                out.append(entry);
+            out.push_back(static_cast<char>(width));
+
+            std::vector<uint32_t> codes(rows, 0);
+            for (uint32_t i = 0; i < rows; ++i)
+            {
+                if (!isNull(i))
+                    codes[i] = codeOf[text(i)];
+            }
+            packBits(codes, width, out);
+            return out;
+        }
+
+    public:
+        explicit SegmentBuilder(bool intColumn) : intColumn(intColumn) {}
+
+        // Bloom filter over the non-NULL values, empty when it would not be
+        // smaller than the encoded segment a lookup would otherwise read
+        std::string bloomFilter(size_t segmentSize) const
+        {
+            size_t keys = rows - nulls;
+            size_t blocks = std::max<size_t>(1, (keys * BLOOM_BITS_PER_KEY + BLOOM_BLOCK * 8 - 1) / (BLOOM_BLOCK * 8));
+            if (keys == 0 || blocks * BLOOM_BLOCK >= segmentSize)
+                return std::string();
+            std::string out(blocks * BLOOM_BLOCK, '\0');
+            for (uint32_t i = 0; i < rows; ++i)
+            {
+                if (isNull(i))
+                    continue;
+                uint64_t hash = intColumn ? hashInt(ints[i]) : hashText(text(i));
+                bloomInsert(out.data() + bloomBlockOf(hash, blocks) * BLOOM_BLOCK, hash);
+            }
+            return out;
+        }
+
+        void add(const FieldValue &value)
+        {
+            if (rows % 8 == 0)
+                nullBitmap.push_back(0);
+            bool isNull = std::holds_alternative<std::nullptr_t>(value);
+            if (isNull)
+            {
+                nullBitmap[rows / 8] |= static_cast<char>(1 << (rows % 8));
+                nulls++;
+            }
+            rows++;
+
+            if (intColumn)
+            {
+                const int *number = std::get_if<int>(&value);
+                if (!isNull && !number)
+                    throw std::runtime_error("❌ Non-INT value in an INT column segment");
+                ints.push_back(number ? *number : 0);
+                if (number)
+                {
+                    lowInt = hasRange ? std::min(lowInt, *number) : *number;
+                    highInt = hasRange ? std::max(highInt, *number) : *number;
+                    hasRange = true;
+                }
+                return;
+            }
+            if (const std::string *text = std::get_if<std::string>(&value))
+                bytes += *text;
+            else if (const int *number = std::get_if<int>(&value))
+                bytes += std::to_string(*number);
+            ends.push_back(static_cast<uint32_t>(bytes.size()));
+            if (!isNull)
+            {
+                uint32_t row = rows - 1;
+                if (!hasRange || text(row) < text(lowRow))
+                    lowRow = row;
+                if (!hasRange || text(row) > text(highRow))
+                    highRow = row;
+                hasRange = true;
+            }
+        }
+
+        std::string finish(SegmentMeta &meta) const
+        {
+            meta.nullCount = nulls;
+            meta.min = meta.max = nullptr;
+            if (hasRange && intColumn)
+            {
+                meta.min = static_cast<int>(lowInt);
+                meta.max = static_cast<int>(highInt);
+            }
+            else if (hasRange && text(highRow).size() <= ZONE_TEXT_LIMIT)
+            {
+                // A prefix of the minimum still bounds it from below
+                meta.min = std::string(text(lowRow).substr(0, ZONE_TEXT_LIMIT));
+                meta.max = std::string(text(highRow));
+            }
+            if (intColumn)
+                return integers(meta.encoding);
+            std::string encoded = dictionary();
+            if (!encoded.empty())
+            {
+                meta.encoding = SegmentEncoding::DICTIONARY;
+                return encoded;
+            }
+            meta.encoding = SegmentEncoding::PLAIN;
+            return plain();
+        }
+    };
+
+    // The values of a FOR, DELTA or RLE body (the segment after its null
+    // bitmap) as u32 bit patterns, false when it is malformed
+    inline bool decodeIntegers(SegmentEncoding encoding, const char *data, size_t size, uint32_t rows,
+                               std::vector<uint32_t> &out)
+    {
+        out.clear();
+        if (rows == 0)
+            return size == 0;
+        if (encoding == SegmentEncoding::FOR)
+        {
+            if (size < 5)
+                return false;
+            uint32_t low = getRaw<uint32_t>(data);
+            unsigned width = static_cast<uint8_t>(data[4]);
+            if (width == 0 || width > 32 || size != 5 + packedSize(rows, width))
+                return false;
+            unpackBits(data + 5, rows, width, out);
+            for (uint32_t &value : out)
+                value += low;
+            return true;
+        }
+        if (encoding == SegmentEncoding::DELTA)
+        {
+            if (size < 9)
+                return false;
+            uint32_t first = getRaw<uint32_t>(data);
+            uint32_t lowDelta = getRaw<uint32_t>(data + 4);
+            unsigned width = static_cast<uint8_t>(data[8]);
+            if (width == 0 || width > 32 || size != 9 + packedSize(rows - 1, width))
+                return false;
+            std::vector<uint32_t> deltas;
+            unpackBits(data + 9, rows - 1, width, deltas);
+            prefixSum(deltas, first, lowDelta);
+            out.reserve(rows);
+            out.push_back(first);
+            out.insert(out.end(), deltas.begin(), deltas.end());
+            return true;
+        }
+        if (encoding == SegmentEncoding::RLE)
+        {
+            if (size < 4)
+                return false;
+            uint32_t runs = getRaw<uint32_t>(data);
+            if (size != 4 + size_t(runs) * 8)
+                return false;
+            out.reserve(rows);
+            for (uint32_t r = 0; r < runs; ++r)
+            {
+                uint32_t value = getRaw<uint32_t>(data + 4 + r * 8);
+                uint32_t length = getRaw<uint32_t>(data + 8 + r * 8);
+                if (length > rows - out.size())
+                    return false;
+                out.insert(out.end(), length, value);
+            }
+            return out.size() == rows;
+        }
+        return false;
+    }
+
+    // Decode a segment of `rows` values, false when it is malformed
+    inline bool decodeSegment(bool intColumn, const SegmentMeta &meta, const std::string &data, uint32_t rows,
+                              ColumnData &out)
+    {
+        size_t bitmapSize = (rows + 7) / 8;
+        auto isNull = [&data](uint32_t row)
+        { return (static_cast<uint8_t>(data[row / 8]) >> (row % 8)) & 1; };
+
+        out.values.clear();
+        out.codes.clear();
+        out.dictionary = false;
+        if (data.size() < bitmapSize)
+            return false;
+
+        // (count + 1) end offsets followed by the bytes, starting at `pos`
+        auto readStrings = [&data](size_t &pos, uint32_t count, ColumnVector &values,
+                                   const std::function<bool(uint32_t)> &null)
+        {
+            size_t bytesStart = pos + (size_t(count) + 1) * sizeof(uint32_t);
+            if (data.size() < bytesStart)
+                return false;
+            const char *ends = data.data() + pos;
+            uint32_t start = getRaw<uint32_t>(ends);
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                uint32_t end = getRaw<uint32_t>(ends + (i + 1) * sizeof(uint32_t));
+                if (end < start || bytesStart + end > data.size())
+                    return false;
+                if (null && null(i))
+                    values.emplace_back(nullptr);
+                else
+                    values.emplace_back(data.substr(bytesStart + start, end - start));
+                start = end;
+            }
+            pos = bytesStart + start;
+            return true;
+        };
+
+        if (meta.encoding == SegmentEncoding::DICTIONARY && !intColumn)
+        {
+            size_t pos = bitmapSize;
+            if (data.size() < pos + sizeof(uint32_t))
+                return false;
+            uint32_t count = getRaw<uint32_t>(data.data() + pos);
+            pos += sizeof(uint32_t);
+            out.values.reserve(count + 1);
+            if (!readStrings(pos, count, out.values, nullptr) || pos >= data.size())
+                return false;
+            out.values.emplace_back(nullptr);
+            unsigned width = static_cast<uint8_t>(data[pos++]);
+            if (width == 0 || width > 32 || data.size() - pos < packedSize(rows, width))
+                return false;
+            unpackBits(data.data() + pos, rows, width, out.codes);
+            for (uint32_t i = 0; i < rows; ++i)
+            {
+                if (isNull(i))
+                    out.codes[i] = count;
+                else if (out.codes[i] >= count)
+                    return false;
+            }
+            out.dictionary = true;
+            return true;
+        }
+        if (intColumn && meta.encoding != SegmentEncoding::PLAIN)
+        {
+            std::vector<uint32_t> numbers;
+            if (!decodeIntegers(meta.encoding, data.data() + bitmapSize, data.size() - bitmapSize, rows, numbers))
+                return false;
+            out.values.reserve(rows);
+            for (uint32_t i = 0; i < rows; ++i)
+            {
+                if (isNull(i))
+                    out.values.emplace_back(nullptr);
+                else
+                    out.values.emplace_back(static_cast<int>(static_cast<int32_t>(numbers[i])));
+            }
+            return true;
+        }
+        if (meta.encoding != SegmentEncoding::PLAIN)
+            return false;
+
+        out.values.reserve(rows);
+        if (intColumn)
+        {
+            if (data.size() != bitmapSize + size_t(rows) * sizeof(int32_t))
+                return false;
+            const char *values = data.data() + bitmapSize;
+            for (uint32_t i = 0; i < rows; ++i)
+            {
+                if (isNull(i))
+                    out.values.emplace_back(nullptr);
+                else
+                    out.values.emplace_back(static_cast<int>(getRaw<int32_t>(values + i * sizeof(int32_t))));
+            }
+            return true;
+        }
+        size_t pos = bitmapSize;
+        return readStrings(pos, rows, out.values, isNull) && pos == data.size();
+    }
+
+    // A `column op literal` conjunct a scan can test on a column before it
+    // builds the row. For a dictionary segment it runs once per entry.
+    // mayMatch(min, max) is false when no value in that range passes, so a
+    // group whose zone map says so is skipped unread. `equals` is the literal
+    // of a `column = literal` filter, checked against Bloom filters.
+    struct ColumnFilter
+    {
+        size_t column;
+        std::function<bool(const FieldValue &)> test;
+        std::function<bool(const FieldValue &, const FieldValue &)> mayMatch;
+        FieldValue equals = nullptr;
+    };
+
+    class ColumnStore
+    {
+    public:
+        // Decodes one tail record the way TableStorage encoded it
+        using RowDecoder = std::function<bool(const std::string &, int64_t &, Row &)>;
+
+        // A slice of rows [first, end) handed to a scanner: the decoded columns
+        // of one sealed group, or a copy of the tail records
+        struct Batch
+        {
+            enum class Column : uint8_t
+            {
+                SKIPPED, // not read by the statement, left NULL
+                ABSENT,  // added after the group was sealed, reads as its default
+                LOADED
+            };
+
+            int64_t first = 0;
+            int64_t end = 0;
+            bool sealed = false;
+            bool pruned = false; // the zone maps rule out every row, nothing was read
+            std::vector<Column> state;
+            std::vector<ColumnData> values;
+            std::string tail;
+            std::vector<uint32_t> tailEnds; // end of each record in `tail`
+        };
+
+    private:
+        std::string tailFileName;
+        std::string groupsFileName;
+        std::string columnFilePrefix;
+        std::string bloomFilePrefix;
+        const std::vector<std::shared_ptr<TableGlobalColumnNode>> &columns;
+        RowDecoder decode;
+
+        mutable std::mutex mutex;
+        std::vector<RowGroupMeta> groups;
+        int64_t sealedRows = 0;
+        std::vector<int64_t> tailOffsets; // file offset of each tail record, row sealedRows + i
+        int64_t tailSize = 0;
+
+        // Last group a point read decoded, every column of it
+        mutable size_t cachedGroup = SIZE_MAX;
+        mutable Batch cached;
+
+        std::string columnFileName(size_t position) const
+        {
+            return columnFilePrefix + std::to_string(position);
+        }
+
+        std::string bloomFileName(size_t position) const
+        {
+            return bloomFilePrefix + std::to_string(position);
+        }
+
+        static bool writeAll(int fd, const char *data, size_t size)
+        {
+            while (size > 0)
+            {
+                ssize_t written = ::write(fd, data, size);
+                if (written <= 0)
+                    return false;
+                data += written;
+                size -= static_cast<size_t>(written);
+            }
+            return true;
+        }
+
+        // Offset `data` landed at, synced before the metadata points at it
+        static uint64_t appendToFile(const std::string &fileName, const std::string &data)
+        {
+            int fd = ::open(fileName.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+            off_t offset = fd >= 0 ? ::lseek(fd, 0, SEEK_END) : -1;
+            bool ok = offset >= 0 && writeAll(fd, data.data(), data.size()) && ::fdatasync(fd) == 0;
+            if (fd >= 0)
+                ::close(fd);
+            if (!ok)
+                throw std::runtime_error("❌ Failed to write column segment: " + fileName);
+            return static_cast<uint64_t>(offset);
+        }
+
+        // Columns point lookups are expected on: unique ones and those the
+        // schema asks an index for
+        static bool wantsBloomFilter(const TableGlobalColumnNode &column)
+        {
+            return column.isUnique || column.isPrimary || column.createIndex;
+        }
+
+        void loadGroups()
+        {
+            std::ifstream in(groupsFileName, std::ios::binary);
+            if (!in)
+                return;
+            std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            size_t pos = 0;
+            auto need = [&](size_t n)
+            {
+                if (data.size() - pos < n)
+                    throw std::runtime_error("❌ Truncated row group metadata: " + groupsFileName);
+            };
+            need(sizeof(GROUPS_MAGIC) + 2 * sizeof(uint32_t));
+            uint32_t version = getRaw<uint32_t>(data.data() + sizeof(GROUPS_MAGIC));
+            if (std::memcmp(data.data(), GROUPS_MAGIC, sizeof(GROUPS_MAGIC)) != 0 || version < 1 ||
+                version > GROUPS_VERSION)
+                throw std::runtime_error("❌ Unsupported row group metadata: " + groupsFileName);
+            pos = sizeof(GROUPS_MAGIC) + sizeof(uint32_t);
+            uint32_t count = getRaw<uint32_t>(data.data() + pos);
+            pos += sizeof(uint32_t);
+
+            for (uint32_t g = 0; g < count; ++g)
+            {
+                RowGroupMeta group;
+                need(sizeof(int64_t) + 2 * sizeof(uint32_t));
+                group.firstRow = getRaw<int64_t>(data.data() + pos);
+                group.rowCount = getRaw<uint32_t>(data.data() + pos + 8);
+                uint32_t columnCount = getRaw<uint32_t>(data.data() + pos + 12);
+                pos += 16;
+                for (uint32_t c = 0; c < columnCount; ++c)
+                {
+                    SegmentMeta segment;
+                    need(8 + 4 + 1 + 4);
+                    segment.offset = getRaw<uint64_t>(data.data() + pos);
+                    segment.size = getRaw<uint32_t>(data.data() + pos + 8);
+                    segment.encoding = static_cast<SegmentEncoding>(data[pos + 12]);
+                    segment.nullCount = getRaw<uint32_t>(data.data() + pos + 13);
+                    pos += 17;
+                    if (version >= 2)
+                    {
+                        need(1);
+                        uint8_t kind = static_cast<uint8_t>(data[pos++]);
+                        if (kind == 1)
+                        {
+                            need(2 * sizeof(int32_t));
+                            segment.min = static_cast<int>(getRaw<int32_t>(data.data() + pos));
+                            segment.max = static_cast<int>(getRaw<int32_t>(data.data() + pos + 4));
+                            pos += 8;
+                        }
+                        else if (kind == 2)
+                        {
+                            for (FieldValue *bound : {&segment.min, &segment.max})
+                            {
+                                need(sizeof(uint32_t));
+                                uint32_t length = getRaw<uint32_t>(data.data() + pos);
+                                pos += sizeof(uint32_t);
+                                need(length);
+                                *bound = data.substr(pos, length);
+                                pos += length;
+                            }
+                        }
+                        else if (kind != 0)
+                            throw std::runtime_error("❌ Corrupt row group metadata: " + groupsFileName);
+                    }
+                    if (version >= 3)
+                    {
+                        need(sizeof(uint64_t) + sizeof(uint32_t));
+                        segment.bloomOffset = getRaw<uint64_t>(data.data() + pos);
+                        segment.bloomSize = getRaw<uint32_t>(data.data() + pos + 8);
+                        pos += 12;
+                    }
+                    group.segments.push_back(segment);
+                }
+                sealedRows = group.firstRow + group.rowCount;
+                groups.push_back(std::move(group));
+            }
+        }
+
+        void saveGroups() const
+        {
+            std::string out(GROUPS_MAGIC, sizeof(GROUPS_MAGIC));
+            putRaw<uint32_t>(out, GROUPS_VERSION);
+            putRaw<uint32_t>(out, static_cast<uint32_t>(groups.size()));
+            for (const auto &group : groups)
+            {
+                putRaw<int64_t>(out, group.firstRow);
+                putRaw<uint32_t>(out, group.rowCount);
+                putRaw<uint32_t>(out, static_cast<uint32_t>(group.segments.size()));
+                for (const auto &segment : group.segments)
+                {
+                    putRaw<uint64_t>(out, segment.offset);
+                    putRaw<uint32_t>(out, segment.size);
+                    out.push_back(static_cast<char>(segment.encoding));
+                    putRaw<uint32_t>(out, segment.nullCount);
+                    if (const int *low = std::get_if<int>(&segment.min))
+                    {
+                        out.push_back(1);
+                        putRaw<int32_t>(out, *low);
+                        putRaw<int32_t>(out, std::get<int>(segment.max));
+                    }
+                    else if (const std::string *low = std::get_if<std::string>(&segment.min))
+                    {
+                        out.push_back(2);
+                        for (const std::string *bound : {low, &std::get<std::string>(segment.max)})
+                        {
+                            putRaw<uint32_t>(out, static_cast<uint32_t>(bound->size()));
+                            out += *bound;
+                        }
+                    }
+                    else
+                        out.push_back(0);
+                    putRaw<uint64_t>(out, segment.bloomOffset);
+                    putRaw<uint32_t>(out, segment.bloomSize);
+                }
+            }
+
+            // A crash leaves the old metadata or the new one, never a mix
+            std::string tempName = groupsFileName + ".tmp";
+            int fd = ::open(tempName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            bool ok = fd >= 0 && writeAll(fd, out.data(), out.size()) && ::fsync(fd) == 0;
+            if (fd >= 0)
+                ::close(fd);
+            if (!ok)
+                throw std::runtime_error("❌ Failed to write row group metadata: " + groupsFileName);
+            std::filesystem::rename(tempName, groupsFileName);
+        }
+
+        // Index the tail records, dropping a torn last record and rows a seal
+        // already copied into a group before it could empty the tail
+        void loadTail()
+        {
+            std::ifstream in(tailFileName, std::ios::binary);
+            if (!in)
+                return;
+            std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            in.close();
+
+            size_t pos = 0;
+            std::vector<int64_t> offsets;
+            while (data.size() - pos >= sizeof(uint32_t))
+            {
+                uint32_t size = getRaw<uint32_t>(data.data() + pos);
+                if (data.size() - pos - sizeof(uint32_t) < size || size < sizeof(int64_t))
+                    break;
+                offsets.push_back(static_cast<int64_t>(pos));
+                pos += sizeof(uint32_t) + size;
+            }
+            if (pos < data.size())
+                std::filesystem::resize_file(tailFileName, pos);
+
+            // Records are in row-id order, the first one tells how many are stale
+            int64_t firstId = sealedRows;
+            Row row;
+            if (!offsets.empty())
+            {
+                uint32_t size = getRaw<uint32_t>(data.data());
+                if (!decode(data.substr(sizeof(uint32_t), size), firstId, row))
+                    throw std::runtime_error("❌ Corrupt record in " + tailFileName);
+            }
+            size_t stale = static_cast<size_t>(std::clamp<int64_t>(sealedRows - firstId, 0, offsets.size()));
+            tailOffsets.assign(offsets.begin() + stale, offsets.end());
+            tailSize = static_cast<int64_t>(pos);
+        }
+
+        bool readSegment(const SegmentMeta &segment, size_t position, uint32_t rows, ColumnData &out) const
+        {
+            std::string data(segment.size, '\0');
+            std::ifstream in(columnFileName(position), std::ios::binary);
+            in.seekg(static_cast<std::streamoff>(segment.offset));
+            if (!in.read(data.data(), data.size()))
+                return false;
+            pagesRead += (segment.size + PAGE_SIZE - 1) / PAGE_SIZE;
+            return decodeSegment(isIntColumn(*columns[position]), segment, data, rows, out);
+        }
+
+        // Decode the wanted columns of one sealed group, without holding the lock
+        void loadGroup(const RowGroupMeta &group, const std::vector<bool> &wanted, Batch &batch) const
+        {
+            batch.first = group.firstRow;
+            batch.end = group.firstRow + group.rowCount;
+            batch.sealed = true;
+            batch.pruned = false;
+            batch.state.assign(columns.size(), Batch::Column::SKIPPED);
+            batch.values.resize(columns.size());
+            for (size_t c = 0; c < columns.size(); ++c)
+            {
+                if (!wanted.empty() && (c >= wanted.size() || !wanted[c]))
+                    continue;
+                if (c >= group.segments.size())
+                {
+                    batch.state[c] = Batch::Column::ABSENT;
+                    continue;
+                }
+                if (!readSegment(group.segments[c], c, group.rowCount, batch.values[c]))
+                    throw std::runtime_error("❌ Corrupt segment of column '" + columns[c]->name + "' in " + columnFileName(c));
+                batch.state[c] = Batch::Column::LOADED;
+            }
+        }
+
+        // Copy tail records [from, to) into the batch, the caller holds the lock
+        void loadTailLocked(int64_t from, int64_t to, Batch &batch) const
+        {
+            batch.first = from;
+            batch.end = to;
+            batch.sealed = false;
+            batch.pruned = false;
+            batch.tail.clear();
+            batch.tailEnds.clear();
+            if (to <= from)
+                return;
+
+            size_t firstIndex = static_cast<size_t>(from - sealedRows);
+            size_t lastIndex = static_cast<size_t>(to - sealedRows);
+            int64_t start = tailOffsets[firstIndex];
+            int64_t end = lastIndex < tailOffsets.size() ? tailOffsets[lastIndex] : tailSize;
+            std::string data(static_cast<size_t>(end - start), '\0');
+            std::ifstream in(tailFileName, std::ios::binary);
+            in.seekg(start);
+            if (!in.read(data.data(), data.size()))
+                throw std::runtime_error("❌ Failed to read " + tailFileName);
+            pagesRead += (data.size() + PAGE_SIZE - 1) / PAGE_SIZE;
+
+            size_t pos = 0;
+            while (pos < data.size())
+            {
+                uint32_t size = getRaw<uint32_t>(data.data() + pos);
+                batch.tail.append(data, pos + sizeof(uint32_t), size);
+                batch.tailEnds.push_back(static_cast<uint32_t>(batch.tail.size()));
+                pos += sizeof(uint32_t) + size;
+            }
+        }
+
+        // Turn the tail into a row group with one segment per column. The
+        // metadata is replaced before the tail is emptied: after a crash in
+        // between, loadTail() finds the tail rows already sealed and drops them.
+        // Deleted rows are stored as NULLs. The lock is held.
+        void seal(const std::function<bool(int64_t)> &isDeleted)
+        {
+            Batch batch;
+            loadTailLocked(sealedRows, sealedRows + static_cast<int64_t>(tailOffsets.size()), batch);
+
+            std::vector<SegmentBuilder> builders;
+            builders.reserve(columns.size());
+            for (const auto &column : columns)
+                builders.emplace_back(isIntColumn(*column));
+
+            Row row;
+            std::string buffer;
+            uint32_t start = 0;
+            for (size_t i = 0; i < batch.tailEnds.size(); ++i)
+            {
+                int64_t rowId = batch.first + static_cast<int64_t>(i);
+                buffer.assign(batch.tail, start, batch.tailEnds[i] - start);
+                start = batch.tailEnds[i];
+                int64_t decodedId;
+                if (isDeleted(rowId) || !decode(buffer, decodedId, row))
+                    row.assign(columns.size(), nullptr);
+                for (size_t c = 0; c < columns.size(); ++c)
+                    builders[c].add(row[c]);
+            }
+
+            RowGroupMeta group;
+            group.firstRow = sealedRows;
+            group.rowCount = static_cast<uint32_t>(batch.tailEnds.size());
+            group.segments.resize(columns.size());
+            for (size_t c = 0; c < columns.size(); ++c)
+            {
+                SegmentMeta &meta = group.segments[c];
+                std::string segment = builders[c].finish(meta);
+                meta.offset = appendToFile(columnFileName(c), segment);
+                meta.size = static_cast<uint32_t>(segment.size());
+                if (!wantsBloomFilter(*columns[c]))
+                    continue;
+                std::string bloom = builders[c].bloomFilter(segment.size());
+                if (bloom.empty())
+                    continue;
+                meta.bloomOffset = appendToFile(bloomFileName(c), bloom);
+                meta.bloomSize = static_cast<uint32_t>(bloom.size());
+            }
+
+            groups.push_back(std::move(group));
+            try
+            {
+                saveGroups();
+            }
+            catch (...)
+            {
+                groups.pop_back();
+                throw;
+            }
+
+            sealedRows += groups.back().rowCount;
+            std::filesystem::resize_file(tailFileName, 0);
+            tailOffsets.clear();
+            tailSize = 0;
+            cachedGroup = SIZE_MAX;
+        }
+
+        // Probe the one block of a segment's Bloom filter `hash` maps to
+        bool bloomMayContain(const SegmentMeta &segment, size_t position, uint64_t hash) const
+        {
+            size_t blocks = segment.bloomSize / BLOOM_BLOCK;
+            char block[BLOOM_BLOCK];
+            std::ifstream in(bloomFileName(position), std::ios::binary);
+            in.seekg(static_cast<std::streamoff>(segment.bloomOffset + bloomBlockOf(hash, blocks) * BLOOM_BLOCK));
+            if (!in.read(block, sizeof(block)))
+                return true;
+            pagesRead++;
+            return bloomContains(block, hash);
+        }
+
+        // False when the zone map of some filtered column shows that no row of
+        // the group can pass, or its Bloom filter lacks an equality literal.
+        // An all-NULL segment passes no comparison. Zone maps go first, they
+        // cost no I/O.
+        bool groupMayMatch(const RowGroupMeta &group, const std::vector<ColumnFilter> &filters) const
+        {
+            for (const auto &filter : filters)
+            {
+                if (!filter.mayMatch || filter.column >= group.segments.size())
+                    continue;
+                const SegmentMeta &segment = group.segments[filter.column];
+                if (segment.nullCount == group.rowCount)
+                    return false;
+                if (!std::holds_alternative<std::nullptr_t>(segment.min) && !filter.mayMatch(segment.min, segment.max))
+                    return false;
+            }
+            for (const auto &filter : filters)
+            {
+                if (filter.column >= group.segments.size() || group.segments[filter.column].bloomSize == 0)
+                    continue;
+                uint64_t hash;
+                if (bloomHash(isIntColumn(*columns[filter.column]), filter.equals, hash) &&
+                    !bloomMayContain(group.segments[filter.column], filter.column, hash))
+                    return false;
+            }
+            return true;
+        }
+
+        size_t groupOf(int64_t rowId) const
+        {
+            auto it = std::upper_bound(groups.begin(), groups.end(), rowId, [](int64_t id, const RowGroupMeta &group)
+                                       { return id < group.firstRow; });
+            return static_cast<size_t>(it - groups.begin()) - 1;
+        }
+
+    public:
+        static constexpr int64_t PAGE_SIZE = 4096;
+
+        mutable std::atomic<uint64_t> pagesRead{0};
+
+        ColumnStore(const std::string &basePath, const std::vector<std::shared_ptr<TableGlobalColumnNode>> &columns,
+                    RowDecoder decode)
+            : tailFileName(basePath + ".tail"), groupsFileName(basePath + ".groups"), columnFilePrefix(basePath + ".c"),
+              bloomFilePrefix(basePath + ".b"),
+              columns(columns), decode(std::move(decode))
+        {
+            loadGroups();
+            loadTail();
+        }
+
+        ColumnStore(const ColumnStore &) = delete;
+        ColumnStore &operator=(const ColumnStore &) = delete;
+
+        int64_t rowCount() const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return sealedRows + static_cast<int64_t>(tailOffsets.size());
+        }
+
+        // Append an encoded row as the next row id. Once the tail holds a full
+        // group it is sealed, with deleted rows stored as NULLs.
+        void append(const std::string &encoded, const std::function<bool(int64_t)> &isDeleted)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::string record;
+            putRaw<uint32_t>(record, static_cast<uint32_t>(encoded.size()));
+            record += encoded;
+            std::ofstream out(tailFileName, std::ios::binary | std::ios::app);
+            if (!out.write(record.data(), record.size()))
+                throw std::runtime_error("❌ Failed to append to " + tailFileName);
+            out.close();
+            tailOffsets.push_back(tailSize);
+            tailSize += static_cast<int64_t>(record.size());
+
+            if (tailOffsets.size() >= ROW_GROUP_ROWS)
+                seal(isDeleted);
+        }
+
+        // Fill `batch` with the slice holding row `from`, false past the last
+        // row. A sealed group the filters rule out comes back pruned and unread.
+        bool loadBatch(int64_t from, const std::vector<bool> &wanted, Batch &batch,
+                       const std::vector<ColumnFilter> &filters = {}) const
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (from < sealedRows)
+            {
+                RowGroupMeta group = groups[groupOf(from)];
+                lock.unlock();
+                if (!groupMayMatch(group, filters))
+                {
+                    batch.first = group.firstRow;
+                    batch.end = group.firstRow + group.rowCount;
+                    batch.sealed = true;
+                    batch.pruned = true;
+                    batch.state.clear();
+                    return true;
+                }
+                loadGroup(group, wanted, batch);
+                return true;
+            }
+            int64_t end = sealedRows + static_cast<int64_t>(tailOffsets.size());
+            if (from >= end)
+                return false;
+            loadTailLocked(from, end, batch);
+            return true;
+        }
+
+        // Row `rowId` of a batch. Sealed rows get only the wanted columns.
+        bool rowOf(const Batch &batch, int64_t rowId, Row &row, std::string &buffer) const
+        {
+            size_t i = static_cast<size_t>(rowId - batch.first);
+            if (!batch.sealed)
+            {
+                uint32_t start = i == 0 ? 0 : batch.tailEnds[i - 1];
+                buffer.assign(batch.tail, start, batch.tailEnds[i] - start);
+                int64_t decodedId;
+                return decode(buffer, decodedId, row);
+            }
+            row.assign(batch.state.size(), nullptr);
+            for (size_t c = 0; c < batch.state.size(); ++c)
+            {
+                if (batch.state[c] == Batch::Column::LOADED)
+                    row[c] = batch.values[c].at(i);
+                else if (batch.state[c] == Batch::Column::ABSENT)
+                    row[c] = columns[c]->defaultValue;
+            }
+            return true;
+        }
+
+        // Point read by row id, for index lookups. The last sealed group read
+        // this way stays decoded, so lookups that land in it skip the files.
+        bool readRow(int64_t rowId, Row &row) const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::string buffer;
+            if (rowId < 0)
+                return false;
+            if (rowId >= sealedRows)
+            {
+                Batch batch;
+                if (rowId >= sealedRows + static_cast<int64_t>(tailOffsets.size()))
+                    return false;
+                loadTailLocked(rowId, rowId + 1, batch);
+                return rowOf(batch, rowId, row, buffer);
+            }
+            size_t group = groupOf(rowId);
+            if (group != cachedGroup || cached.state.size() != columns.size())
+            {
+                cachedGroup = SIZE_MAX;
+                loadGroup(groups[group], {}, cached);
+                cachedGroup = group;
+            }
+            return rowOf(cached, rowId, row, buffer);
+        }
+
+        // Resumable scan in row-id order over the columns in `wanted` (empty =
+        // all). Rows for which skip() is true are passed over without decoding.
+        // In sealed groups, rows failing one of the filters are dropped before
+        // the row is built. The caller still evaluates its own predicates.
+        class Scanner
+        {
+        private:
+            // A filter bound to the current batch
+            struct ActiveFilter
+            {
+                const ColumnFilter *filter;
+                std::vector<uint8_t> passingCodes; // dictionary segments: result per entry
+            };
+
+            const ColumnStore *store = nullptr;
+            std::vector<bool> wanted;
+            std::function<bool(int64_t)> skip;
+            std::vector<ColumnFilter> filters;
+            std::vector<ActiveFilter> active;
+            bool batchFails = false; // a filter on a column the group lacks rejects every row
+            Batch batch;
+            std::string buffer;
+            int64_t rowNum = 0, rowCount = 0;
+
+            void bindFilters()
+            {
+                active.clear();
+                batchFails = batch.pruned;
+                if (!batch.sealed || batch.pruned)
+                    return;
+                for (const auto &filter : filters)
+                {
+                    if (filter.column >= batch.state.size())
+                        continue;
+                    Batch::Column state = batch.state[filter.column];
+                    if (state == Batch::Column::ABSENT && !filter.test(store->columns[filter.column]->defaultValue))
+                        batchFails = true;
+                    if (state != Batch::Column::LOADED)
+                        continue;
+                    ActiveFilter bound{&filter, {}};
+                    const ColumnData &data = batch.values[filter.column];
+                    if (data.dictionary)
+                    {
+                        bound.passingCodes.resize(data.values.size());
+                        for (size_t code = 0; code < data.values.size(); ++code)
+                            bound.passingCodes[code] = filter.test(data.values[code]);
+                    }
+                    active.push_back(std::move(bound));
+                }
+            }
+
+            bool passes(size_t i) const
+            {
+                for (const auto &bound : active)
+                {
+                    const ColumnData &data = batch.values[bound.filter->column];
+                    if (data.dictionary ? !bound.passingCodes[data.codes[i]] : !bound.filter->test(data.values[i]))
+                        return false;
+                }
+                return true;
+            }
+
+        public:
+            Scanner() = default;
+
+            Scanner(const ColumnStore &store, std::vector<bool> wanted, std::function<bool(int64_t)> skip,
+                    std::vector<ColumnFilter> filters = {})
+                : store(&store), wanted(std::move(wanted)), skip(std::move(skip)), filters(std::move(filters)),
+                  rowCount(store.rowCount())
+            {
+            }
+
+            bool next(int64_t &rowId, Row &row)
+            {
+                while (rowNum < rowCount)
+                {
+                    if (rowNum >= batch.end || rowNum < batch.first)
+                    {
+                        if (!store->loadBatch(rowNum, wanted, batch, filters))
+                            break;
+                        bindFilters();
+                    }
+                    int64_t current = rowNum++;
+                    if (batchFails)
+                    {
+                        rowNum = std::min(rowCount, batch.end);
+                        continue;
+                    }
+                    if (skip && skip(current))
+                        continue;
+                    if (batch.sealed && !passes(static_cast<size_t>(current - batch.first)))
+                        continue;
+                    if (!store->rowOf(batch, current, row, buffer))
+                        continue;
+                    rowId = current;
+                    return true;
+                }
+                rowNum = rowCount;
+                return false;
+            }
+        };
+    };
+};
+
+#endif // __COLUMN_STORE
@@ -0,0 +1,165 @@
+#ifndef __COMPOSITE_INDEX
+#define __COMPOSITE_INDEX
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include "global.hpp"
+#include "rowStorage.hpp"
+
+// Multi-column indexes. A row's key is its key columns encoded as one byte
+// string that sorts like the tuple of values, so one string-keyed B+ tree or
+// ART serves any combination of columns:
+//   per column  0x00 for NULL (sorts first),
+//               0x01 then the INT as ArtKeyBytes<int> encodes it,
+//               0x02 then the text as ArtKeyBytes<std::string> encodes it
+//   suffix      the row's location start, 8 bytes big endian
+//   then        the INCLUDE columns, encoded like the key columns
+// The suffix makes every key unique, so rows that share their key columns
+// keep one entry each, and the rows with equal leading columns form one key
+// range. INCLUDE values come after it, so they never affect the order; they
+// let a scan that needs no other column answer from the keys alone.
+struct CompositeIndex
+{
+    IndexDefinition definition;
+    std::vector<uint32_t> columns;  // table positions of definition.columns
+    std::vector<uint32_t> included; // table positions of definition.include
+    TreeVariant tree;               // string keyed and ordered
+
+    bool covers(uint32_t position) const
+    {
+        return std::find(columns.begin(), columns.end(), position) != columns.end() ||
+               std::find(included.begin(), included.end(), position) != included.end();
+    }
+};
+
+namespace CompositeKey
+{
+    inline void appendField(std::string &out, const FieldValue &value)
+    {
+        std::string bytes;
+        if (const int *number = std::get_if<int>(&value))
+        {
+            out.push_back(1);
+            ArtKeyBytes<int>::encode(*number, bytes);
+        }
+        else if (const std::string *text = std::get_if<std::string>(&value))
+        {
+            out.push_back(2);
+            ArtKeyBytes<std::string>::encode(*text, bytes);
+        }
+        else
+        {
+            out.push_back(0);
+        }
+        out += bytes;
+    }
+
+    inline std::string encode(const Row &row, const CompositeIndex &index, const IndexNode &location)
+    {
+        std::string key;
+        for (uint32_t column : index.columns)
+            appendField(key, row[column]);
+        uint64_t start = static_cast<uint64_t>(location.start);
+        for (int shift = 56; shift >= 0; shift -= 8)
+            key.push_back(static_cast<char>(start >> shift));
+        for (uint32_t column : index.included)
+            appendField(key, row[column]);
+        return key;
+    }
+
+    // Inverse of appendField, false on a malformed field
+    inline bool readField(const char *&pos, const char *end, FieldValue &value)
+    {
+        if (pos == end)
+            return false;
+        char tag = *pos++;
+        if (tag == 0)
+        {
+            value = nullptr;
+            return true;
+        }
+        if (tag == 1)
+        {
+            if (end - pos < 4)
+                return false;
+            uint32_t bits = 0;
+            for (int i = 0; i < 4; ++i)
+                bits = bits << 8 | static_cast<uint8_t>(*pos++);
+            value = static_cast<int>(bits ^ 0x80000000u);
+            return true;
+        }
+        std::string text;
+        while (end - pos >= 2)
+        {
+            char c = *pos++;
+            if (c != 0)
+            {
+                text.push_back(c);
+                continue;
+            }
+            if (*pos++ == 0)
+            {
+                value = std::move(text);
+                return true;
+            }
+            text.push_back(0); // 0x00 0xFF
+        }
+        return false;
+    }
+
+    // The key and INCLUDE columns of a row back from its key, other positions are left alone
+    inline bool decode(const std::string &key, const CompositeIndex &index, Row &row)
+    {
+        const char *pos = key.data();
+        const char *end = pos + key.size();
+        for (uint32_t column : index.columns)
+        {
+            if (!readField(pos, end, row[column]))
+                return false;
+        }
+        if (end - pos < 8)
+            return false;
+        pos += 8;
+        for (uint32_t column : index.included)
+        {
+            if (!readField(pos, end, row[column]))
+                return false;
+        }
+        return pos == end;
+    }
+
+    // Smallest string above every string that starts with prefix, false when there is none
+    inline bool successor(std::string prefix, std::string &out)
+    {
+        while (!prefix.empty() && static_cast<uint8_t>(prefix.back()) == 0xFF)
+            prefix.pop_back();
+        if (prefix.empty())
+            return false;
+        prefix.back() = static_cast<char>(static_cast<uint8_t>(prefix.back()) + 1);
+        out = std::move(prefix);
+        return true;
+    }
+};
+
+// USING HASH cannot serve the key ranges a composite index is read by
+inline bool makeCompositeTree(IndexKind kind, TreeVariant &tree)
+{
+    if (kind == IndexKind::HASH)
+        return false;
+    makeIndexOfKind<std::string>(kind, tree);
+    return true;
+}
+
+inline void compositeInsert(const CompositeIndex &index, const Row &row, const IndexNode &location)
+{
+    indexInsert(index.tree, FieldValue(CompositeKey::encode(row, index, location)), location);
+}
+
+inline void compositeRemove(const CompositeIndex &index, const Row &row, const IndexNode &location)
+{
+    indexRemove(index.tree, FieldValue(CompositeKey::encode(row, index, location)));
+}
+
+#endif // __COMPOSITE_INDEX
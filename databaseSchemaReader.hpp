@@ -1,391 +1,523 @@
 #ifndef __DATABASE_SCHEMA_READER
 #define __DATABASE_SCHEMA_READER
-#include "json.hpp"
 #include <iostream>
-#include <stdexcept>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
 #include <vector>
+#include <optional>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <charconv>
+#include <stdexcept>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Read-only JSON for the schema, statistics and meta files, parsed in two passes:
+//   1. a structural scan finds every { } [ ] : , and string quote that is not
+//      inside a string, 16 bytes at a time (SSE2 compares, a byte loop without SSE2);
+//   2. a walk over those positions checks the grammar and writes a flat tape.
+// Strings are unescaped in place in the document's own copy of the input, so
+// every string on the tape is a string_view into that buffer. A JSONView is a
+// (document, tape slot) pair and is copied by value.
+
+enum class JSONType : uint8_t
+{
+    Null,
+    Bool,
+    Number,
+    String,
+    Array,
+    Object
+};
 
-// Forward declaration
-class JSONWrapper;
+class JSONView;
 
-// Helper class for array-like access
-class JSONArrayWrapper {
+class JSONDocument {
 private:
-    JSONParser::JSONArray arr;
-    
-public:
-    JSONArrayWrapper(const JSONParser::JSONArray& array) : arr(array) {}
-    
-    // Array access operator
-    JSONWrapper operator[](size_t index) const;
-    
-    // Get size
-    size_t size() const { return arr.size(); }
-    
-    // Iterator support
-    auto begin() const { return arr.begin(); }
-    auto end() const { return arr.end(); }
-    
-    // Convert to vector of strings (useful for constraints, etc.)
-    std::vector<std::string> toStringVector() const {
-        std::vector<std::string> result;
-        for (const auto& item : arr) {
-            if (std::holds_alternative<std::string>(item.value)) {
-                result.push_back(std::get<std::string>(item.value));
-            }
+    static constexpr size_t BLOCK = 16;
+    static constexpr int MAX_DEPTH = 1024;
+
+    struct TapeEntry {
+        JSONType type = JSONType::Null;
+        uint32_t next = 0;      // slot just past this value and all its children
+        uint32_t count = 0;     // arrays: elements, objects: members
+        std::string_view text;  // strings: unescaped text, scalars: the literal as written
+    };
+
+    std::string buffer;              // the input, padded to whole blocks
+    size_t length = 0;               // input bytes, without the padding
+    std::vector<uint32_t> index;     // offsets of structural characters and quotes
+    std::vector<TapeEntry> tape;     // values in document order, slot 0 is the root
+
+    friend class JSONView;
+
+    struct BlockMasks {
+        uint32_t quote;
+        uint32_t backslash;
+        uint32_t structural;
+    };
+
+    static BlockMasks classify(const char *block) {
+#ifdef __SSE2__
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block));
+        // '[' and ']' differ from '{' and '}' only in bit 0x20
+        __m128i folded = _mm_or_si128(bytes, _mm_set1_epi8(0x20));
+        auto match = [](__m128i v, char c) {
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(c))));
+        };
+        return {match(bytes, '"'), match(bytes, '\\'),
+                match(folded, '{') | match(folded, '}') | match(bytes, ':') | match(bytes, ',')};
+#else
+        BlockMasks masks{0, 0, 0};
+        for (size_t i = 0; i < BLOCK; ++i) {
+            char c = block[i];
+            if (c == '"') masks.quote |= 1u << i;
+            else if (c == '\\') masks.backslash |= 1u << i;
+            else if (c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',') masks.structural |= 1u << i;
         }
-        return result;
+        return masks;
+#endif
     }
-    
-    // Print all elements
-    void print() const {
-        std::cout << "[";
-        for (size_t i = 0; i < arr.size(); ++i) {
-            if (std::holds_alternative<std::string>(arr[i].value)) {
-                std::cout << "\"" << std::get<std::string>(arr[i].value) << "\"";
-            } else if (std::holds_alternative<int>(arr[i].value)) {
-                std::cout << std::get<int>(arr[i].value);
-            } else if (std::holds_alternative<double>(arr[i].value)) {
-                std::cout << std::get<double>(arr[i].value);
-            } else if (std::holds_alternative<bool>(arr[i].value)) {
-                std::cout << (std::get<bool>(arr[i].value) ? "true" : "false");
+
+    // Bit i set when an odd number of quotes is at or before position i
+    static uint32_t prefixXor(uint32_t bits) {
+        bits ^= bits << 1;
+        bits ^= bits << 2;
+        bits ^= bits << 4;
+        bits ^= bits << 8;
+        return bits & 0xFFFF;
+    }
+
+    // Pass 1: positions of structurals outside strings plus both quotes of every string
+    void scan() {
+        index.clear();
+        bool inString = false;
+        bool escapeNext = false; // the block ended in an odd run of backslashes
+        for (size_t base = 0; base < length; base += BLOCK) {
+            BlockMasks masks = classify(buffer.data() + base);
+
+            // Backslashes only occur inside strings, so most blocks skip this loop
+            uint32_t escaped = 0;
+            if (masks.backslash || escapeNext) {
+                for (size_t i = 0; i < BLOCK; ++i) {
+                    if (escapeNext) {
+                        escaped |= 1u << i;
+                        escapeNext = false;
+                    } else if (masks.backslash & (1u << i)) {
+                        escapeNext = true;
+                    }
+                }
+            }
+
+            uint32_t quotes = masks.quote & ~escaped;
+            uint32_t inside = prefixXor(quotes) ^ (inString ? 0xFFFFu : 0u);
+            inString = inside & 0x8000u;
+
+            uint32_t bits = (masks.structural & ~inside) | quotes;
+            while (bits) {
+                index.push_back(static_cast<uint32_t>(base + __builtin_ctz(bits)));
+                bits &= bits - 1;
             }
-            if (i < arr.size() - 1) std::cout << ", ";
         }
-        std::cout << "]";
+        if (inString) {
+            throw std::runtime_error("Unterminated string");
+        }
     }
-};
 
-// Main wrapper class
-class JSONWrapper {
-private:
-    JSONParser::JSONValue value;
-    
-public:
-    // Constructors
-    JSONWrapper(const JSONParser::JSONValue& val) : value(val) {}
-    JSONWrapper(const JSONParser::JSONObject& obj) : value(obj) {}
-    JSONWrapper(const JSONParser::JSONArray& arr) : value(arr) {}
-    
-    // Object access operator - returns another JSONWrapper
-    JSONWrapper operator[](const std::string& key) const {
-        if (std::holds_alternative<JSONParser::JSONObject>(value.value)) {
-            const auto& obj = std::get<JSONParser::JSONObject>(value.value);
-            auto it = obj.find(key);
-            if (it != obj.end()) {
-                return JSONWrapper(it->second);
-            }
-            throw std::runtime_error("Key '" + key + "' not found in object");
+    size_t skipWhitespace(size_t pos) const {
+        while (pos < length && (buffer[pos] == ' ' || buffer[pos] == '\n' || buffer[pos] == '\r' || buffer[pos] == '\t')) {
+            pos++;
         }
-        throw std::runtime_error("Cannot use string key on non-object type");
+        return pos;
     }
-    
-    // Array access operator - returns another JSONWrapper
-    JSONWrapper operator[](size_t index) const {
-        if (std::holds_alternative<JSONParser::JSONArray>(value.value)) {
-            const auto& arr = std::get<JSONParser::JSONArray>(value.value);
-            if (index >= arr.size()) {
-                throw std::runtime_error("Array index out of bounds");
-            }
-            return JSONWrapper(arr[index]);
+
+    // The structural at index[s] must sit at pos, with only whitespace before it
+    bool structuralAt(size_t s, size_t pos) const {
+        return s < index.size() && index[s] == pos;
+    }
+
+    static void appendUtf8(char *&out, uint32_t code) {
+        if (code < 0x80) {
+            *out++ = static_cast<char>(code);
+        } else if (code < 0x800) {
+            *out++ = static_cast<char>(0xC0 | (code >> 6));
+            *out++ = static_cast<char>(0x80 | (code & 0x3F));
+        } else if (code < 0x10000) {
+            *out++ = static_cast<char>(0xE0 | (code >> 12));
+            *out++ = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            *out++ = static_cast<char>(0x80 | (code & 0x3F));
+        } else {
+            *out++ = static_cast<char>(0xF0 | (code >> 18));
+            *out++ = static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            *out++ = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            *out++ = static_cast<char>(0x80 | (code & 0x3F));
         }
-        throw std::runtime_error("Cannot use numeric index on non-array type");
     }
-    
-    // Conversion operators
-    operator std::string() const {
-        if (std::holds_alternative<std::string>(value.value)) {
-            return std::get<std::string>(value.value);
+
+    static uint32_t hex4(const char *p, const char *end) {
+        if (end - p < 4) {
+            throw std::runtime_error("Invalid \\u escape");
         }
-        throw std::runtime_error("Cannot convert to string");
+        uint32_t code = 0;
+        auto result = std::from_chars(p, p + 4, code, 16);
+        if (result.ptr != p + 4) {
+            throw std::runtime_error("Invalid \\u escape");
+        }
+        return code;
     }
-    
-    operator int() const {
-        if (std::holds_alternative<int>(value.value)) {
-            return std::get<int>(value.value);
+
+    // Decodes escapes in place, the output is never longer than the input
+    std::string_view unescape(char *begin, char *end) {
+        char *out = begin;
+        for (char *in = begin; in < end; ++in) {
+            if (*in != '\\') {
+                *out++ = *in;
+                continue;
+            }
+            ++in; // pass 1 guarantees a character follows
+            switch (*in) {
+                case 'b': *out++ = '\b'; break;
+                case 'f': *out++ = '\f'; break;
+                case 'n': *out++ = '\n'; break;
+                case 'r': *out++ = '\r'; break;
+                case 't': *out++ = '\t'; break;
+                case 'u': {
+                    uint32_t code = hex4(in + 1, end);
+                    in += 4;
+                    if (code >= 0xD800 && code < 0xDC00 && end - in > 6 && in[1] == '\\' && in[2] == 'u') {
+                        uint32_t low = hex4(in + 3, end);
+                        if (low >= 0xDC00 && low < 0xE000) {
+                            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                            in += 6;
+                        }
+                    }
+                    appendUtf8(out, code);
+                    break;
+                }
+                default: *out++ = *in; break; // \" \\ \/
+            }
         }
-        throw std::runtime_error("Cannot convert to int");
+        return std::string_view(begin, static_cast<size_t>(out - begin));
     }
-    
-    operator double() const {
-        if (std::holds_alternative<double>(value.value)) {
-            return std::get<double>(value.value);
+
+    static bool isNumber(std::string_view text) {
+        size_t i = 0;
+        auto digits = [&] {
+            size_t start = i;
+            while (i < text.size() && text[i] >= '0' && text[i] <= '9') i++;
+            return i > start;
+        };
+        if (i < text.size() && text[i] == '-') i++;
+        if (!digits()) return false;
+        if (i < text.size() && text[i] == '.') {
+            i++;
+            if (!digits()) return false;
+        }
+        if (i < text.size() && (text[i] == 'e' || text[i] == 'E')) {
+            i++;
+            if (i < text.size() && (text[i] == '+' || text[i] == '-')) i++;
+            if (!digits()) return false;
         }
-        throw std::runtime_error("Cannot convert to double");
+        return i == text.size();
     }
-    
-    operator bool() const {
-        if (std::holds_alternative<bool>(value.value)) {
-            return std::get<bool>(value.value);
+
+    // Pass 2: one value starting at byte pos, returns the byte just past it
+    size_t parseValue(size_t &s, size_t pos, int depth) {
+        pos = skipWhitespace(pos);
+        if (pos >= length) {
+            throw std::runtime_error("Unexpected end of JSON");
         }
-        throw std::runtime_error("Cannot convert to bool");
+        uint32_t slot = static_cast<uint32_t>(tape.size());
+        tape.emplace_back();
+
+        size_t end;
+        if (structuralAt(s, pos)) {
+            char c = buffer[pos];
+            if (c == '"') {
+                size_t close = index[s + 1]; // pass 1 pairs every opening quote with its closing one
+                s += 2;
+                tape[slot].type = JSONType::String;
+                tape[slot].text = unescape(&buffer[pos + 1], &buffer[close]);
+                end = close + 1;
+            } else if (c == '{' || c == '[') {
+                if (depth >= MAX_DEPTH) {
+                    throw std::runtime_error("JSON nested too deeply");
+                }
+                end = parseContainer(s, slot, pos, depth);
+            } else {
+                throw std::runtime_error("Invalid JSON character: " + std::string(1, c));
+            }
+        } else {
+            // A scalar runs up to the next structural (or the end of the input)
+            end = s < index.size() ? index[s] : length;
+            size_t last = end;
+            while (last > pos && (buffer[last - 1] == ' ' || buffer[last - 1] == '\n' ||
+                                  buffer[last - 1] == '\r' || buffer[last - 1] == '\t')) {
+                last--;
+            }
+            std::string_view text(buffer.data() + pos, last - pos);
+            if (text == "true" || text == "false") {
+                tape[slot].type = JSONType::Bool;
+            } else if (text == "null") {
+                tape[slot].type = JSONType::Null;
+            } else if (isNumber(text)) {
+                tape[slot].type = JSONType::Number;
+            } else {
+                throw std::runtime_error("Invalid JSON value: " + std::string(text));
+            }
+            tape[slot].text = text;
+            end = last;
+        }
+        tape[slot].next = static_cast<uint32_t>(tape.size());
+        return end;
     }
-    
-    // Get as array wrapper
-    JSONArrayWrapper asArray() const {
-        if (std::holds_alternative<JSONParser::JSONArray>(value.value)) {
-            return JSONArrayWrapper(std::get<JSONParser::JSONArray>(value.value));
+
+    size_t parseContainer(size_t &s, uint32_t slot, size_t pos, int depth) {
+        bool isObject = buffer[pos] == '{';
+        char closer = isObject ? '}' : ']';
+        tape[slot].type = isObject ? JSONType::Object : JSONType::Array;
+        s++;
+
+        size_t after = skipWhitespace(pos + 1);
+        if (structuralAt(s, after) && buffer[after] == closer) {
+            s++;
+            return after + 1;
+        }
+
+        after = pos + 1;
+        while (true) {
+            if (isObject) {
+                size_t key = skipWhitespace(after);
+                if (!structuralAt(s, key) || buffer[key] != '"') {
+                    throw std::runtime_error("Expected string key in object");
+                }
+                after = parseValue(s, key, depth + 1);
+                size_t colon = skipWhitespace(after);
+                if (!structuralAt(s, colon) || buffer[colon] != ':') {
+                    throw std::runtime_error("Expected ':' after key");
+                }
+                s++;
+                after = colon + 1;
+            }
+            after = parseValue(s, after, depth + 1);
+            tape[slot].count++;
+
+            size_t next = skipWhitespace(after);
+            if (!structuralAt(s, next)) {
+                throw std::runtime_error(isObject ? "Expected ',' or '}' in object" : "Expected ',' or ']' in array");
+            }
+            s++;
+            if (buffer[next] == closer) {
+                return next + 1;
+            }
+            if (buffer[next] != ',') {
+                throw std::runtime_error(isObject ? "Expected ',' or '}' in object" : "Expected ',' or ']' in array");
+            }
+            after = next + 1;
         }
-        throw std::runtime_error("Value is not an array");
     }
-    
-    // Helper methods
-    bool isString() const { return std::holds_alternative<std::string>(value.value); }
-    bool isInt() const { return std::holds_alternative<int>(value.value); }
-    bool isDouble() const { return std::holds_alternative<double>(value.value); }
-    bool isBool() const { return std::holds_alternative<bool>(value.value); }
-    bool isArray() const { return std::holds_alternative<JSONParser::JSONArray>(value.value); }
-    bool isObject() const { return std::holds_alternative<JSONParser::JSONObject>(value.value); }
-    bool isNull() const { return std::holds_alternative<std::nullptr_t>(value.value); }
-    
-    // Get string value (safe)
-    std::string getString() const {
-        if (isString()) return std::get<std::string>(value.value);
-        return "";
+
+public:
+    JSONDocument() = default;
+    JSONDocument(const JSONDocument &) = delete; // views point into the buffer
+    JSONDocument &operator=(const JSONDocument &) = delete;
+
+    // Throws std::runtime_error on malformed input
+    void parse(std::string text) {
+        buffer = std::move(text);
+        length = buffer.size();
+        buffer.append(BLOCK - length % BLOCK, ' ');
+        tape.clear();
+
+        scan();
+        tape.reserve(index.size() / 2 + 1);
+        size_t s = 0;
+        size_t end = parseValue(s, 0, 0);
+        if (skipWhitespace(end) != length || s != index.size()) {
+            throw std::runtime_error("Unexpected data after JSON value");
+        }
     }
-    
-    // Get int value (safe)
-    int getInt() const {
-        if (isInt()) return std::get<int>(value.value);
-        return 0;
+
+    bool loadFromFile(const std::string &path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Error: Cannot open file for reading: " << path << std::endl;
+            return false;
+        }
+        std::stringstream contents;
+        contents << file.rdbuf();
+        try {
+            parse(contents.str());
+            return true;
+        } catch (const std::exception &e) {
+            std::cerr << "Error loading from file: " << path << ": " << e.what() << std::endl;
+            return false;
+        }
     }
-    
-    // Get double value (safe)
-    double getDouble() const {
-        if (isDouble()) return std::get<double>(value.value);
-        return 0.0;
+
+    JSONView root() const;
+};
+
+// A value inside a JSONDocument. Valid while the document lives.
+class JSONView {
+private:
+    const JSONDocument *document = nullptr;
+    uint32_t slot = 0;
+
+    const JSONDocument::TapeEntry &entry() const { return document->tape[slot]; }
+
+public:
+    JSONView() = default;
+    JSONView(const JSONDocument *document, uint32_t slot) : document(document), slot(slot) {}
+
+    JSONType type() const { return entry().type; }
+    bool isNull() const { return type() == JSONType::Null; }
+    bool isBool() const { return type() == JSONType::Bool; }
+    bool isNumber() const { return type() == JSONType::Number; }
+    bool isString() const { return type() == JSONType::String; }
+    bool isArray() const { return type() == JSONType::Array; }
+    bool isObject() const { return type() == JSONType::Object; }
+
+    // Numbers written without a fraction or exponent
+    bool isInt() const {
+        return isNumber() && entry().text.find_first_of(".eE") == std::string_view::npos;
     }
-    
-    // Get bool value (safe)
-    bool getBool() const {
-        if (isBool()) return std::get<bool>(value.value);
-        return false;
+
+    // Elements of an array or members of an object, 0 for scalars
+    size_t size() const { return entry().count; }
+
+    // Safe getters: the zero value when the type does not match
+    std::string_view getString() const { return isString() ? entry().text : std::string_view(); }
+
+    bool getBool() const { return isBool() && entry().text == "true"; }
+
+    int getInt() const {
+        if (!isNumber()) return 0;
+        std::string_view text = entry().text;
+        int value = 0;
+        auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (result.ptr != text.data() + text.size()) {
+            return static_cast<int>(getDouble());
+        }
+        return value;
     }
-    
-    // Get array size
-    size_t size() const {
-        if (isArray()) {
-            return std::get<JSONParser::JSONArray>(value.value).size();
+
+    // The literal is followed by a delimiter in the buffer, so strtod stops at its end
+    double getDouble() const { return isNumber() ? std::strtod(entry().text.data(), nullptr) : 0.0; }
+
+    template <bool Members>
+    class Range {
+    private:
+        const JSONDocument *document;
+        uint32_t first, last;
+
+    public:
+        class Iterator {
+        private:
+            const JSONDocument *document;
+            uint32_t slot;
+
+        public:
+            Iterator(const JSONDocument *document, uint32_t slot) : document(document), slot(slot) {}
+
+            auto operator*() const {
+                if constexpr (Members) {
+                    return std::pair<std::string_view, JSONView>(document->tape[slot].text, JSONView(document, slot + 1));
+                } else {
+                    return JSONView(document, slot);
+                }
+            }
+
+            Iterator &operator++() {
+                slot = Members ? document->tape[slot + 1].next : document->tape[slot].next;
+                return *this;
+            }
+
+            bool operator!=(const Iterator &other) const { return slot != other.slot; }
+        };
+
+        Range(const JSONDocument *document, uint32_t first, uint32_t last) : document(document), first(first), last(last) {}
+        Iterator begin() const { return Iterator(document, first); }
+        Iterator end() const { return Iterator(document, last); }
+    };
+
+    // for (JSONView element : array.elements())
+    Range<false> elements() const {
+        if (!isArray()) {
+            throw std::runtime_error("Value is not an array");
         }
-        return 0;
+        return Range<false>(document, slot + 1, entry().next);
     }
-    
-    // Check if key exists (for objects)
-    bool hasKey(const std::string& key) const {
-        if (isObject()) {
-            const auto& obj = std::get<JSONParser::JSONObject>(value.value);
-            return obj.find(key) != obj.end();
+
+    // for (auto [key, value] : object.members())
+    Range<true> members() const {
+        if (!isObject()) {
+            throw std::runtime_error("Value is not an object");
         }
-        return false;
+        return Range<true>(document, slot + 1, entry().next);
     }
-    
-    // Get all keys (for objects)
-    std::vector<std::string> getKeys() const {
-        std::vector<std::string> keys;
-        if (isObject()) {
-            const auto& obj = std::get<JSONParser::JSONObject>(value.value);
-            for (const auto& pair : obj) {
-                keys.push_back(pair.first);
+
+    std::optional<JSONView> find(std::string_view key) const {
+        if (!isObject()) {
+            return std::nullopt;
+        }
+        for (auto member : members()) {
+            if (member.first == key) {
+                return member.second;
             }
         }
-        return keys;
+        return std::nullopt;
     }
-    
-    // Print value
-    void print() const {
-        if (isString()) {
-            std::cout << "\"" << getString() << "\"";
-        } else if (isInt()) {
-            std::cout << getInt();
-        } else if (isDouble()) {
-            std::cout << getDouble();
-        } else if (isBool()) {
-            std::cout << (getBool() ? "true" : "false");
-        } else if (isArray()) {
-            asArray().print();
-        } else if (isNull()) {
-            std::cout << "null";
-        } else {
-            std::cout << "{object}";
+
+    bool hasKey(std::string_view key) const { return find(key).has_value(); }
+
+    JSONView operator[](std::string_view key) const {
+        if (!isObject()) {
+            throw std::runtime_error("Cannot use string key on non-object type");
         }
+        if (auto value = find(key)) {
+            return *value;
+        }
+        throw std::runtime_error("Key '" + std::string(key) + "' not found in object");
     }
-};
 
-// Implementation of JSONArrayWrapper::operator[]
-JSONWrapper JSONArrayWrapper::operator[](size_t index) const {
-    if (index >= arr.size()) {
-        throw std::runtime_error("Array index out of bounds");
+    // Walks the siblings, prefer elements() for a full pass
+    JSONView operator[](size_t position) const {
+        if (!isArray()) {
+            throw std::runtime_error("Cannot use numeric index on non-array type");
+        }
+        if (position >= size()) {
+            throw std::runtime_error("Array index out of bounds");
+        }
+        uint32_t at = slot + 1;
+        while (position--) {
+            at = document->tape[at].next;
+        }
+        return JSONView(document, at);
     }
-    return JSONWrapper(arr[index]);
-}
 
-// Main wrapper class for the parser
-class PythonLikeJSONParser {
-private:
-    JSONParser parser;
-    
-public:
-    PythonLikeJSONParser() {}
-    
-    // Load from string
-    bool loadFromString(const std::string& jsonStr) {
-        return parser.appendFromString(jsonStr);
-    }
-    
-    // Load from file
-    bool loadFromFile(const std::string& filePath) {
-        return parser.loadFromFile(filePath);
-    }
-    
-    // Array-like access to root elements
-    JSONWrapper operator[](size_t index) const {
-        if (index >= parser.size()) {
-            throw std::runtime_error("Index out of bounds");
+    // The string elements of an array (constraints and the like)
+    std::vector<std::string> toStringVector() const {
+        std::vector<std::string> result;
+        result.reserve(size());
+        for (JSONView element : elements()) {
+            if (element.isString()) {
+                result.emplace_back(element.getString());
+            }
         }
-        return JSONWrapper(parser.getObject(index));
-    }
-    
-    // Get size
-    size_t size() const {
-        return parser.size();
-    }
-    
-    // Get underlying parser
-    const JSONParser& getParser() const {
-        return parser;
+        return result;
     }
 };
 
-// // Example usage
-// int main() {
-//     PythonLikeJSONParser parser;
-    
-//     // Your JSON data
-//     std::string jsonData = R"([
-//  {
-// "name": "testing",
-// "tables": [
-//  {
-// "columns": [
-//  {
-// "constraints": [
-// "primary_key",
-// "auto_increment"
-//  ],
-// "name": "id",
-// "type": "int"
-//  },
-//  {
-// "constraints": [],
-// "length": 100,
-// "name": "name",
-// "type": "varchar"
-//  },
-//  {
-// "constraints": [
-// "unique"
-//  ],
-// "length": 100,
-// "name": "email",
-// "type": "varchar"
-//  },
-//  {
-// "constraints": [],
-// "name": "age",
-// "type": "int"
-//  },
-//  {
-// "constraints": [],
-// "length": 100,
-// "name": "department",
-// "type": "varchar"
-//  },
-//  {
-// "constraints": [],
-// "name": "year",
-// "type": "int"
-//  }
-//  ],
-// "name": "students"
-//  }
-//  ]
-//  }
-// ])";
-    
-//     if (parser.loadFromString(jsonData)) {
-//         std::cout << "=== Python-like JSON Access Demo ===" << std::endl;
-        
-//         // Access database name - parser[0]["name"]
-//         std::cout << "\nDatabase name: ";
-//         parser[0]["name"].print();
-//         std::cout << std::endl;
-        
-//         // Or get as string
-//         std::string dbName = parser[0]["name"];
-//         std::cout << "Database name (as string): " << dbName << std::endl;
-        
-//         // Access table name - parser[0]["tables"][0]["name"]
-//         std::cout << "\nTable name: ";
-//         parser[0]["tables"][0]["name"].print();
-//         std::cout << std::endl;
-        
-//         // Get all columns - parser[0]["tables"][0]["columns"]
-//         std::cout << "\nAll columns:" << std::endl;
-//         JSONArrayWrapper columns = parser[0]["tables"][0]["columns"].asArray();
-        
-//         for (size_t i = 0; i < columns.size(); ++i) {
-//             JSONWrapper column = columns[i];
-//             std::cout << "Column " << i << ": ";
-//             std::cout << "name=" << column["name"].getString();
-//             std::cout << ", type=" << column["type"].getString();
-            
-//             // Check if length exists
-//             if (column.hasKey("length")) {
-//                 std::cout << ", length=" << column["length"].getInt();
-//             }
-            
-//             // Get constraints
-//             if (column.hasKey("constraints")) {
-//                 JSONArrayWrapper constraints = column["constraints"].asArray();
-//                 if (constraints.size() > 0) {
-//                     std::cout << ", constraints=";
-//                     constraints.print();
-//                 }
-//             }
-//             std::cout << std::endl;
-//         }
-        
-//         // Access specific column by index - parser[0]["tables"][0]["columns"][2]
-//         std::cout << "\nEmail column (index 2):" << std::endl;
-//         JSONWrapper emailColumn = parser[0]["tables"][0]["columns"][2];
-//         std::cout << "Name: " << emailColumn["name"].getString() << std::endl;
-//         std::cout << "Type: " << emailColumn["type"].getString() << std::endl;
-//         std::cout << "Length: " << emailColumn["length"].getInt() << std::endl;
-//         std::cout << "Constraints: ";
-//         emailColumn["constraints"].asArray().print();
-//         std::cout << std::endl;
-        
-//         // More examples
-//         std::cout << "\n=== More Examples ===" << std::endl;
-        
-//         // Get all column names
-//         std::cout << "\nAll column names:" << std::endl;
-//         for (size_t i = 0; i < columns.size(); ++i) {
-//             std::cout << "- " << columns[i]["name"].getString() << std::endl;
-//         }
-        
-//         // Get constraints for specific column
-//         std::cout << "\nConstraints for 'id' column:" << std::endl;
-//         JSONArrayWrapper idConstraints = parser[0]["tables"][0]["columns"][0]["constraints"].asArray();
-//         std::vector<std::string> constraintsList = idConstraints.toStringVector();
-//         for (const auto& constraint : constraintsList) {
-//             std::cout << "- " << constraint << std::endl;
-//         }
-        
-//     } else {
-//         std::cout << "Failed to load JSON data!" << std::endl;
-//     }
-    
-//     return 0;
-// }
-#endif
\ No newline at end of file
+inline JSONView JSONDocument::root() const {
+    if (tape.empty()) {
+        throw std::runtime_error("Document is empty");
+    }
+    return JSONView(this, 0);
+}
+
+#endif
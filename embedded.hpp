@@ -0,0 +1,58 @@
+#ifndef __EMBEDDED
+#define __EMBEDDED
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <stdexcept>
+#include "SQL_LEXER.hpp"
+#include "SQL_PARSER.hpp"
+#include "queryExecutor.hpp"
+
+// In-process access to query results for code linking the engine directly.
+// Rows are pulled through the same QueryExecutor::Cursor the shell uses.
+namespace Embedded
+{
+    // A parsed SELECT and its open cursor. The cursor points into the
+    // statement, so both live and die together.
+    class Query
+    {
+    private:
+        std::unique_ptr<SelectStatement> stmt;
+        QueryExecutor::Cursor cursor;
+
+    public:
+        explicit Query(const std::string &sql)
+        {
+            Lexer lexer(sql);
+            std::vector<Token *> tokens = lexer.tokenize();
+            Parser parser(tokens);
+            stmt = parser.parseSelectStatement();
+            cursor = QueryExecutor::Cursor(*stmt);
+        }
+
+        const std::vector<std::string> &columns() const
+        {
+            return cursor.columns();
+        }
+
+        // Up to n rows into batch, 0 once every row has been fetched
+        size_t fetch(QueryExecutor::RowBatch &batch, size_t n)
+        {
+            return cursor.fetch(batch, n);
+        }
+
+        // Every remaining row as one JSON document, see QueryExecutor::writeCursorJSON
+        void writeJSON(JSONWriter &writer)
+        {
+            QueryExecutor::writeCursorJSON(cursor, writer);
+        }
+
+        void close()
+        {
+            cursor.close();
+        }
+    };
+};
+
+#endif // __EMBEDDED
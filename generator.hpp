@@ -14,137 +14,502 @@
 #include "utility.hpp"
 #include "global.hpp"
 #include "SQL_PARSER.hpp"
+#include "rowStorage.hpp"
+#include "catalog.hpp"
+#include "catalogFile.hpp"
+#include "queryExecutor.hpp"
+#include "vacuum.hpp"
 
 namespace CommandRunner
 {
 
+    // Convert a literal or evaluated value to the type of the column it is stored in
+    FieldValue toColumnValue(const TableGlobalColumnNode &column, const FieldValue &value)
+    {
+        if (std::holds_alternative<std::nullptr_t>(value))
+            return value;
+        if (!isIntColumn(column))
+            return fieldToString(value);
+        if (std::holds_alternative<int>(value))
+            return value;
+        try
+        {
+            return std::stoi(std::get<std::string>(value));
+        }
+        catch (...)
+        {
+            throw std::runtime_error("❌ Column '" + column.name + "' expects an INT value");
+        }
+    }
+
+    // Schema node for a column definition of CREATE TABLE or ALTER TABLE ADD COLUMN
+    std::shared_ptr<TableGlobalColumnNode> makeColumnNode(const ColumnDefinition &definition)
+    {
+        auto node = std::make_shared<TableGlobalColumnNode>();
+        node->name = definition.name;
+        node->type = definition.type;
+
+        // varchar(255) is stored as type varchar with length 255
+        size_t paren = definition.type.find('(');
+        if (paren != std::string::npos)
+        {
+            node->type = definition.type.substr(0, paren);
+            try
+            {
+                node->length = std::stoi(definition.type.substr(paren + 1));
+            }
+            catch (...)
+            {
+                throw std::runtime_error("Invalid VARCHAR length");
+            }
+        }
+
+        for (const auto &c : definition.constraints)
+        {
+            switch (c)
+            {
+            case ColumnConstraint::NOT_NULL:
+                node->constraint.push_back("not_null");
+                break;
+            case ColumnConstraint::PRIMARY_KEY:
+                node->constraint.push_back("primary_key");
+                node->isPrimary = true;
+                break;
+            case ColumnConstraint::UNIQUE:
+                node->constraint.push_back("unique");
+                node->isUnique = true;
+                break;
+            case ColumnConstraint::AUTO_INCREMENT:
+                node->constraint.push_back("auto_increment");
+                node->autoIncrement = true;
+                break;
+            default:
+                break;
+            }
+        }
+
+        node->defaultValue = toColumnValue(*node, definition.defaultValue);
+        return node;
+    }
+
     void generateCreateTableStatement(const std::unique_ptr<CreateStatement> &stmt)
     {
-        // Step 1: Convert column definitions to JSON
-        JSONParser::JSONArray columnArray;
+        if (!Catalog::current()->database(currentDatabase))
+        {
+            throw std::runtime_error("❌ Database '" + currentDatabase + "' does not exist");
+        }
 
+        std::vector<std::shared_ptr<TableGlobalColumnNode>> columnNodes;
         for (const auto &col : stmt->columns)
         {
-            JSONParser::JSONObject colJson = {
-                {"name", JSONParser::JSONValue(col.name)},
-                {"type", JSONParser::JSONValue(col.type)}};
+            columnNodes.push_back(makeColumnNode(col));
+        }
+
+        // One appended log record, however many tables the database already has.
+        // The JSON file and the binary catalog catch up at the next checkpoint.
+        CatalogFile::createTable(currentDatabase, stmt->name, std::move(columnNodes), stmt->engine);
+        Statistics::forgetStatistics(currentDatabase, stmt->name);
+
+        std::cout << "✅ Table '" << stmt->name << "' added to DB '" << currentDatabase << "' successfully.\n";
+        std::string tablename = stmt->name;
+        std::stringstream indexFile, dataFile;
+
+        indexFile << tableDirectory << "/" << currentDatabase <<"/"<< tablename << ".index";
+        dataFile << tableDirectory << "/" << currentDatabase <<"/"<< tablename << ".data";
+
+        MyUtility::createFile(indexFile.str(),"");
+        MyUtility::createFile(dataFile.str(),"");
+    }
 
-            // Extract length if it's a VARCHAR with size, e.g., varchar(255)
-            if (col.type.find("varchar(") != std::string::npos)
+
+    // ALTER TABLE ADD COLUMN only changes the catalog. Stored rows keep the
+    // schema version they were written with and read the new column as its
+    // default, so the statement takes the same time for any table size.
+    void generateAlterStatement(const std::unique_ptr<AlterStatement> &stmt)
+    {
+        auto column = makeColumnNode(stmt->column);
+        if (column->isPrimary || column->isUnique || column->autoIncrement)
+        {
+            throw std::runtime_error("❌ ALTER TABLE ADD COLUMN does not support PRIMARY KEY, UNIQUE or AUTO_INCREMENT");
+        }
+        if (isNotNullColumn(*column) && std::holds_alternative<std::nullptr_t>(column->defaultValue))
+        {
+            throw std::runtime_error("❌ Column '" + column->name + "' is NOT NULL and needs a non-NULL DEFAULT");
+        }
+
+        CatalogFile::addColumn(currentDatabase, stmt->table, column);
+        Statistics::forgetStatistics(currentDatabase, stmt->table);
+
+        std::cout << "✅ Column '" << column->name << "' added to table '" << stmt->table << "'\n";
+    }
+
+    // CREATE INDEX builds the index from the stored rows before it is published.
+    // Indexes keep one location per key, so lookups only use them on PRIMARY
+    // KEY and UNIQUE columns; USING HASH serves those lookups without the
+    // key comparisons of a tree descent, but not ranges or ORDER BY. USING ART
+    // branches on key bytes and serves everything a B+ tree does.
+    void generateCreateIndexStatement(const std::unique_ptr<CreateIndexStatement> &stmt)
+    {
+        const char *kind = stmt->kind == IndexKind::HASH ? "Hash" : stmt->kind == IndexKind::ART ? "Radix tree" : "B+ tree";
+        // A primary or unique column already has an index holding one row per
+        // key, CREATE INDEX only changes its kind
+        auto table = Catalog::requireTable(currentDatabase, stmt->table);
+        Catalog::ColumnId position = stmt->columns.size() == 1 ? table->column(stmt->columns[0]) : Catalog::INVALID_ID;
+        bool unique = position != Catalog::INVALID_ID && (table->columns[position]->isPrimary || table->columns[position]->isUnique);
+        if (unique && stmt->include.empty())
+        {
+            CatalogFile::createIndex(currentDatabase, stmt->table, stmt->columns[0], stmt->kind);
+            std::cout << "✅ " << kind << " index on '" << stmt->table << "." << stmt->columns[0] << "' created\n";
+            return;
+        }
+
+        // Other columns may repeat, a composite index keeps a location per key.
+        // It is named <table>_<columns>_idx unless given a name.
+        IndexDefinition index{stmt->name, stmt->columns, stmt->kind, stmt->include};
+        if (index.name.empty())
+        {
+            index.name = stmt->table;
+            for (const auto &column : stmt->columns)
+                index.name += "_" + column;
+            index.name += "_idx";
+        }
+        CatalogFile::addIndex(currentDatabase, stmt->table, index);
+        std::cout << "✅ " << kind << " index '" << index.name << "' on " << stmt->table << "(";
+        for (size_t i = 0; i < stmt->columns.size(); ++i)
+            std::cout << (i ? ", " : "") << stmt->columns[i];
+        std::cout << ")";
+        for (size_t i = 0; i < stmt->include.size(); ++i)
+            std::cout << (i ? ", " : " include (") << stmt->include[i];
+        std::cout << (stmt->include.empty() ? "" : ")") << " created\n";
+    }
+
+    std::runtime_error duplicateKeyError(const TableGlobalColumnNode &column, const FieldValue &value)
+    {
+        return std::runtime_error("❌ Duplicate value '" + fieldToString(value) + "' for " +
+                                  (column.isPrimary ? "primary key '" : "unique column '") + column.name + "'");
+    }
+
+    // Remove key -> location from an index unless the key now belongs to another row
+    void removeIndexEntry(const TreeVariant &index, const FieldValue &key, const IndexNode &location)
+    {
+        IndexNode current;
+        if (indexSearch(index, key, current) && current.start == location.start)
+        {
+            indexRemove(index, key);
+        }
+    }
+
+    void generateInsertStatement(const std::unique_ptr<InsertStatement> &stmt)
+    {
+        if (stmt->columns.size() != stmt->values.size())
+        {
+            throw std::runtime_error("❌ Column count does not match value count");
+        }
+
+        auto [table, statement] = Catalog::lockTable(currentDatabase, stmt->tableName);
+        auto storage = table->storage();
+        const auto &columns = storage->getColumns();
+
+        // Step 1: Convert values to the column types, unspecified columns take their default
+        Row row;
+        row.reserve(columns.size());
+        for (const auto &column : columns)
+            row.push_back(column->defaultValue);
+        for (size_t i = 0; i < stmt->columns.size(); ++i)
+        {
+            int position = storage->columnPosition(stmt->columns[i]);
+            if (position < 0)
             {
-                size_t start = col.type.find("(") + 1;
-                size_t end = col.type.find(")");
-                if (start != std::string::npos && end != std::string::npos && end > start)
-                {
-                    std::string lengthStr = col.type.substr(start, end - start);
-                    try
-                    {
-                        int length = std::stoi(lengthStr);
-                        colJson["length"] = JSONParser::JSONValue(length);
-                        colJson["type"] = JSONParser::JSONValue("varchar"); // strip size from type
-                    }
-                    catch (...)
-                    {
-                        throw std::runtime_error("Invalid VARCHAR length");
-                    }
-                }
+                throw std::runtime_error("❌ Unknown column '" + stmt->columns[i] + "' in table '" + stmt->tableName + "'");
             }
+            row[position] = toColumnValue(*columns[position], stmt->values[i]);
+        }
+
+        // Step 2: Check NOT NULL, AUTO_INCREMENT columns left out are numbered below
+        std::vector<size_t> generated;
+        for (size_t i = 0; i < columns.size(); ++i)
+        {
+            const auto &column = columns[i];
+            if (!std::holds_alternative<std::nullptr_t>(row[i]))
+                continue;
+            if (storage->sequence(static_cast<int>(i)))
+                generated.push_back(i);
+            else if (isNotNullColumn(*column))
+                throw std::runtime_error("❌ Column '" + column->name + "' cannot be NULL");
+        }
+
+        // Step 3: Reject a supplied key that is already taken before an id or a row slot is spent
+        for (const auto &index : table->indexes)
+        {
+            Catalog::ColumnId position = table->column(index.first);
+            const auto &column = columns[position];
+            IndexNode existing;
+            if (indexSearch(index.second, row[position], existing))
+                throw duplicateKeyError(*column, row[position]);
+        }
 
-            // Convert constraints
-            JSONParser::JSONArray constraintArray;
-            for (const auto &c : col.constraints)
+        // Step 4: Explicit values move the sequence past them, columns left out get the next id
+        for (size_t i = 0; i < columns.size(); ++i)
+        {
+            SequenceAllocator *sequence = storage->sequence(static_cast<int>(i));
+            if (const int *value = std::get_if<int>(&row[i]); sequence && value)
+                sequence->observe(*value);
+        }
+        for (size_t i : generated)
+        {
+            int64_t id = storage->sequence(static_cast<int>(i))->next();
+            if (id > INT_MAX)
             {
-                switch (c)
-                {
-                case ColumnConstraint::NOT_NULL:
-                    constraintArray.push_back(JSONParser::JSONValue("not_null"));
-                    break;
-                case ColumnConstraint::PRIMARY_KEY:
-                    constraintArray.push_back(JSONParser::JSONValue("primary_key"));
-                    break;
-                case ColumnConstraint::UNIQUE:
-                    constraintArray.push_back(JSONParser::JSONValue("unique"));
-                    break;
-                case ColumnConstraint::AUTO_INCREMENT:
-                    constraintArray.push_back(JSONParser::JSONValue("auto_increment"));
-                    break;
-                default:
-                    break;
-                }
+                throw std::runtime_error("❌ AUTO_INCREMENT column '" + columns[i]->name + "' is out of INT values");
             }
-
-            colJson["constraints"] = JSONParser::JSONValue(constraintArray);
-            columnArray.push_back(JSONParser::JSONValue(colJson));
+            row[i] = static_cast<int>(id);
         }
 
-        // Step 0: Check if table already exists in globalTableCache
-        if (globalTableCache[currentDatabase].find(stmt->name) != globalTableCache[currentDatabase].end())
+        // Step 5: Append the row and register it in every index of the table.
+        // Column indexes only exist on primary and unique keys (other columns
+        // get composite indexes), each claimed in one index descent, so
+        // concurrent inserts of one key cannot both succeed. The loser releases
+        // its keys, deletes the row again and hands its ids back.
+        int64_t rowId;
+        IndexNode location = storage->appendRow(row, &rowId);
+        std::vector<std::pair<const TreeVariant *, Catalog::ColumnId>> claimed;
+        for (const auto &index : table->indexes)
+        {
+            Catalog::ColumnId position = table->column(index.first);
+            const auto &column = columns[position];
+            if (!indexInsertIfAbsent(index.second, row[position], location))
+            {
+                for (const auto &key : claimed)
+                    removeIndexEntry(*key.first, row[key.second], location);
+                storage->deleteRow(rowId, location);
+                for (size_t i : generated)
+                    storage->sequence(static_cast<int>(i))->release(std::get<int>(row[i]));
+                throw duplicateKeyError(*column, row[position]);
+            }
+            claimed.emplace_back(&index.second, position);
+        }
+        for (const auto &index : table->compositeIndexes)
         {
-            throw std::runtime_error("❌ Table '" + stmt->name + "' already exists in DB '" + currentDatabase + "'");
+            compositeInsert(index, row, location);
         }
 
-        // Step 2: Create table JSON
-        JSONParser::JSONObject tableJson = {
-            {"name", JSONParser::JSONValue(stmt->name)},
-            {"columns", JSONParser::JSONValue(columnArray)}};
+        std::cout << "✅ Inserted 1 row into '" << stmt->tableName << "'\n";
+    }
 
-        // Step 3: Load existing JSON file
-        std::string filePath = "./db/" + currentDatabase + ".shivam.db";
-        JSONParser parser(filePath);
+    // Rows matched by a WHERE clause, located through an index when possible
+    struct MatchedRow
+    {
+        int64_t rowId;
+        IndexNode location;
+        Row row;
+    };
 
-        if (!parser.loadFromFile())
+    std::vector<MatchedRow> findMatchingRows(const std::string &table, const std::unique_ptr<WhereClause> &where,
+                                             QueryExecutor::TableAccess &access)
+    {
+        std::vector<const Expression *> conjuncts;
+        if (where)
+            QueryExecutor::collectConjuncts(where->condition.get(), conjuncts);
+
+        access = QueryExecutor::planTableAccess(currentDatabase, table, conjuncts);
+        if (access.filters.size() != conjuncts.size())
         {
-            throw std::runtime_error("❌ Failed to load DB file: " + filePath);
+            throw std::runtime_error("❌ WHERE references a column that is not in table '" + table + "'");
         }
 
-        JSONParser::JSONValue root = parser.getObject(0);
-        if (!std::holds_alternative<JSONParser::JSONObject>(root.value))
+        std::vector<MatchedRow> matches;
+        QueryExecutor::forEachMatch(access, [&matches](int64_t rowId, const IndexNode &location, const Row &row)
+                                    {
+                                        matches.push_back(MatchedRow{rowId, location, row});
+                                        return true; });
+        return matches;
+    }
+
+    void generateUpdateStatement(const std::unique_ptr<UpdateStatement> &stmt)
+    {
+        QueryExecutor::TableAccess access;
+        std::vector<MatchedRow> matches = findMatchingRows(stmt->table, stmt->whereClause, access);
+        const auto &columns = access.storage->getColumns();
+
+        std::vector<std::pair<int, const Expression *>> assignments;
+        for (const auto &assignment : stmt->assignments)
         {
-            throw std::runtime_error("Root of DB JSON must be an object");
+            assignments.emplace_back(access.layout.resolve(assignment.first), assignment.second.get());
         }
 
-        auto &dbObj = std::get<JSONParser::JSONObject>(root.value);
+        // Step 1: Compute every new row and validate it before touching any file
+        std::vector<Row> newRows;
+        newRows.reserve(matches.size());
+        for (const auto &match : matches)
+        {
+            Row row = match.row;
+            for (const auto &assignment : assignments)
+            {
+                FieldValue value = QueryExecutor::evaluateValue(assignment.second, access.layout, match.row);
+                row[assignment.first] = toColumnValue(*columns[assignment.first], value);
+                if (isNotNullColumn(*columns[assignment.first]) && std::holds_alternative<std::nullptr_t>(row[assignment.first]))
+                {
+                    throw std::runtime_error("❌ Column '" + columns[assignment.first]->name + "' cannot be NULL");
+                }
+            }
+            newRows.push_back(std::move(row));
+        }
 
-        // Step 4: Add table to the JSON
-        if (dbObj.find("tables") != dbObj.end() &&
-            std::holds_alternative<JSONParser::JSONArray>(dbObj["tables"].value))
+        std::vector<std::pair<int, const TreeVariant *>> tableIndexes;
+        for (const auto &index : access.entry->indexes)
         {
+            tableIndexes.emplace_back(access.entry->column(index.first), &index.second);
+        }
 
-            auto &tables = std::get<JSONParser::JSONArray>(dbObj["tables"].value);
-            tables.push_back(JSONParser::JSONValue(tableJson));
+        for (const auto &index : tableIndexes)
+        {
+            const auto &column = columns[index.first];
+            std::vector<FieldValue> vacated, claimed;
+            for (size_t i = 0; i < matches.size(); ++i)
+            {
+                if (compareFields(matches[i].row[index.first], newRows[i][index.first]) != 0)
+                {
+                    vacated.push_back(matches[i].row[index.first]);
+                    if (!std::holds_alternative<std::nullptr_t>(newRows[i][index.first]))
+                        claimed.push_back(newRows[i][index.first]);
+                }
+            }
+            std::sort(claimed.begin(), claimed.end(), [](const FieldValue &a, const FieldValue &b)
+                      { return compareFields(a, b) < 0; });
+            for (size_t i = 0; i < claimed.size(); ++i)
+            {
+                IndexNode existing;
+                bool takenByOtherRow = indexSearch(*index.second, claimed[i], existing) &&
+                                       std::none_of(vacated.begin(), vacated.end(), [&](const FieldValue &v)
+                                                    { return compareFields(v, claimed[i]) == 0; });
+                if (takenByOtherRow || (i > 0 && compareFields(claimed[i - 1], claimed[i]) == 0))
+                {
+                    throw duplicateKeyError(*column, claimed[i]);
+                }
+            }
         }
-        else
+
+        // A value written into an AUTO_INCREMENT column moves the sequence past it, like an INSERT
+        for (const auto &assignment : assignments)
         {
-            dbObj["tables"] = JSONParser::JSONValue(JSONParser::JSONArray{
-                JSONParser::JSONValue(tableJson)});
+            SequenceAllocator *sequence = access.storage->sequence(assignment.first);
+            if (!sequence)
+                continue;
+            for (const auto &row : newRows)
+            {
+                if (const int *value = std::get_if<int>(&row[assignment.first]))
+                    sequence->observe(*value);
+            }
         }
 
-        // Step 5: Save back to file
-        parser.clear();
-        parser.appendValue(JSONParser::JSONValue(dbObj));
+        // Step 2: Drop index entries whose key changes, then write rows and re-point indexes
+        for (size_t i = 0; i < matches.size(); ++i)
+        {
+            for (const auto &index : tableIndexes)
+            {
+                if (compareFields(matches[i].row[index.first], newRows[i][index.first]) != 0)
+                    removeIndexEntry(*index.second, matches[i].row[index.first], matches[i].location);
+            }
+        }
 
-        if (!parser.saveToFile())
+        size_t inPlace = 0;
+        for (size_t i = 0; i < matches.size(); ++i)
         {
-            throw std::runtime_error("❌ Failed to save DB JSON file");
+            bool fits = false;
+            IndexNode location = access.storage->updateRow(matches[i].rowId, matches[i].location, newRows[i], &fits);
+            if (fits)
+                inPlace++;
+
+            bool moved = location.start != matches[i].location.start || location.end != matches[i].location.end;
+            for (const auto &index : tableIndexes)
+            {
+                bool keyChanged = compareFields(matches[i].row[index.first], newRows[i][index.first]) != 0;
+                if (keyChanged || moved)
+                    indexInsert(*index.second, newRows[i][index.first], location);
+            }
+
+            // A composite key holds the row's location and INCLUDE values, so a move re-keys it too
+            for (const auto &index : access.entry->compositeIndexes)
+            {
+                auto changed = [&](uint32_t column)
+                { return compareFields(matches[i].row[column], newRows[i][column]) != 0; };
+                bool keyChanged = std::any_of(index.columns.begin(), index.columns.end(), changed) ||
+                                  std::any_of(index.included.begin(), index.included.end(), changed);
+                if (keyChanged || location.start != matches[i].location.start)
+                {
+                    compositeRemove(index, matches[i].row, matches[i].location);
+                    compositeInsert(index, newRows[i], location);
+                }
+            }
         }
 
-        // Optional: Update in-memory cache too
-        globalTableCache[currentDatabase][stmt->name] = {}; // You can populate columns later
+        std::cout << "✅ Updated " << matches.size() << " rows in '" << stmt->table << "' ("
+                  << inPlace << " in place)\n";
+    }
 
-        std::cout << "✅ Table '" << stmt->name << "' added to DB '" << currentDatabase << "' successfully.\n";
-        std::string tablename = stmt->name;
-        std::stringstream indexFile, dataFile;
+    void generateDeleteStatement(const std::unique_ptr<DeleteStatement> &stmt)
+    {
+        QueryExecutor::TableAccess access;
+        std::vector<MatchedRow> matches = findMatchingRows(stmt->table, stmt->whereClause, access);
 
-        indexFile << tableDirectory << "/" << currentDatabase <<"/"<< tablename << ".index";
-        dataFile << tableDirectory << "/" << currentDatabase <<"/"<< tablename << ".data";
+        const auto &indexes = access.entry->indexes;
+        for (const auto &match : matches)
+        {
+            for (const auto &index : indexes)
+            {
+                removeIndexEntry(index.second, match.row[access.entry->column(index.first)], match.location);
+            }
+            for (const auto &index : access.entry->compositeIndexes)
+            {
+                compositeRemove(index, match.row, match.location);
+            }
+            access.storage->deleteRow(match.rowId, match.location);
+        }
 
-        MyUtility::createFile(indexFile.str(),"");
-        MyUtility::createFile(dataFile.str(),"");
+        std::cout << "✅ Deleted " << matches.size() << " rows from '" << stmt->table << "'\n";
+        if (!matches.empty())
+            vacuumWorker.wake();
     }
 
+    // ANALYZE <table> collects statistics for one table, ANALYZE for every table of the database
+    void generateAnalyzeStatement(const std::unique_ptr<AnalyzeStatement> &stmt)
+    {
+        std::vector<std::string> tables;
+        if (!stmt->table.empty())
+        {
+            tables.push_back(stmt->table);
+        }
+        else
+        {
+            for (const auto &entry : Catalog::tablesOf(currentDatabase))
+                tables.push_back(entry->name);
+        }
+
+        for (const auto &table : tables)
+        {
+            auto storage = getTableStorage(currentDatabase, table);
+            auto statement = storage->statementLock();
+            Statistics::TableStatistics stats = Statistics::analyzeTable(*storage);
+            Statistics::setStatistics(currentDatabase, table, stats);
 
-    void generateInsertStatement(){
-        
+            std::cout << "✅ Analyzed '" << table << "': " << stats.rowCount << " rows\n";
+            for (const auto &column : storage->getColumns())
+            {
+                const auto *columnStats = stats.column(column->name);
+                std::cout << "   " << column->name << ": ~" << columnStats->distinct << " distinct, "
+                          << columnStats->nullFraction * 100 << "% null, "
+                          << (columnStats->bounds.empty() ? 0 : columnStats->bounds.size() - 1) << " histogram buckets\n";
+            }
+        }
+    }
+
+    // Manual vacuum runs unthrottled
+    void generateVacuumStatement(const std::unique_ptr<VacuumStatement> &stmt)
+    {
+        auto storage = getTableStorage(currentDatabase, stmt->table);
+        auto stats = vacuumTable(storage, 0);
+        std::cout << "✅ Vacuumed '" << stmt->table << "': moved " << stats.rowsMoved << " rows ("
+                  << stats.bytesMoved << " bytes), reclaimed " << stats.bytesReclaimed << " bytes\n";
     }
 
 };
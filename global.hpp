@@ -1,15 +1,19 @@
 #ifndef GLOBALS_HPP
 #define GLOBALS_HPP
 
+#include <algorithm>
 #include <string>
 #include <unordered_map>
 #include <memory>
 #include <variant>
 #include <vector>
 #include <climits>
+#include <cstdint>
 
 #include "databaseSchemaReader.hpp"
 #include "storageTree.hpp"
+#include "hashIndex.hpp"
+#include "artIndex.hpp"
 
 // --- File Paths ---
 inline std::string currentDbPath = "db/current_db.meta";
@@ -17,6 +21,27 @@ inline std::string dbDirectoryPath = "./db";
 inline std::string allTableDataDirectory = "./db/data";
 inline std::string currentDatabase = "";
 inline std::string tableDirectory = "./db/tables";
+// --- Row Values ---
+using FieldValue = std::variant<std::nullptr_t, int, std::string>;
+using Row = std::vector<FieldValue>;
+
+// Structure behind a column's index, picked by CREATE INDEX ... USING
+enum class IndexKind : uint8_t
+{
+    BTREE = 0, // ordered, serves lookups, ranges and ORDER BY
+    HASH = 1,  // equality lookups only
+    ART = 2    // adaptive radix tree, ordered like BTREE
+};
+
+// A multi-column index of a table, CREATE INDEX name ON t (a, b, ...)
+struct IndexDefinition
+{
+    std::string name;
+    std::vector<std::string> columns; // key columns, most significant first
+    IndexKind kind = IndexKind::BTREE;
+    std::vector<std::string> include; // INCLUDE columns, stored in each entry but not searchable
+};
+
 // --- Schema Node Structure ---
 struct TableGlobalColumnNode {
     std::string type;
@@ -25,46 +50,51 @@ struct TableGlobalColumnNode {
     bool autoIncrement = false;
     bool isUnique = false;
     bool isPrimary = false;
-    bool createIndex = false;
+    bool createIndex = false; // legacy "create_index", migrated to a composite index at load
+    IndexKind indexKind = IndexKind::BTREE; // "hash_index" or "art_index" constraint
     int length = INT_MAX;
+    FieldValue defaultValue = nullptr; // for INSERTs that omit the column and rows stored before it existed
+    uint32_t schemaVersion = 0;        // table schema version that added the column, 0 = CREATE TABLE
 };
 
-// --- JSON Parser Cache ---
-// db_name -> JSON parser
- std::unordered_map<std::string, std::shared_ptr<PythonLikeJSONParser>> globalJsonCache;
+inline bool isIntColumn(const TableGlobalColumnNode &column)
+{
+    return column.type == "int";
+}
 
-// --- Table Metadata Cache ---
-// db_name -> table_name -> vector of column definitions
- std::unordered_map<
-    std::string,
-    std::unordered_map<
-        std::string,
-        std::vector<std::shared_ptr<TableGlobalColumnNode>>>>
-    globalTableCache;
+inline bool isNotNullColumn(const TableGlobalColumnNode &column)
+{
+    return column.isPrimary ||
+           std::find(column.constraint.begin(), column.constraint.end(), "not_null") != column.constraint.end();
+}
+
+// How a table lays out its rows: ROW keeps whole rows in <table>.data,
+// COLUMNAR keeps each column in its own segment files (columnStore.hpp)
+enum class StorageEngine : uint8_t
+{
+    ROW = 0,
+    COLUMNAR = 1
+};
 
 // --- Index Node Representation ---
+// [start, end) byte range of a row inside <table>.data,
+// [rowId, rowId + 1) for ENGINE=COLUMNAR tables
 struct IndexNode {
     int64_t start;
-    int16_t end;
+    int64_t end;
 };
 
-// --- B+ Tree Variant for different key types ---
+// --- Index Variant for different key types and index kinds ---
 using TreeVariant = std::variant<
     std::shared_ptr<BPlusTree<int, IndexNode>>,
-    std::shared_ptr<BPlusTree<std::string, IndexNode>>>;
-
-// --- B+ Tree Cache ---
-// db_name -> table_name -> column_name -> B+ Tree
- std::unordered_map<
-    std::string,
-    std::unordered_map<
-        std::string,
-        std::unordered_map<
-            std::string,
-            TreeVariant>>>
-    dbBtrees;
-
+    std::shared_ptr<BPlusTree<std::string, IndexNode>>,
+    std::shared_ptr<HashIndex<int, IndexNode>>,
+    std::shared_ptr<HashIndex<std::string, IndexNode>>,
+    std::shared_ptr<AdaptiveRadixTree<int, IndexNode>>,
+    std::shared_ptr<AdaptiveRadixTree<std::string, IndexNode>>>;
 
+// Table schemas, their indexes and storage handles are registered in the
+// Catalog (catalog.hpp)
 
 enum class ASTNodeType
 {
@@ -73,6 +103,10 @@ enum class ASTNodeType
     INSERT_STATEMENT,
     UPDATE_STATEMENT,
     DELETE_STATEMENT,
+    VACUUM_STATEMENT,
+    ANALYZE_STATEMENT,
+    ALTER_STATEMENT,
+    CREATE_INDEX_STATEMENT,
     EXPRESSION,
     IDENTIFIER,
     INT_LITERAL,
@@ -82,9 +116,11 @@ enum class ASTNodeType
     LOGICAL_EXPRESSION,
     PARENTHESIZED_EXPRESSION,
     LIMIT_CLAUSE,
+    ORDER_BY_CLAUSE,
     WHERE_CLAUSE,
     DROP_STATEMENT,
-    CREATE_STATEMENT
+    CREATE_STATEMENT,
+    JOIN_CLAUSE
 };
 
 enum class LogicalOperator
@@ -194,16 +230,71 @@ struct LimitClause : public ASTNode
     ASTNodeType getType() const override { return ASTNodeType::LIMIT_CLAUSE; }
 };
 
+// ORDER BY <column> [ASC | DESC]
+struct OrderByClause : public ASTNode
+{
+    std::string column;
+    bool descending = false;
+    OrderByClause(std::string column, bool descending) : column(std::move(column)), descending(descending) {}
+    ASTNodeType getType() const override { return ASTNodeType::ORDER_BY_CLAUSE; }
+};
+
+// JOIN <table> ON <leftTable>.<leftColumn> = <rightTable>.<rightColumn>
+struct JoinClause : public ASTNode
+{
+    std::string table;
+    std::string leftTable;
+    std::string leftColumn;
+    std::string rightTable;
+    std::string rightColumn;
+
+    ASTNodeType getType() const override { return ASTNodeType::JOIN_CLAUSE; }
+};
+
 struct SelectStatement : public ASTNode
 {
     std::vector<std::string> columns;
     std::string table;
+    std::unique_ptr<JoinClause> joinClause = nullptr;
     std::unique_ptr<WhereClause> whereClause = nullptr;
+    std::unique_ptr<OrderByClause> orderByClause = nullptr;
     std::unique_ptr<LimitClause> limitClause = nullptr;
 
     ASTNodeType getType() const override { return ASTNodeType::SELECT_STATEMENT; }
 };
 
+struct UpdateStatement : public ASTNode
+{
+    std::string table;
+    // column = expression, in SET order
+    std::vector<std::pair<std::string, std::unique_ptr<Expression>>> assignments;
+    std::unique_ptr<WhereClause> whereClause = nullptr;
+
+    ASTNodeType getType() const override { return ASTNodeType::UPDATE_STATEMENT; }
+};
+
+struct DeleteStatement : public ASTNode
+{
+    std::string table;
+    std::unique_ptr<WhereClause> whereClause = nullptr;
+
+    ASTNodeType getType() const override { return ASTNodeType::DELETE_STATEMENT; }
+};
+
+struct VacuumStatement : public ASTNode
+{
+    std::string table;
+
+    ASTNodeType getType() const override { return ASTNodeType::VACUUM_STATEMENT; }
+};
+
+struct AnalyzeStatement : public ASTNode
+{
+    std::string table; // empty = every table in the database
+
+    ASTNodeType getType() const override { return ASTNodeType::ANALYZE_STATEMENT; }
+};
+
 struct DropStatement : public ASTNode
 {
     bool istable;
@@ -217,6 +308,7 @@ struct ColumnDefinition
     std::string name;
     std::string type;
     std::vector<ColumnConstraint> constraints;
+    FieldValue defaultValue = nullptr;
 
     ColumnDefinition(const std::string &name, const std::string &type)
         : name(name), type(type) {}
@@ -227,10 +319,32 @@ struct CreateStatement : public ASTNode
     bool isDatabase = false;
     std::string name;
     std::vector<ColumnDefinition> columns;
+    StorageEngine engine = StorageEngine::ROW;
 
     ASTNodeType getType() const override { return ASTNodeType::CREATE_STATEMENT; }
 };
 
+// ALTER TABLE t ADD [COLUMN] definition
+struct AlterStatement : public ASTNode
+{
+    std::string table;
+    ColumnDefinition column{"", ""};
+
+    ASTNodeType getType() const override { return ASTNodeType::ALTER_STATEMENT; }
+};
+
+// CREATE INDEX [name] ON t (column, ...) [INCLUDE (column, ...)] [USING BTREE | HASH | ART]
+struct CreateIndexStatement : public ASTNode
+{
+    std::string name; // optional, a single-column index is known by its column
+    std::string table;
+    std::vector<std::string> columns;
+    std::vector<std::string> include;
+    IndexKind kind = IndexKind::BTREE;
+
+    ASTNodeType getType() const override { return ASTNodeType::CREATE_INDEX_STATEMENT; }
+};
+
 struct InsertStatement
 {
     std::string tableName;
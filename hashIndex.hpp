@@ -0,0 +1,202 @@
+#ifndef __HASH_INDEX
+#define __HASH_INDEX
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <cstdint>
+
+// Linear hashing index for equality lookups (CREATE INDEX ... USING HASH).
+// A key lives in bucket hash & mask, or in hash & (2 * mask + 1) once the
+// split pointer has passed that bucket in the current round. The table grows
+// and shrinks one bucket at a time: an insert that pushes the load past
+// MAX_LOAD splits the bucket under the split pointer, a remove that drops it
+// below MIN_LOAD merges the last bucket back, so there is never a full rehash.
+// Entries keep their hash, a probe compares keys only when the hashes match.
+template <typename K, typename V>
+class HashIndex
+{
+public:
+    using key_type = K;
+
+private:
+    static constexpr size_t INITIAL_BUCKETS = 16; // power of two
+    static constexpr size_t MAX_LOAD = 4;         // average entries per bucket before a split
+    static constexpr size_t MIN_LOAD = 1;         // average entries per bucket before a merge
+
+    struct Entry
+    {
+        uint64_t hash;
+        K key;
+        V value;
+    };
+    using Bucket = std::vector<Entry>;
+
+    // A deque never moves the buckets it already holds while it grows.
+    // Invariant: buckets.size() == mask + 1 + split
+    std::deque<Bucket> buckets;
+    size_t mask = INITIAL_BUCKETS - 1; // buckets at the start of this round, minus one
+    size_t split = 0;                  // next bucket to split in this round
+    std::atomic<size_t> count{0};
+    mutable std::shared_mutex mutex;
+
+    static uint64_t hashOf(const K &key)
+    {
+        // std::hash<int> is the identity, mix it so the low bits pick the bucket
+        uint64_t h = std::hash<K>{}(key);
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    size_t bucketOf(uint64_t hash) const
+    {
+        size_t bucket = hash & mask;
+        return bucket < split ? hash & (2 * mask + 1) : bucket;
+    }
+
+    Entry *find(Bucket &bucket, uint64_t hash, const K &key)
+    {
+        for (Entry &entry : bucket)
+        {
+            if (entry.hash == hash && entry.key == key)
+                return &entry;
+        }
+        return nullptr;
+    }
+
+    // Move the entries of the bucket under the split pointer that now hash
+    // to its partner bucket, split + mask + 1, appended at the end
+    void splitOne()
+    {
+        buckets.emplace_back();
+        Bucket &from = buckets[split];
+        Bucket &to = buckets.back();
+        size_t wideMask = 2 * mask + 1;
+        size_t kept = 0;
+        for (size_t i = 0; i < from.size(); ++i)
+        {
+            if ((from[i].hash & wideMask) == split)
+            {
+                if (kept != i)
+                    from[kept] = std::move(from[i]);
+                kept++;
+            }
+            else
+            {
+                to.push_back(std::move(from[i]));
+            }
+        }
+        from.resize(kept);
+
+        if (++split > mask)
+        {
+            mask = wideMask;
+            split = 0;
+        }
+    }
+
+    // Undo the last split: fold the last bucket into its partner
+    void mergeOne()
+    {
+        if (split == 0)
+        {
+            if (mask + 1 == INITIAL_BUCKETS)
+                return;
+            mask >>= 1;
+            split = mask + 1;
+        }
+        split--;
+        Bucket &into = buckets[split];
+        for (Entry &entry : buckets.back())
+            into.push_back(std::move(entry));
+        buckets.pop_back();
+    }
+
+public:
+    HashIndex() : buckets(INITIAL_BUCKETS) {}
+
+    void insert(const K &key, const V &value)
+    {
+        uint64_t hash = hashOf(key);
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        Bucket &bucket = buckets[bucketOf(hash)];
+        if (Entry *entry = find(bucket, hash, key))
+        {
+            entry->value = value;
+            return;
+        }
+        bucket.push_back(Entry{hash, key, value});
+        if (++count > buckets.size() * MAX_LOAD)
+            splitOne();
+    }
+
+    // Insert unless the key is present, false if it was (its value goes to `existing`)
+    bool insert_if_absent(const K &key, const V &value, V *existing = nullptr)
+    {
+        uint64_t hash = hashOf(key);
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        Bucket &bucket = buckets[bucketOf(hash)];
+        if (Entry *entry = find(bucket, hash, key))
+        {
+            if (existing)
+                *existing = entry->value;
+            return false;
+        }
+        bucket.push_back(Entry{hash, key, value});
+        if (++count > buckets.size() * MAX_LOAD)
+            splitOne();
+        return true;
+    }
+
+    bool search(const K &key, V &value) const
+    {
+        uint64_t hash = hashOf(key);
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        for (const Entry &entry : buckets[bucketOf(hash)])
+        {
+            if (entry.hash == hash && entry.key == key)
+            {
+                value = entry.value;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool remove(const K &key)
+    {
+        uint64_t hash = hashOf(key);
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        Bucket &bucket = buckets[bucketOf(hash)];
+        Entry *entry = find(bucket, hash, key);
+        if (!entry)
+            return false;
+        if (entry != &bucket.back())
+            *entry = std::move(bucket.back());
+        bucket.pop_back();
+        if (--count < buckets.size() * MIN_LOAD)
+            mergeOne();
+        return true;
+    }
+
+    size_t size() const
+    {
+        return count.load();
+    }
+
+    size_t bucket_count() const
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        return buckets.size();
+    }
+};
+
+#endif // __HASH_INDEX
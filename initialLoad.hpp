@@ -6,10 +6,14 @@
 #include <iostream>
 #include <sstream>
 #include <memory>
+#include <vector>
 #include <stdexcept>
 #include <climits>
 #include "global.hpp"
 #include "utility.hpp"
+#include "rowStorage.hpp"
+#include "catalog.hpp"
+#include "catalogFile.hpp"
 
 namespace fs = std::filesystem;
 
@@ -22,85 +26,113 @@ bool checkDBexist(const std::string &name)
     return MyUtility::checkIfFileExist(file.str());
 }
 
+// True when `name` ends with `suffix`
+inline bool hasSuffix(const std::string &name, const std::string &suffix)
+{
+    return name.size() > suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
 void initialDatabseLoad()
 {
+    // A .tmp file is a catalog or JSON export cut short before its rename,
+    // the file it was meant to replace is still complete
+    std::vector<fs::path> stale;
+    for (const auto &entry : fs::directory_iterator(dbDirectoryPath))
+    {
+        if (fs::is_regular_file(entry.status()) && hasSuffix(entry.path().filename().string(), ".tmp"))
+            stale.push_back(entry.path());
+    }
+    for (const auto &path : stale)
+        fs::remove(path);
+
+    const std::string suffix = ".shivam.db";
     for (const auto &entry : fs::directory_iterator(dbDirectoryPath))
     {
         if (fs::is_regular_file(entry.status()))
         {
             std::string filename = entry.path().filename().string();
 
-            if (filename.find(".db") != std::string::npos)
+            if (hasSuffix(filename, suffix))
             {
-                std::string dbname = MyUtility::extractBaseName(filename);
-                std::shared_ptr<PythonLikeJSONParser> parser = std::make_shared<PythonLikeJSONParser>();
+                std::string dbname = filename.substr(0, filename.size() - suffix.size());
 
-                // Store parser in global cache
-                globalJsonCache[dbname] = parser;
+                // Fast path: the binary checkpoint plus the DDL log, unless the JSON was edited after it was written
+                std::vector<CatalogFile::TableSchema> schemas;
+                uint64_t lsn = 0;
+                if (CatalogFile::isCurrent(dbname) && CatalogFile::load(dbname, schemas, lsn))
+                {
+                    CatalogFile::loadDatabase(dbname, std::move(schemas), lsn, false);
+                    std::cout << "Loaded " << Catalog::tablesOf(dbname).size() << " tables from DB: " << dbname
+                              << " (binary catalog)" << std::endl;
+                    continue;
+                }
 
                 std::string fullPath = dbDirectoryPath + "/" + filename;
-                if (!parser->loadFromFile(fullPath))
+                JSONDocument document;
+                if (!document.loadFromFile(fullPath))
                 {
                     std::cerr << "Failed to load file: " << fullPath << std::endl;
+                    Catalog::addDatabase(dbname);
                     continue;
                 }
 
+                schemas.clear();
                 try
                 {
-                    JSONArrayWrapper tablesArray = (*parser)[0][std::string("tables")].asArray();
-                    for (size_t i = 0; i < tablesArray.size(); ++i)
+                    // The file holds an array with the database object as its first element
+                    JSONView root = document.root();
+                    JSONView database = root.isArray() ? root[0] : root;
+                    for (JSONView table : database["tables"].elements())
                     {
-                        std::string tableName = tablesArray[i][std::string("name")].getString();
-                        JSONArrayWrapper columnsArray = tablesArray[i][std::string("columns")].asArray();
-
+                        std::string tableName(table["name"].getString());
                         std::vector<std::shared_ptr<TableGlobalColumnNode>> columnNodes;
 
-                        for (size_t j = 0; j < columnsArray.size(); ++j)
+                        for (JSONView column : table["columns"].elements())
                         {
-                            std::shared_ptr<TableGlobalColumnNode> node = std::make_shared<TableGlobalColumnNode>();
-
-                            std::string columnDataName = columnsArray[j][std::string("name")].getString();
-                            std::string columnDataType = columnsArray[j][std::string("type")].getString();
-                            JSONArrayWrapper constraintArray = columnsArray[j][std::string("constraints")].asArray();
-
                             int length = INT_MAX;
-                            bool isUnique = false;
-                            bool isPrimary = false;
-                            bool autoIncrement = false;
-                            bool createIndex = false;
-
-                            for (size_t k = 0; k < constraintArray.size(); ++k)
+                            if (auto lengthValue = column.find("length"))
                             {
-                                std::string constraint = constraintArray[k].getString();
-                                if (constraint == "primary_key")
-                                    isPrimary = true;
-                                if (constraint == "auto_increment")
-                                    autoIncrement = true;
-                                if (constraint == "unique")
-                                    isUnique = true;
-                                if (constraint == "create_index")
-                                    createIndex = true;
+                                if (!lengthValue->isInt())
+                                    throw std::runtime_error("Cannot convert to int");
+                                length = lengthValue->getInt();
                             }
-
-                            if (columnsArray[j].hasKey(std::string("length")))
+                            FieldValue defaultValue = nullptr;
+                            if (auto value = column.find("default"))
                             {
-                                length = columnsArray[j][std::string("length")];
+                                if (value->isInt())
+                                    defaultValue = value->getInt();
+                                else if (value->isString())
+                                    defaultValue = std::string(value->getString());
                             }
-
-                            node->constraint = constraintArray.toStringVector();
-                            node->length = length;
-                            node->name = columnDataName;
-                            node->type = columnDataType;
-                            node->autoIncrement = autoIncrement;
-                            node->isUnique = isUnique;
-                            node->createIndex = createIndex;
-                            node->isPrimary = isPrimary;
-
-                            columnNodes.push_back(node);
+                            uint32_t schemaVersion = 0;
+                            if (auto version = column.find("schema_version"))
+                                schemaVersion = static_cast<uint32_t>(version->getInt());
+                            columnNodes.push_back(CatalogFile::makeColumn(std::string(column["name"].getString()),
+                                                                          std::string(column["type"].getString()), length,
+                                                                          column["constraints"].toStringVector(),
+                                                                          std::move(defaultValue), schemaVersion));
                         }
 
-                        // Save table columns in globalTableCache
-                        globalTableCache[dbname][tableName] = std::move(columnNodes);
+                        // Indexes start out empty and are filled by initializePrimaryIndexBtrees
+                        StorageEngine engine = StorageEngine::ROW;
+                        if (auto engineName = table.find("engine"); engineName && engineName->getString() == "columnar")
+                            engine = StorageEngine::COLUMNAR;
+                        std::vector<IndexDefinition> indexes;
+                        if (auto indexList = table.find("indexes"))
+                        {
+                            for (JSONView index : indexList->elements())
+                            {
+                                IndexDefinition definition;
+                                definition.name = std::string(index["name"].getString());
+                                definition.columns = index["columns"].toStringVector();
+                                if (auto include = index.find("include"))
+                                    definition.include = include->toStringVector();
+                                if (auto kind = index.find("using"); kind && kind->getString() == "art")
+                                    definition.kind = IndexKind::ART;
+                                indexes.push_back(std::move(definition));
+                            }
+                        }
+                        schemas.push_back({tableName, std::move(columnNodes), engine, std::move(indexes)});
 
                         std::cout << "Loaded table: " << tableName << " from DB: " << dbname << std::endl;
                     }
@@ -109,44 +141,24 @@ void initialDatabseLoad()
                 {
                     std::cerr << "Error accessing 'tables' in " << fullPath << ": " << e.what() << std::endl;
                 }
+
+                // Import: the JSON was exported at the last checkpoint, so every log
+                // record may be newer. Replay skips tables it already has, then a
+                // new checkpoint is written for the next startup.
+                CatalogFile::loadDatabase(dbname, std::move(schemas), 0, true);
             }
         }
     }
 }
 
 void initializePrimaryIndexBtrees() {
-    for (const auto& dbPair : globalTableCache) {
-        const std::string& dbName = dbPair.first;
-        const auto& tables = dbPair.second;
-
-        for (const auto& tablePair : tables) {
-            const std::string& tableName = tablePair.first;
-            const auto& columns = tablePair.second;
-
-            for (const auto& columnPtr : columns) {
-                if (columnPtr->isPrimary || columnPtr->createIndex) {
-                    const std::string& columnName = columnPtr->name;
-                    const std::string& type = columnPtr->type;
-
-                    TreeVariant tree;
-
-                    if (type == "int") {
-                        tree = std::make_shared<BPlusTree<int, IndexNode>>();
-                    } else if (type == "string" || type == "varchar" || type == "text") {
-                        tree = std::make_shared<BPlusTree<std::string, IndexNode>>();
-                    } else {
-                        std::cerr << "Unsupported primary key type: " << type
-                                  << " for column: " << columnName << std::endl;
-                        continue;
-                    }
-
-                    dbBtrees[dbName][tableName][columnName] = std::move(tree);
-
-                    std::cout << "Initialized B+ Tree for " << dbName
-                              << "." << tableName << "." << columnName << std::endl;
-                }
-            }
+    for (const auto& table : Catalog::current()->tables) {
+        for (const auto& index : table->indexes) {
+            std::cout << "Initialized B+ Tree for " << table->databaseName
+                      << "." << table->name << "." << index.first << std::endl;
         }
+
+        rebuildTableIndexes(*table);
     }
 }
 
@@ -0,0 +1,318 @@
+#ifndef __JOIN_EXECUTOR
+#define __JOIN_EXECUTOR
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <unordered_map>
+#include <cmath>
+#include <algorithm>
+#include "global.hpp"
+#include "rowStorage.hpp"
+
+namespace JoinExecutor
+{
+    enum class JoinAlgorithm
+    {
+        HASH,
+        INDEX_NESTED_LOOP,
+        MERGE
+    };
+
+    inline std::string algorithmName(JoinAlgorithm algorithm)
+    {
+        switch (algorithm)
+        {
+        case JoinAlgorithm::HASH:
+            return "HASH JOIN";
+        case JoinAlgorithm::INDEX_NESTED_LOOP:
+            return "INDEX NESTED LOOP JOIN";
+        case JoinAlgorithm::MERGE:
+            return "MERGE JOIN";
+        }
+        return "UNKNOWN JOIN";
+    }
+
+    // Relative costs, one sequentially read row is the unit
+    constexpr double SEQ_ROW_COST = 1.0;
+    constexpr double HASH_BUILD_COST = 2.0;     // insert into the in-memory hash table
+    constexpr double RANDOM_FETCH_COST = 4.0;   // seek + read of a single row by IndexNode
+    constexpr double ORDERED_FETCH_COST = 1.5;  // fetch in key order, mostly forward seeks
+    constexpr double LEAF_STEP_COST = 0.1;      // advance a leaf iterator by one key
+    constexpr double TREE_LEVEL_COST = 0.5;     // compare keys in one B+ tree level
+    constexpr double HASH_PROBE_COST = 1.0;     // hash the key and scan one hash bucket
+
+    // One side of an equi-join
+    struct JoinInput
+    {
+        std::string table;
+        std::string column;
+        int keyPosition = -1;
+        std::shared_ptr<TableStorage> storage;
+        const TreeVariant *index = nullptr; // unique index on the join column, nullptr if none
+        double tableRows = 0;               // rows stored in the table
+        double estimatedRows = 0;           // rows left after this side's own filters
+        double accessCost = 0;              // cost to produce those rows on their own
+        double keyDistinct = 0;             // distinct join keys in the table
+    };
+
+    struct JoinPlan
+    {
+        JoinAlgorithm algorithm = JoinAlgorithm::HASH;
+        bool leftIsOuter = true; // outer side for the index nested loop
+        double cost = 0;
+        double estimatedRows = 0;
+    };
+
+    // Classic equi-join estimate |L| * |R| / max(distinct(L.key), distinct(R.key))
+    inline double joinCardinality(const JoinInput &left, const JoinInput &right)
+    {
+        double distinct = std::max({left.keyDistinct, right.keyDistinct, 1.0});
+        return left.estimatedRows * right.estimatedRows / distinct;
+    }
+
+    inline double probeCost(double innerRows, const TreeVariant *index = nullptr)
+    {
+        if (index && !indexOrdered(*index))
+            return HASH_PROBE_COST + RANDOM_FETCH_COST;
+        return TREE_LEVEL_COST * (std::log2(std::max(innerRows, 2.0)) + 1) + RANDOM_FETCH_COST;
+    }
+
+    // Pick the cheapest algorithm from the cardinality estimates of both sides
+    inline JoinPlan chooseJoinPlan(const JoinInput &left, const JoinInput &right)
+    {
+        JoinPlan best;
+        best.algorithm = JoinAlgorithm::HASH;
+        best.estimatedRows = joinCardinality(left, right);
+        best.cost = left.accessCost + right.accessCost +
+                    HASH_BUILD_COST * std::min(left.estimatedRows, right.estimatedRows);
+
+        auto consider = [&best](JoinAlgorithm algorithm, bool leftIsOuter, double cost)
+        {
+            if (cost < best.cost)
+            {
+                best.algorithm = algorithm;
+                best.leftIsOuter = leftIsOuter;
+                best.cost = cost;
+            }
+        };
+
+        if (right.index)
+        {
+            consider(JoinAlgorithm::INDEX_NESTED_LOOP, true,
+                     left.accessCost + left.estimatedRows * probeCost(right.tableRows, right.index));
+        }
+        if (left.index)
+        {
+            consider(JoinAlgorithm::INDEX_NESTED_LOOP, false,
+                     right.accessCost + right.estimatedRows * probeCost(left.tableRows, left.index));
+        }
+        if (left.index && right.index && left.index->index() == right.index->index() && indexOrdered(*left.index))
+        {
+            // Both leaf chains are walked completely, only matching keys are fetched
+            double matches = std::min({left.tableRows, right.tableRows,
+                                       left.tableRows * right.tableRows / std::max({left.keyDistinct, right.keyDistinct, 1.0})});
+            consider(JoinAlgorithm::MERGE, true,
+                     LEAF_STEP_COST * (left.tableRows + right.tableRows) + 2 * ORDERED_FETCH_COST * matches);
+        }
+        return best;
+    }
+
+    using RowPredicate = std::function<bool(const Row &)>;
+
+    // out = left ++ right, reusing out's storage
+    inline void concatRows(const Row &left, const Row &right, Row &out)
+    {
+        out.resize(left.size() + right.size());
+        std::copy(left.begin(), left.end(), out.begin());
+        std::copy(right.begin(), right.end(), out.begin() + left.size());
+    }
+
+    // Builds a hash table on one input at the first pull, then streams the
+    // other input through it. Only the build side is held in memory.
+    class HashJoinSource : public RowSource
+    {
+    private:
+        std::unique_ptr<RowSource> build;
+        std::unique_ptr<RowSource> probe;
+        int buildKey, probeKey;
+        bool buildIsLeft;
+        RowPredicate residual;
+
+        std::vector<Row> buildRows;
+        std::unordered_map<FieldValue, std::vector<size_t>> table;
+        bool built = false;
+        Row probeRow;
+        const std::vector<size_t> *matches = nullptr;
+        size_t matchPos = 0;
+
+    public:
+        HashJoinSource(std::unique_ptr<RowSource> build, int buildKey, std::unique_ptr<RowSource> probe, int probeKey,
+                       bool buildIsLeft, RowPredicate residual)
+            : build(std::move(build)), probe(std::move(probe)), buildKey(buildKey), probeKey(probeKey),
+              buildIsLeft(buildIsLeft), residual(std::move(residual)) {}
+
+        bool next(Row &out) override
+        {
+            if (!built)
+            {
+                Row row;
+                while (build->next(row))
+                {
+                    if (std::holds_alternative<std::nullptr_t>(row[buildKey]))
+                        continue;
+                    table[row[buildKey]].push_back(buildRows.size());
+                    buildRows.push_back(row);
+                }
+                built = true;
+            }
+
+            while (true)
+            {
+                while (matches && matchPos < matches->size())
+                {
+                    const Row &match = buildRows[(*matches)[matchPos++]];
+                    if (buildIsLeft)
+                        concatRows(match, probeRow, out);
+                    else
+                        concatRows(probeRow, match, out);
+                    if (!residual || residual(out))
+                        return true;
+                }
+                matches = nullptr;
+
+                if (!probe->next(probeRow))
+                    return false;
+                auto it = table.find(probeRow[probeKey]);
+                if (it != table.end())
+                {
+                    matches = &it->second;
+                    matchPos = 0;
+                }
+            }
+        }
+    };
+
+    // Probes the inner side's B+ tree once per outer row
+    class IndexNestedLoopSource : public RowSource
+    {
+    private:
+        std::unique_ptr<RowSource> outer;
+        int outerKey;
+        const TableStorage &inner;
+        const TreeVariant &innerIndex;
+        RowPredicate innerFilter;
+        bool outerIsLeft;
+        RowPredicate residual;
+        Row outerRow, innerRow;
+
+    public:
+        IndexNestedLoopSource(std::unique_ptr<RowSource> outer, int outerKey, const TableStorage &inner,
+                              const TreeVariant &innerIndex, RowPredicate innerFilter, bool outerIsLeft,
+                              RowPredicate residual)
+            : outer(std::move(outer)), outerKey(outerKey), inner(inner), innerIndex(innerIndex),
+              innerFilter(std::move(innerFilter)), outerIsLeft(outerIsLeft), residual(std::move(residual)) {}
+
+        bool next(Row &out) override
+        {
+            while (outer->next(outerRow))
+            {
+                IndexNode location;
+                if (!indexSearch(innerIndex, outerRow[outerKey], location))
+                    continue;
+                if (!inner.readRow(location, innerRow))
+                    continue;
+                if (innerFilter && !innerFilter(innerRow))
+                    continue;
+                if (outerIsLeft)
+                    concatRows(outerRow, innerRow, out);
+                else
+                    concatRows(innerRow, outerRow, out);
+                if (!residual || residual(out))
+                    return true;
+            }
+            return false;
+        }
+    };
+
+    // Walks both join-key indexes in key order and fetches only the matching rows
+    template <typename K>
+    class MergeJoinSource : public RowSource
+    {
+    private:
+        KeyCursor<K> left, right;
+        const TableStorage &leftStorage;
+        const TableStorage &rightStorage;
+        RowPredicate leftFilter, rightFilter, residual;
+        Row leftRow, rightRow;
+
+    public:
+        template <typename Tree>
+        MergeJoinSource(std::shared_ptr<Tree> leftTree, const TableStorage &leftStorage,
+                        RowPredicate leftFilter, std::shared_ptr<Tree> rightTree,
+                        const TableStorage &rightStorage, RowPredicate rightFilter, RowPredicate residual)
+            : left(std::move(leftTree)), right(std::move(rightTree)), leftStorage(leftStorage),
+              rightStorage(rightStorage), leftFilter(std::move(leftFilter)), rightFilter(std::move(rightFilter)),
+              residual(std::move(residual)) {}
+
+        bool next(Row &out) override
+        {
+            while (left.valid() && right.valid())
+            {
+                if (left.key() < right.key())
+                {
+                    left.next();
+                    continue;
+                }
+                if (right.key() < left.key())
+                {
+                    right.next();
+                    continue;
+                }
+
+                IndexNode l = left.value(), r = right.value();
+                left.next();
+                right.next();
+                if (!leftStorage.readRow(l, leftRow) || (leftFilter && !leftFilter(leftRow)))
+                    continue;
+                if (!rightStorage.readRow(r, rightRow) || (rightFilter && !rightFilter(rightRow)))
+                    continue;
+                concatRows(leftRow, rightRow, out);
+                if (!residual || residual(out))
+                    return true;
+            }
+            return false;
+        }
+    };
+
+    template <typename Tree>
+    std::unique_ptr<RowSource> makeMergeJoinSource(const std::shared_ptr<Tree> &leftTree,
+                                                   const JoinInput &left, RowPredicate leftFilter,
+                                                   const JoinInput &right, RowPredicate rightFilter,
+                                                   RowPredicate residual)
+    {
+        const auto &rightTree = std::get<std::shared_ptr<Tree>>(*right.index);
+        return std::make_unique<MergeJoinSource<typename Tree::key_type>>(leftTree, *left.storage, std::move(leftFilter),
+                                                                          rightTree, *right.storage, std::move(rightFilter),
+                                                                          std::move(residual));
+    }
+
+    // Both join-key indexes must be ordered and of the same type (checked by chooseJoinPlan)
+    inline std::unique_ptr<RowSource> makeMergeJoin(const JoinInput &left, RowPredicate leftFilter,
+                                                    const JoinInput &right, RowPredicate rightFilter,
+                                                    RowPredicate residual)
+    {
+        return std::visit([&](const auto &leftTree) -> std::unique_ptr<RowSource>
+                          {
+                              if constexpr (OrderedIndex<std::decay_t<decltype(leftTree)>>::value)
+                                  return makeMergeJoinSource(leftTree, left, std::move(leftFilter), right,
+                                                             std::move(rightFilter), std::move(residual));
+                              else
+                                  throw std::runtime_error("❌ Merge join needs ordered indexes on both join keys"); },
+                          *left.index);
+    }
+};
+
+#endif // __JOIN_EXECUTOR
@@ -13,6 +13,7 @@
 #include <stdexcept>
 #include <cctype>
 #include <type_traits>
+#include "jsonWriter.hpp"
 
 class JSONParser {
 public:
@@ -309,65 +310,47 @@ private:
         }
     }
 
-    // Convert JSONValue to string representation
-    std::string valueToString(const JSONValue& val, int indent = 0) const {
-        std::string indentStr(indent, ' ');
-        std::string nextIndentStr(indent + 2, ' ');
-        
-        return std::visit([&](const auto& v) -> std::string {
+    // Render one value as indented text
+    std::string valueToString(const JSONValue& val) const {
+        JSONWriter writer(JSONWriter::Style::Pretty);
+        write(writer, val);
+        return writer.str();
+    }
+
+public:
+    // Constructor
+    JSONParser(const std::string& filePath = "") : filePath(filePath) {}
+
+    // Stream a value into a writer, objects come out in key order
+    static void write(JSONWriter& writer, const JSONValue& val) {
+        std::visit([&](const auto& v) {
             using T = std::decay_t<decltype(v)>;
-            
-            if constexpr (std::is_same_v<T, std::nullptr_t>) {
-                return "null";
-            } else if constexpr (std::is_same_v<T, bool>) {
-                return v ? "true" : "false";
-            } else if constexpr (std::is_same_v<T, int>) {
-                return std::to_string(v);
-            } else if constexpr (std::is_same_v<T, double>) {
-                return std::to_string(v);
-            } else if constexpr (std::is_same_v<T, std::string>) {
-                return "\"" + v + "\"";
-            } else if constexpr (std::is_same_v<T, JSONArray>) {
-                if (v.empty()) return "[]";
-                
-                std::string result = "[\n";
-                for (size_t i = 0; i < v.size(); ++i) {
-                    result += nextIndentStr + valueToString(v[i], indent + 2);
-                    if (i < v.size() - 1) result += ",";
-                    result += "\n";
+
+            if constexpr (std::is_same_v<T, JSONArray>) {
+                writer.beginArray();
+                for (const auto& item : v) {
+                    write(writer, item);
                 }
-                result += indentStr + "]";
-                return result;
+                writer.endArray();
             } else if constexpr (std::is_same_v<T, JSONObject>) {
-                if (v.empty()) return "{}";
-                
-                std::string result = "{\n";
-                auto it = v.begin();
-                for (size_t i = 0; i < v.size(); ++i, ++it) {
-                    result += nextIndentStr + "\"" + it->first + "\": " + 
-                             valueToString(it->second, indent + 2);
-                    if (i < v.size() - 1) result += ",";
-                    result += "\n";
+                writer.beginObject();
+                for (const auto& [key, item] : v) {
+                    writer.key(key);
+                    write(writer, item);
                 }
-                result += indentStr + "}";
-                return result;
+                writer.endObject();
+            } else {
+                writer.value(v);
             }
-            return "";
         }, val.value);
     }
 
-public:
-    // Constructor
-    JSONParser(const std::string& filePath = "") : filePath(filePath) {}
-
     // Append a JSON object from string
     bool appendFromString(const std::string& jsonStr) {
         try {
             size_t pos = 0;
             JSONValue value = parseValue(jsonStr, pos);
             data.push_back(std::move(value));
-            
-            std::cout << "Object appended successfully. Total objects: " << data.size() << std::endl;
             return true;
         } catch (const std::exception& e) {
             std::cerr << "Error parsing JSON: " << e.what() << std::endl;
@@ -378,13 +361,11 @@ public:
     // Append a simple object (key-value pairs)
     void appendObject(const JSONObject& obj) {
         data.push_back(JSONValue(obj));
-        std::cout << "Object appended successfully. Total objects: " << data.size() << std::endl;
     }
 
     // Append any JSONValue
     void appendValue(const JSONValue& value) {
         data.push_back(value);
-        std::cout << "Value appended successfully. Total objects: " << data.size() << std::endl;
     }
 
     // Get object by index
@@ -403,7 +384,6 @@ public:
         }
         
         data.erase(data.begin() + index);
-        std::cout << "Object at index " << index << " removed successfully." << std::endl;
         return true;
     }
 
@@ -415,7 +395,6 @@ public:
     // Clear all data
     void clear() {
         data.clear();
-        std::cout << "All data cleared." << std::endl;
     }
 
     // Save to file
@@ -434,24 +413,25 @@ public:
                 std::filesystem::create_directories(path.parent_path());
             }
             
-            std::ofstream file(targetPath);
+            std::ofstream file(targetPath, std::ios::binary);
             if (!file.is_open()) {
                 std::cerr << "Error: Cannot open file for writing: " << targetPath << std::endl;
                 return false;
             }
             
-            file << "[\n";
-            for (size_t i = 0; i < data.size(); ++i) {
-                file << "  " << valueToString(data[i], 2);
-                if (i < data.size() - 1) file << ",";
-                file << "\n";
+            JSONWriter writer(JSONWriter::Style::Pretty);
+            writer.beginArray();
+            for (const auto& item : data) {
+                write(writer, item);
             }
-            file << "]";
+            writer.endArray();
+            file.write(writer.str().data(), writer.str().size());
             
             file.close();
-            
-            std::cout << "Data saved successfully to: " << targetPath << std::endl;
-            std::cout << "Saved " << data.size() << " objects" << std::endl;
+            if (!file) {
+                std::cerr << "Error: Failed to write file: " << targetPath << std::endl;
+                return false;
+            }
             return true;
             
         } catch (const std::exception& e) {
@@ -499,14 +479,10 @@ public:
                 for (auto& item : arr) {
                     data.push_back(std::move(item));
                 }
-                std::cout << "Loaded " << arr.size() << " objects from: " << targetPath << std::endl;
             } else {
                 // If it's a single object, add it
                 data.push_back(std::move(loadedValue));
-                std::cout << "Loaded 1 object from: " << targetPath << std::endl;
             }
-            
-            std::cout << "Total objects in parser: " << data.size() << std::endl;
             return true;
             
         } catch (const std::exception& e) {
@@ -0,0 +1,233 @@
+#ifndef JSON_WRITER_HPP
+#define JSON_WRITER_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <charconv>
+#include <stdexcept>
+#include <unistd.h>
+
+// Streaming JSON output. Values are appended to one reusable buffer in
+// document order, commas and indentation are tracked on a small stack, so
+// output is linear in its size. With a file descriptor the buffer is written
+// out whenever it passes flushAt bytes. Numbers go through std::to_chars:
+// integers exactly, doubles in the shortest form that reads back the same.
+class JSONWriter {
+public:
+    enum class Style { Compact, Pretty };
+
+private:
+    struct Level {
+        bool object;
+        bool empty;
+    };
+
+    std::string out;
+    int fd = -1;
+    Style style;
+    size_t flushAt;
+    std::vector<Level> levels;
+    bool afterKey = false;
+
+    void newline() {
+        out += '\n';
+        out.append(levels.size() * 2, ' ');
+    }
+
+    // Separator and indentation before a value or a key
+    void beforeValue() {
+        if (afterKey) {
+            afterKey = false;
+            return;
+        }
+        if (levels.empty()) {
+            return;
+        }
+        Level &level = levels.back();
+        if (!level.empty) {
+            out += ',';
+        }
+        level.empty = false;
+        if (style == Style::Pretty) {
+            newline();
+        }
+    }
+
+    void afterValue() {
+        if (fd >= 0 && out.size() >= flushAt) {
+            flush();
+        }
+    }
+
+    void writeString(std::string_view text) {
+        static const char hex[] = "0123456789abcdef";
+        out += '"';
+        size_t run = 0;
+        for (size_t i = 0; i < text.size(); ++i) {
+            unsigned char c = static_cast<unsigned char>(text[i]);
+            if (c >= 0x20 && c != '"' && c != '\\') {
+                continue;
+            }
+            out.append(text.data() + run, i - run);
+            run = i + 1;
+            switch (c) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                case '\b': out += "\\b"; break;
+                case '\f': out += "\\f"; break;
+                default:
+                    out += "\\u00";
+                    out += hex[c >> 4];
+                    out += hex[c & 0xF];
+                    break;
+            }
+        }
+        out.append(text.data() + run, text.size() - run);
+        out += '"';
+    }
+
+    template <typename Number>
+    void writeNumber(Number number) {
+        char digits[32];
+        auto result = std::to_chars(digits, digits + sizeof(digits), number);
+        out.append(digits, result.ptr);
+    }
+
+    JSONWriter &open(char bracket, bool object) {
+        beforeValue();
+        out += bracket;
+        levels.push_back({object, true});
+        return *this;
+    }
+
+    JSONWriter &close(char bracket, bool object) {
+        if (levels.empty() || levels.back().object != object || afterKey) {
+            throw std::logic_error("JSONWriter: unbalanced container");
+        }
+        bool empty = levels.back().empty;
+        levels.pop_back();
+        if (!empty && style == Style::Pretty) {
+            newline();
+        }
+        out += bracket;
+        afterValue();
+        return *this;
+    }
+
+public:
+    // Output collects in the buffer, read it with str()
+    explicit JSONWriter(Style style = Style::Compact) : style(style), flushAt(SIZE_MAX) {}
+
+    // Output goes to fd in chunks of about flushAt bytes, call flush() at the end
+    JSONWriter(int fd, Style style, size_t flushAt = 64 * 1024) : fd(fd), style(style), flushAt(flushAt) {
+        out.reserve(flushAt);
+    }
+
+    JSONWriter(const JSONWriter &) = delete;
+    JSONWriter &operator=(const JSONWriter &) = delete;
+
+    JSONWriter &beginObject() { return open('{', true); }
+    JSONWriter &endObject() { return close('}', true); }
+    JSONWriter &beginArray() { return open('[', false); }
+    JSONWriter &endArray() { return close(']', false); }
+
+    JSONWriter &key(std::string_view name) {
+        if (levels.empty() || !levels.back().object || afterKey) {
+            throw std::logic_error("JSONWriter: key outside an object");
+        }
+        beforeValue();
+        writeString(name);
+        out += style == Style::Pretty ? ": " : ":";
+        afterKey = true;
+        return *this;
+    }
+
+    JSONWriter &value(std::nullptr_t) {
+        beforeValue();
+        out += "null";
+        afterValue();
+        return *this;
+    }
+
+    JSONWriter &value(bool flag) {
+        beforeValue();
+        out += flag ? "true" : "false";
+        afterValue();
+        return *this;
+    }
+
+    JSONWriter &value(int number) { return value(static_cast<int64_t>(number)); }
+
+    JSONWriter &value(int64_t number) {
+        beforeValue();
+        writeNumber(number);
+        afterValue();
+        return *this;
+    }
+
+    JSONWriter &value(uint64_t number) {
+        beforeValue();
+        writeNumber(number);
+        afterValue();
+        return *this;
+    }
+
+    // NaN and infinities have no JSON form and are written as null
+    JSONWriter &value(double number) {
+        beforeValue();
+        if (std::isfinite(number)) {
+            writeNumber(number);
+        } else {
+            out += "null";
+        }
+        afterValue();
+        return *this;
+    }
+
+    JSONWriter &value(std::string_view text) {
+        beforeValue();
+        writeString(text);
+        afterValue();
+        return *this;
+    }
+
+    // Without this overload a string literal would convert to bool
+    JSONWriter &value(const char *text) { return value(std::string_view(text)); }
+
+    JSONWriter &value(const std::string &text) { return value(std::string_view(text)); }
+
+    const std::string &str() const { return out; }
+
+    // Start a new document, the buffer keeps its capacity
+    void clear() {
+        out.clear();
+        levels.clear();
+        afterKey = false;
+    }
+
+    // Write the buffered output to the file descriptor
+    void flush() {
+        if (fd < 0) {
+            return;
+        }
+        const char *data = out.data();
+        size_t size = out.size();
+        while (size > 0) {
+            ssize_t written = ::write(fd, data, size);
+            if (written <= 0) {
+                throw std::runtime_error("❌ Failed to write JSON output");
+            }
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+        out.clear();
+    }
+};
+
+#endif // JSON_WRITER_HPP
@@ -14,6 +14,7 @@ std::string typeToString(TokenType TYPE);
 int main(int argc, char const *argv[]) {
     initialDatabseLoad();  // Load DB metadata
     initializePrimaryIndexBtrees();
+    vacuumWorker.start();
 
     vector<string> testSQLs = {
        R"(
@@ -54,5 +55,6 @@ CREATE TABLE testing(
         cout << "\n";
     }
 
+    vacuumWorker.stop();
     return 0;
 }
@@ -0,0 +1,1752 @@
+#ifndef __QUERY_EXECUTOR
+#define __QUERY_EXECUTOR
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <stdexcept>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <set>
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+#include "global.hpp"
+#include "rowStorage.hpp"
+#include "catalog.hpp"
+#include "joinExecutor.hpp"
+#include "tableStatistics.hpp"
+#include "jsonWriter.hpp"
+
+namespace QueryExecutor
+{
+    // Maps column references ("col" or "table.col") to positions in a row
+    struct RowLayout
+    {
+        std::vector<std::string> tables;
+        std::vector<std::string> names;
+
+        void addTable(const std::string &table, const TableStorage &storage)
+        {
+            for (const auto &column : storage.getColumns())
+            {
+                tables.push_back(table);
+                names.push_back(column->name);
+            }
+        }
+
+        // -1 when the reference does not name a column of this layout
+        int find(const std::string &ref) const
+        {
+            std::string table, column = ref;
+            size_t dot = ref.find('.');
+            if (dot != std::string::npos)
+            {
+                table = ref.substr(0, dot);
+                column = ref.substr(dot + 1);
+            }
+
+            int found = -1;
+            for (size_t i = 0; i < names.size(); ++i)
+            {
+                if (names[i] != column || (!table.empty() && tables[i] != table))
+                    continue;
+                if (found >= 0)
+                    throw std::runtime_error("Column reference '" + ref + "' is ambiguous");
+                found = static_cast<int>(i);
+            }
+            return found;
+        }
+
+        int resolve(const std::string &ref) const
+        {
+            int position = find(ref);
+            if (position < 0)
+                throw std::runtime_error("Unknown column '" + ref + "'");
+            return position;
+        }
+    };
+
+    struct ResultSet
+    {
+        std::vector<std::string> columns;
+        std::vector<Row> rows;
+    };
+
+    inline FieldValue literalValue(const Expression *expr)
+    {
+        switch (expr->getType())
+        {
+        case ASTNodeType::INT_LITERAL:
+            return static_cast<const IntLiteral *>(expr)->value;
+        case ASTNodeType::STRING_LITERAL:
+            return static_cast<const StringLiteral *>(expr)->value;
+        case ASTNodeType::BOOLEAN_LITERAL:
+            return static_cast<const BoolLiteral *>(expr)->value ? 1 : 0;
+        default:
+            return nullptr;
+        }
+    }
+
+    inline bool isLiteral(const Expression *expr)
+    {
+        ASTNodeType type = expr->getType();
+        return type == ASTNodeType::INT_LITERAL || type == ASTNodeType::STRING_LITERAL ||
+               type == ASTNodeType::BOOLEAN_LITERAL;
+    }
+
+    inline bool evaluate(const Expression *expr, const RowLayout &layout, const Row &row);
+
+    inline FieldValue evaluateValue(const Expression *expr, const RowLayout &layout, const Row &row)
+    {
+        if (expr->getType() == ASTNodeType::IDENTIFIER)
+        {
+            return row[layout.resolve(static_cast<const Identifier *>(expr)->name)];
+        }
+        if (isLiteral(expr))
+        {
+            return literalValue(expr);
+        }
+        return evaluate(expr, layout, row) ? 1 : 0;
+    }
+
+    // Three-way comparison as conditions see it: values of different types compare as text
+    inline int compareMixed(const FieldValue &left, const FieldValue &right)
+    {
+        if (left.index() == right.index())
+            return compareFields(left, right);
+        int c = fieldToString(left).compare(fieldToString(right));
+        return c < 0 ? -1 : (c > 0 ? 1 : 0);
+    }
+
+    inline bool compareWith(ComparisonOperator op, const FieldValue &left, const FieldValue &right)
+    {
+        if (std::holds_alternative<std::nullptr_t>(left) || std::holds_alternative<std::nullptr_t>(right))
+            return false;
+
+        int c = compareMixed(left, right);
+        switch (op)
+        {
+        case ComparisonOperator::EQUAL:
+            return c == 0;
+        case ComparisonOperator::NOT_EQUAL:
+            return c != 0;
+        case ComparisonOperator::GREATER:
+            return c > 0;
+        case ComparisonOperator::LESS:
+            return c < 0;
+        case ComparisonOperator::GREATER_EQUAL:
+            return c >= 0;
+        case ComparisonOperator::LESS_EQUAL:
+            return c <= 0;
+        }
+        return false;
+    }
+
+    // Whether some value in [min, max] can satisfy `value op literal`. INT
+    // values against a text literal compare as text, which does not follow
+    // their numeric order, so such a range always may.
+    inline bool rangeMayMatch(ComparisonOperator op, const FieldValue &min, const FieldValue &max,
+                              const FieldValue &literal)
+    {
+        if (std::holds_alternative<std::nullptr_t>(literal))
+            return false;
+        if (std::holds_alternative<int>(min) && !std::holds_alternative<int>(literal))
+            return true;
+
+        int low = compareMixed(min, literal);
+        int high = compareMixed(max, literal);
+        switch (op)
+        {
+        case ComparisonOperator::EQUAL:
+            return low <= 0 && high >= 0;
+        case ComparisonOperator::NOT_EQUAL:
+            return low != 0 || high != 0;
+        case ComparisonOperator::GREATER:
+            return high > 0;
+        case ComparisonOperator::LESS:
+            return low < 0;
+        case ComparisonOperator::GREATER_EQUAL:
+            return high >= 0;
+        case ComparisonOperator::LESS_EQUAL:
+            return low <= 0;
+        }
+        return true;
+    }
+
+    inline bool evaluate(const Expression *expr, const RowLayout &layout, const Row &row)
+    {
+        switch (expr->getType())
+        {
+        case ASTNodeType::COMPARISON_EXPRESSION:
+        {
+            const auto *comp = static_cast<const ComparisonExpression *>(expr);
+            return compareWith(comp->op, evaluateValue(comp->left.get(), layout, row),
+                               evaluateValue(comp->right.get(), layout, row));
+        }
+        case ASTNodeType::LOGICAL_EXPRESSION:
+        {
+            const auto *log = static_cast<const LogicalExpression *>(expr);
+            if (log->op == LogicalOperator::AND)
+                return evaluate(log->left.get(), layout, row) && evaluate(log->right.get(), layout, row);
+            return evaluate(log->left.get(), layout, row) || evaluate(log->right.get(), layout, row);
+        }
+        case ASTNodeType::PARENTHESIZED_EXPRESSION:
+            return evaluate(static_cast<const ParenthesizedExpression *>(expr)->expression.get(), layout, row);
+        case ASTNodeType::BOOLEAN_LITERAL:
+            return static_cast<const BoolLiteral *>(expr)->value;
+        default:
+        {
+            FieldValue value = evaluateValue(expr, layout, row);
+            return std::holds_alternative<int>(value) && std::get<int>(value) != 0;
+        }
+        }
+    }
+
+    // Flatten a tree of ANDs into its conjuncts
+    inline void collectConjuncts(const Expression *expr, std::vector<const Expression *> &out)
+    {
+        if (!expr)
+            return;
+        if (expr->getType() == ASTNodeType::PARENTHESIZED_EXPRESSION)
+        {
+            collectConjuncts(static_cast<const ParenthesizedExpression *>(expr)->expression.get(), out);
+            return;
+        }
+        if (expr->getType() == ASTNodeType::LOGICAL_EXPRESSION)
+        {
+            const auto *log = static_cast<const LogicalExpression *>(expr);
+            if (log->op == LogicalOperator::AND)
+            {
+                collectConjuncts(log->left.get(), out);
+                collectConjuncts(log->right.get(), out);
+                return;
+            }
+        }
+        out.push_back(expr);
+    }
+
+    // True when every column the expression mentions is part of the layout
+    inline bool referencesOnly(const Expression *expr, const RowLayout &layout)
+    {
+        switch (expr->getType())
+        {
+        case ASTNodeType::IDENTIFIER:
+            return layout.find(static_cast<const Identifier *>(expr)->name) >= 0;
+        case ASTNodeType::COMPARISON_EXPRESSION:
+        {
+            const auto *comp = static_cast<const ComparisonExpression *>(expr);
+            return referencesOnly(comp->left.get(), layout) && referencesOnly(comp->right.get(), layout);
+        }
+        case ASTNodeType::LOGICAL_EXPRESSION:
+        {
+            const auto *log = static_cast<const LogicalExpression *>(expr);
+            return referencesOnly(log->left.get(), layout) && referencesOnly(log->right.get(), layout);
+        }
+        case ASTNodeType::PARENTHESIZED_EXPRESSION:
+            return referencesOnly(static_cast<const ParenthesizedExpression *>(expr)->expression.get(), layout);
+        default:
+            return true;
+        }
+    }
+
+    // Every column name the expression mentions
+    inline void collectColumnRefs(const Expression *expr, std::vector<std::string> &out)
+    {
+        switch (expr->getType())
+        {
+        case ASTNodeType::IDENTIFIER:
+            out.push_back(static_cast<const Identifier *>(expr)->name);
+            break;
+        case ASTNodeType::COMPARISON_EXPRESSION:
+        {
+            const auto *comp = static_cast<const ComparisonExpression *>(expr);
+            collectColumnRefs(comp->left.get(), out);
+            collectColumnRefs(comp->right.get(), out);
+            break;
+        }
+        case ASTNodeType::LOGICAL_EXPRESSION:
+        {
+            const auto *log = static_cast<const LogicalExpression *>(expr);
+            collectColumnRefs(log->left.get(), out);
+            collectColumnRefs(log->right.get(), out);
+            break;
+        }
+        case ASTNodeType::PARENTHESIZED_EXPRESSION:
+            collectColumnRefs(static_cast<const ParenthesizedExpression *>(expr)->expression.get(), out);
+            break;
+        default:
+            break;
+        }
+    }
+
+    // How a single table is read: an index point lookup or a full scan, plus filters
+    // Bounds on one column collected from `col < lit`, `col >= lit`, ...
+    struct KeyRange
+    {
+        bool hasLow = false, lowInclusive = false;
+        bool hasHigh = false, highInclusive = false;
+        FieldValue low, high;
+        int conditions = 0;
+
+        void tighten(ComparisonOperator op, const FieldValue &value)
+        {
+            conditions++;
+            bool inclusive = op == ComparisonOperator::GREATER_EQUAL || op == ComparisonOperator::LESS_EQUAL;
+            if (op == ComparisonOperator::GREATER || op == ComparisonOperator::GREATER_EQUAL)
+            {
+                int c = hasLow ? compareFields(value, low) : 1;
+                if (c > 0 || (c == 0 && !inclusive))
+                {
+                    low = value;
+                    lowInclusive = inclusive;
+                }
+                hasLow = true;
+            }
+            else
+            {
+                int c = hasHigh ? compareFields(value, high) : -1;
+                if (c < 0 || (c == 0 && !inclusive))
+                {
+                    high = value;
+                    highInclusive = inclusive;
+                }
+                hasHigh = true;
+            }
+        }
+
+        bool aboveHigh(const FieldValue &value) const
+        {
+            if (!hasHigh)
+                return false;
+            int c = compareFields(value, high);
+            return c > 0 || (c == 0 && !highInclusive);
+        }
+    };
+
+    struct TableAccess
+    {
+        std::string table;
+        std::shared_ptr<const Catalog::TableEntry> entry; // keeps the index pointers below alive
+        std::shared_ptr<TableStorage> storage;
+        std::shared_lock<std::shared_mutex> statement; // keeps vacuum from moving rows under us
+        RowLayout layout;
+        std::vector<const Expression *> filters;
+        const TreeVariant *lookupIndex = nullptr;
+        std::string lookupColumn;
+        FieldValue lookupKey;
+        const TreeVariant *rangeIndex = nullptr; // ordered walk over a key range instead of a scan
+        std::string rangeColumn;
+        const CompositeIndex *compositeIndex = nullptr; // set when rangeIndex is its tree, range holds encoded keys
+        bool indexOnly = false; // the composite index covers every column read, rows are decoded from its keys
+        KeyRange range;
+        size_t firstKeyBatch = KeyCursor<int>::KEY_BATCH; // smaller when a LIMIT needs only a few keys
+        bool needsSort = false; // ORDER BY is not satisfied by the access order
+        std::vector<bool> columns; // positions a scan must decode, empty = all; columnar tables skip the rest
+        std::vector<ColumnStorage::ColumnFilter> columnFilters; // `column op literal` filters a columnar scan tests first
+        double tableRows = 0;
+        double estimatedRows = 0;
+        double cost = 0;
+        mutable size_t rowsExamined = 0; // rows read before filtering, for EXPLAIN ANALYZE
+
+        bool passes(const Row &row) const
+        {
+            for (const Expression *filter : filters)
+            {
+                if (!evaluate(filter, layout, row))
+                    return false;
+            }
+            return true;
+        }
+    };
+
+    // Used when the table has no ANALYZE statistics
+    constexpr double EQUALITY_SELECTIVITY = 0.1;
+    constexpr double RANGE_SELECTIVITY = 0.33;
+    constexpr double DEFAULT_SELECTIVITY = 0.5;
+    constexpr double SORT_COMPARE_COST = 0.2;
+
+    inline double sortCost(double rows)
+    {
+        return rows * std::log2(std::max(2.0, rows)) * SORT_COMPARE_COST;
+    }
+
+    inline double equalitySelectivity(const Statistics::ColumnStatistics *stats)
+    {
+        if (!stats)
+            return EQUALITY_SELECTIVITY;
+        return stats->distinct > 0 ? (1 - stats->nullFraction) / stats->distinct : 0;
+    }
+
+    inline double rangeSelectivity(const Statistics::ColumnStatistics *stats, const KeyRange &range)
+    {
+        if (!stats || stats->bounds.size() < 2)
+            return std::pow(RANGE_SELECTIVITY, range.conditions);
+
+        double high = range.hasHigh ? stats->fractionBelow(range.high, range.highInclusive) : 1.0;
+        double low = range.hasLow ? stats->fractionBelow(range.low, !range.lowInclusive) : 0.0;
+        return std::max(0.0, high - low) * (1 - stats->nullFraction);
+    }
+
+    // Column compared against a literal, e.g. `id = 5` or `5 = id`
+    inline bool columnLiteralComparison(const Expression *expr, std::string &column, FieldValue &literal,
+                                        ComparisonOperator &op)
+    {
+        if (expr->getType() != ASTNodeType::COMPARISON_EXPRESSION)
+            return false;
+        const auto *comp = static_cast<const ComparisonExpression *>(expr);
+        const Expression *l = comp->left.get();
+        const Expression *r = comp->right.get();
+        op = comp->op;
+
+        if (l->getType() == ASTNodeType::IDENTIFIER && isLiteral(r))
+        {
+            column = static_cast<const Identifier *>(l)->name;
+            literal = literalValue(r);
+            return true;
+        }
+        if (r->getType() == ASTNodeType::IDENTIFIER && isLiteral(l))
+        {
+            column = static_cast<const Identifier *>(r)->name;
+            literal = literalValue(l);
+            switch (op)
+            {
+            case ComparisonOperator::GREATER:
+                op = ComparisonOperator::LESS;
+                break;
+            case ComparisonOperator::LESS:
+                op = ComparisonOperator::GREATER;
+                break;
+            case ComparisonOperator::GREATER_EQUAL:
+                op = ComparisonOperator::LESS_EQUAL;
+                break;
+            case ComparisonOperator::LESS_EQUAL:
+                op = ComparisonOperator::GREATER_EQUAL;
+                break;
+            default:
+                break;
+            }
+            return true;
+        }
+        return false;
+    }
+
+    // An index only holds one location per key, so it can stand in for a
+    // scan only on columns that cannot repeat
+    inline const TreeVariant *uniqueIndex(const Catalog::TableEntry &table, const TableGlobalColumnNode &column)
+    {
+        return column.isPrimary || column.isUnique ? table.index(column.name) : nullptr;
+    }
+
+    inline bool indexAccepts(const TreeVariant &index, const FieldValue &value)
+    {
+        return std::visit([&value](const auto &tree)
+                          { return std::holds_alternative<IndexKey<decltype(tree)>>(value); },
+                          index);
+    }
+
+    // A composite key field holds the column's value as stored, so only a
+    // literal of that type can bound it
+    inline bool compositeAccepts(const TableGlobalColumnNode &column, const FieldValue &value)
+    {
+        TreeVariant probe;
+        return makeIndexTree(column.type, probe) && indexAccepts(probe, value);
+    }
+
+    // Walk the ORDER BY column's index in key order when that beats the
+    // chosen access plus a sort; `limit` bounds how far the walk goes.
+    // The index holds no NULL keys, so the column must be NOT NULL or
+    // compared with a literal (`compared`), which no NULL passes.
+    inline void planOrderedWalk(TableAccess &access, const std::map<int, KeyRange> &ranges, int orderPosition,
+                                bool compared, double orderFraction, double selectivity, size_t limit)
+    {
+        const auto &orderNode = access.storage->getColumns()[orderPosition];
+        const TreeVariant *index = uniqueIndex(*access.entry, *orderNode);
+        auto bounds = ranges.find(orderPosition);
+        KeyRange range = bounds == ranges.end() ? KeyRange() : bounds->second;
+        if (!index || !indexOrdered(*index) || (range.hasLow && !indexAccepts(*index, range.low)) ||
+            (range.hasHigh && !indexAccepts(*index, range.high)) || (!compared && !isNotNullColumn(*orderNode)))
+            return;
+
+        // Rows walked before the LIMIT is met: the key range, cut short by the
+        // share of those rows the remaining filters let through
+        double walked = access.tableRows * orderFraction;
+        double passing = orderFraction > 0 ? selectivity / orderFraction : 0;
+        if (limit != SIZE_MAX && passing > 0)
+            walked = std::min(walked, std::ceil(limit / passing));
+        double orderedCost = JoinExecutor::probeCost(access.tableRows) +
+                             walked * (JoinExecutor::LEAF_STEP_COST + JoinExecutor::RANDOM_FETCH_COST);
+        if (orderedCost > access.cost + sortCost(access.estimatedRows))
+            return;
+
+        access.rangeIndex = index;
+        access.rangeColumn = orderNode->name;
+        access.range = range;
+        access.cost = orderedCost;
+        access.needsSort = false;
+        if (limit != SIZE_MAX)
+            access.firstKeyBatch = static_cast<size_t>(std::min(walked, static_cast<double>(KeyCursor<int>::KEY_BATCH)));
+    }
+
+    // A composite index narrows the rows by its leading columns compared for
+    // equality plus a range on the column after them. Its keys sort like the
+    // tuple of values, so those rows are one range of encoded keys, walked by
+    // the same cursor as an index range scan.
+    inline void planCompositeAccess(TableAccess &access, const std::map<int, FieldValue> &equals,
+                                    const std::map<int, KeyRange> &ranges, const Statistics::TableStatistics *stats,
+                                    const OrderByClause *order, int orderPosition, double selectivity, size_t limit,
+                                    const std::vector<bool> &needed)
+    {
+        const auto &columns = access.storage->getColumns();
+        auto columnStats = [&](uint32_t position)
+        { return stats ? stats->column(columns[position]->name) : nullptr; };
+
+        double bestCost = access.cost + (access.needsSort ? sortCost(access.estimatedRows) : 0);
+        for (const auto &index : access.entry->compositeIndexes)
+        {
+            std::string prefix;
+            double fraction = 1.0;
+            size_t matched = 0;
+            bool orderInPrefix = false;
+            for (; matched < index.columns.size(); ++matched)
+            {
+                uint32_t position = index.columns[matched];
+                auto equal = equals.find(position);
+                if (equal == equals.end() || !compositeAccepts(*columns[position], equal->second))
+                    break;
+                CompositeKey::appendField(prefix, equal->second);
+                fraction *= equalitySelectivity(columnStats(position));
+                orderInPrefix = orderInPrefix || static_cast<int>(position) == orderPosition;
+            }
+
+            KeyRange keys;
+            keys.lowInclusive = true;
+            keys.low = prefix;
+            keys.hasLow = !prefix.empty();
+            std::string high;
+            keys.hasHigh = CompositeKey::successor(prefix, high);
+            keys.high = high;
+
+            bool bounded = matched > 0;
+            if (matched < index.columns.size())
+            {
+                uint32_t position = index.columns[matched];
+                auto bounds = ranges.find(position);
+                if (bounds != ranges.end() &&
+                    (!bounds->second.hasLow || compositeAccepts(*columns[position], bounds->second.low)) &&
+                    (!bounds->second.hasHigh || compositeAccepts(*columns[position], bounds->second.high)))
+                {
+                    const KeyRange &range = bounds->second;
+                    fraction *= rangeSelectivity(columnStats(position), range);
+                    bounded = true;
+                    if (range.hasLow)
+                    {
+                        std::string key = prefix;
+                        CompositeKey::appendField(key, range.low);
+                        if (range.lowInclusive)
+                            keys.low = key;
+                        else if (CompositeKey::successor(key, high))
+                            keys.low = high;
+                    }
+                    else
+                    {
+                        // NULLs sort first, start at the first value of the bound's type
+                        std::string key = prefix;
+                        CompositeKey::appendField(key, range.high);
+                        keys.low = key.substr(0, prefix.size() + 1);
+                    }
+                    keys.hasLow = true;
+                    if (range.hasHigh)
+                    {
+                        std::string key = prefix;
+                        CompositeKey::appendField(key, range.high);
+                        keys.hasHigh = true;
+                        if (!range.highInclusive)
+                            keys.high = key;
+                        else if (CompositeKey::successor(key, high))
+                            keys.high = high;
+                    }
+                }
+            }
+
+            // The walk is in ORDER BY order when the column is fixed by the
+            // prefix or is the ascending column right after it
+            bool ordered = order && (orderInPrefix || (!order->descending && matched < index.columns.size() &&
+                                                       static_cast<int>(index.columns[matched]) == orderPosition));
+            // An index holding every column read answers without touching the data file
+            bool covering = !needed.empty();
+            for (size_t i = 0; i < needed.size() && covering; ++i)
+                covering = !needed[i] || index.covers(static_cast<uint32_t>(i));
+            if (!bounded && !ordered && !covering)
+                continue;
+
+            double walked = access.tableRows * fraction;
+            double passing = fraction > 0 ? selectivity / fraction : 0;
+            if (ordered && limit != SIZE_MAX && passing > 0)
+                walked = std::min(walked, std::ceil(limit / passing));
+            double fetch = covering ? 0 : JoinExecutor::RANDOM_FETCH_COST;
+            double cost = JoinExecutor::probeCost(access.tableRows) - JoinExecutor::RANDOM_FETCH_COST + fetch +
+                          walked * (JoinExecutor::LEAF_STEP_COST + fetch);
+            double total = cost + (order && !ordered ? sortCost(access.estimatedRows) : 0);
+            if (total >= bestCost)
+                continue;
+
+            bestCost = total;
+            access.rangeIndex = &index.tree;
+            access.rangeColumn = index.definition.name;
+            access.compositeIndex = &index;
+            access.indexOnly = covering;
+            access.range = keys;
+            access.cost = cost;
+            access.needsSort = order && !ordered;
+            access.firstKeyBatch = ordered && limit != SIZE_MAX
+                                       ? static_cast<size_t>(std::min(walked, static_cast<double>(KeyCursor<int>::KEY_BATCH)))
+                                       : KeyCursor<int>::KEY_BATCH;
+        }
+    }
+
+    // Pick a point lookup, an index range walk or a sequential scan by
+    // estimated cost. Selectivities come from ANALYZE when available. With an
+    // ORDER BY, walking a matching index in key order competes against the
+    // cheapest access plus a sort; `limit` bounds how far that walk goes.
+    // Composite indexes compete last, for both the filter and the order;
+    // `references` names the columns the caller reads, so an index holding
+    // all of them can serve an index-only scan (nullptr: whole rows).
+    inline TableAccess planTableAccess(const std::string &dbName, const std::string &tableName,
+                                       const std::vector<const Expression *> &conjuncts,
+                                       const OrderByClause *order = nullptr, size_t limit = SIZE_MAX,
+                                       const std::vector<std::string> *references = nullptr)
+    {
+        TableAccess access;
+        access.table = tableName;
+        auto locked = Catalog::lockTable(dbName, tableName);
+        access.entry = std::move(locked.entry);
+        access.storage = access.entry->storage();
+        access.statement = std::move(locked.statement);
+        access.layout.addTable(tableName, *access.storage);
+        access.tableRows = static_cast<double>(access.storage->getLiveRowCount());
+        auto stats = Statistics::getStatistics(dbName, tableName);
+        const auto &columns = access.storage->getColumns();
+
+        double selectivity = 1.0;
+        bool uniqueHit = false;
+        std::map<int, KeyRange> ranges;
+        std::map<int, FieldValue> equals;
+        std::set<int> compared; // columns compared with a literal, NULL never passes
+        for (const Expression *conjunct : conjuncts)
+        {
+            if (!referencesOnly(conjunct, access.layout))
+                continue;
+            access.filters.push_back(conjunct);
+
+            std::string column;
+            FieldValue literal;
+            ComparisonOperator op;
+            if (!columnLiteralComparison(conjunct, column, literal, op))
+            {
+                selectivity *= DEFAULT_SELECTIVITY;
+                continue;
+            }
+
+            int position = access.layout.resolve(column);
+            compared.insert(position);
+            const auto &columnNode = columns[position];
+            const Statistics::ColumnStatistics *columnStats = stats ? stats->column(columnNode->name) : nullptr;
+            if (access.storage->isColumnar())
+            {
+                access.columnFilters.push_back({static_cast<size_t>(position), [op, literal](const FieldValue &value)
+                                                { return compareWith(op, value, literal); },
+                                                [op, literal](const FieldValue &min, const FieldValue &max)
+                                                { return rangeMayMatch(op, min, max, literal); },
+                                                op == ComparisonOperator::EQUAL ? literal : FieldValue(nullptr)});
+            }
+
+            if (op == ComparisonOperator::NOT_EQUAL)
+            {
+                double nonNull = columnStats ? 1 - columnStats->nullFraction : 1.0;
+                selectivity *= std::max(0.0, nonNull - equalitySelectivity(columnStats));
+                continue;
+            }
+            if (op != ComparisonOperator::EQUAL)
+            {
+                ranges[position].tighten(op, literal);
+                continue;
+            }
+
+            if (columnNode->isPrimary || columnNode->isUnique)
+                uniqueHit = true;
+            selectivity *= equalitySelectivity(columnStats);
+            equals.emplace(position, literal);
+
+            // A literal of another type than the keys is compared as a filter, the index would miss it
+            const TreeVariant *index = uniqueIndex(*access.entry, *columnNode);
+            if (index && !access.lookupIndex && indexAccepts(*index, literal))
+            {
+                access.lookupIndex = index;
+                access.lookupColumn = columnNode->name;
+                access.lookupKey = literal;
+            }
+        }
+
+        int orderPosition = order ? access.layout.resolve(order->column) : -1;
+        double orderFraction = 1.0;
+        double rangeRows = 0;
+        for (const auto &entry : ranges)
+        {
+            const auto &columnNode = columns[entry.first];
+            double rangeFraction = rangeSelectivity(stats ? stats->column(columnNode->name) : nullptr, entry.second);
+            selectivity *= rangeFraction;
+            if (entry.first == orderPosition)
+                orderFraction = rangeFraction;
+
+            const TreeVariant *index = uniqueIndex(*access.entry, *columnNode);
+            bool typed = index && indexOrdered(*index) && (!entry.second.hasLow || indexAccepts(*index, entry.second.low)) &&
+                         (!entry.second.hasHigh || indexAccepts(*index, entry.second.high));
+            double rows = access.tableRows * rangeFraction;
+            if (typed && (!access.rangeIndex || rows < rangeRows))
+            {
+                access.rangeIndex = index;
+                access.rangeColumn = columnNode->name;
+                access.range = entry.second;
+                rangeRows = rows;
+            }
+        }
+
+        access.estimatedRows = uniqueHit ? 1.0 : std::max(1.0, access.tableRows * selectivity);
+        double scanCost = JoinExecutor::SEQ_ROW_COST * access.tableRows;
+        if (access.lookupIndex)
+        {
+            access.rangeIndex = nullptr;
+            access.cost = JoinExecutor::probeCost(access.tableRows, access.lookupIndex);
+        }
+        else if (access.rangeIndex)
+        {
+            double rangeCost = JoinExecutor::probeCost(access.tableRows) +
+                               rangeRows * (JoinExecutor::LEAF_STEP_COST + JoinExecutor::RANDOM_FETCH_COST);
+            if (rangeCost < scanCost)
+            {
+                access.cost = rangeCost;
+            }
+            else
+            {
+                access.rangeIndex = nullptr;
+                access.cost = scanCost;
+            }
+        }
+        else
+        {
+            access.cost = scanCost;
+        }
+
+        // A point lookup returns at most one row, which is always in order
+        access.needsSort = order && !access.lookupIndex;
+        if (access.needsSort && !order->descending) // leaves only link forward, descending order is sorted
+            planOrderedWalk(access, ranges, orderPosition, compared.count(orderPosition) > 0, orderFraction,
+                            selectivity, limit);
+        if (access.lookupIndex)
+            return access;
+
+        std::vector<bool> needed; // empty when whole rows are read
+        if (references)
+        {
+            needed.assign(access.layout.names.size(), false);
+            for (const auto &reference : *references)
+            {
+                int position = access.layout.find(reference);
+                if (position < 0)
+                {
+                    needed.clear();
+                    break;
+                }
+                needed[position] = true;
+            }
+        }
+        planCompositeAccess(access, equals, ranges, stats.get(), order, orderPosition, selectivity, limit, needed);
+        return access;
+    }
+
+    // Every column a SELECT reads, false when it reads them all
+    inline bool selectReferences(const SelectStatement &stmt, const std::vector<const Expression *> &conjuncts,
+                                 std::vector<std::string> &refs)
+    {
+        for (const auto &column : stmt.columns)
+        {
+            if (column == "*")
+                return false;
+            refs.push_back(column);
+        }
+        for (const Expression *conjunct : conjuncts)
+            collectColumnRefs(conjunct, refs);
+        if (stmt.orderByClause)
+            refs.push_back(stmt.orderByClause->column);
+        if (stmt.joinClause)
+        {
+            refs.push_back(stmt.joinClause->leftTable + "." + stmt.joinClause->leftColumn);
+            refs.push_back(stmt.joinClause->rightTable + "." + stmt.joinClause->rightColumn);
+        }
+        return true;
+    }
+
+    // Let a columnar scan skip the columns the SELECT never looks at
+    inline void restrictColumns(TableAccess &access, const SelectStatement &stmt,
+                                const std::vector<const Expression *> &conjuncts)
+    {
+        std::vector<std::string> refs;
+        if (!access.storage->isColumnar() || !selectReferences(stmt, conjuncts, refs))
+            return;
+
+        access.columns.assign(access.layout.names.size(), false);
+        for (const auto &ref : refs)
+        {
+            int position = access.layout.find(ref);
+            if (position >= 0)
+                access.columns[position] = true;
+        }
+    }
+
+    inline std::string operatorSymbol(ComparisonOperator op)
+    {
+        switch (op)
+        {
+        case ComparisonOperator::EQUAL:
+            return "=";
+        case ComparisonOperator::NOT_EQUAL:
+            return "!=";
+        case ComparisonOperator::GREATER:
+            return ">";
+        case ComparisonOperator::LESS:
+            return "<";
+        case ComparisonOperator::GREATER_EQUAL:
+            return ">=";
+        case ComparisonOperator::LESS_EQUAL:
+            return "<=";
+        }
+        return "?";
+    }
+
+    inline std::string expressionToString(const Expression *expr)
+    {
+        switch (expr->getType())
+        {
+        case ASTNodeType::IDENTIFIER:
+            return static_cast<const Identifier *>(expr)->name;
+        case ASTNodeType::STRING_LITERAL:
+            return "'" + static_cast<const StringLiteral *>(expr)->value + "'";
+        case ASTNodeType::INT_LITERAL:
+        case ASTNodeType::BOOLEAN_LITERAL:
+            return fieldToString(literalValue(expr));
+        case ASTNodeType::COMPARISON_EXPRESSION:
+        {
+            const auto *comp = static_cast<const ComparisonExpression *>(expr);
+            return expressionToString(comp->left.get()) + " " + operatorSymbol(comp->op) + " " +
+                   expressionToString(comp->right.get());
+        }
+        case ASTNodeType::LOGICAL_EXPRESSION:
+        {
+            const auto *logical = static_cast<const LogicalExpression *>(expr);
+            return expressionToString(logical->left.get()) +
+                   (logical->op == LogicalOperator::AND ? " AND " : " OR ") +
+                   expressionToString(logical->right.get());
+        }
+        case ASTNodeType::PARENTHESIZED_EXPRESSION:
+            return "(" + expressionToString(static_cast<const ParenthesizedExpression *>(expr)->expression.get()) + ")";
+        default:
+            return "?";
+        }
+    }
+
+    inline std::string joinExpressions(const std::vector<const Expression *> &exprs)
+    {
+        std::string text;
+        for (const Expression *expr : exprs)
+            text += (text.empty() ? "" : " AND ") + expressionToString(expr);
+        return text;
+    }
+
+    // One operator of the physical plan, the actual* fields are filled in by EXPLAIN ANALYZE
+    struct PlanNode
+    {
+        std::string op;
+        std::string detail;
+        double estimatedRows = 0;
+        double cost = 0;
+
+        bool executed = false;
+        double millis = -1; // < 0 when the time is only known as part of the parent
+        size_t loops = 1;
+        size_t rowsIn = 0;
+        size_t rowsOut = 0;
+        uint64_t pagesRead = 0;
+        uint64_t pageHits = 0;
+        uint64_t spillBytes = 0; // every operator runs in memory, nothing spills yet
+
+        std::vector<PlanNode> children;
+    };
+
+    inline PlanNode describeAccess(const TableAccess &access)
+    {
+        PlanNode node;
+        if (access.lookupIndex)
+        {
+            node.op = indexOrdered(*access.lookupIndex) ? "Index Lookup" : "Hash Index Lookup";
+            node.detail = "on " + access.table + " using " + access.lookupColumn + " = " + fieldToString(access.lookupKey);
+        }
+        else if (access.compositeIndex)
+        {
+            const IndexDefinition &definition = access.compositeIndex->definition;
+            node.op = access.indexOnly ? "Index Only Scan" : "Composite Index Scan";
+            node.detail = "on " + access.table + " using " + access.rangeColumn + " (";
+            for (size_t i = 0; i < definition.columns.size(); ++i)
+                node.detail += (i ? ", " : "") + definition.columns[i];
+            node.detail += ")";
+            for (size_t i = 0; i < definition.include.size(); ++i)
+                node.detail += (i ? ", " : " include (") + definition.include[i];
+            if (!definition.include.empty())
+                node.detail += ")";
+        }
+        else if (access.rangeIndex)
+        {
+            node.op = "Index Range Scan";
+            node.detail = "on " + access.table + " using " + access.rangeColumn;
+        }
+        else if (access.storage->isColumnar())
+        {
+            node.op = "Columnar Scan";
+            node.detail = "on " + access.table;
+            if (!access.columns.empty())
+            {
+                std::string read;
+                for (size_t i = 0; i < access.columns.size(); ++i)
+                {
+                    if (access.columns[i])
+                        read += (read.empty() ? "" : ", ") + access.layout.names[i];
+                }
+                node.detail += " columns: " + (read.empty() ? std::string("none") : read);
+            }
+        }
+        else
+        {
+            node.op = "Seq Scan";
+            node.detail = "on " + access.table;
+        }
+        if (!access.filters.empty())
+            node.detail += " filter: " + joinExpressions(access.filters);
+        node.estimatedRows = access.estimatedRows;
+        node.cost = access.cost;
+        return node;
+    }
+
+    // Charges the wall time of every pull and the rows it produced to a plan node
+    class ProfiledSource : public RowSource
+    {
+    private:
+        std::unique_ptr<RowSource> child;
+        PlanNode *node;
+
+    public:
+        ProfiledSource(std::unique_ptr<RowSource> child, PlanNode *node) : child(std::move(child)), node(node)
+        {
+            node->millis = 0;
+        }
+
+        bool next(Row &row) override
+        {
+            auto start = std::chrono::steady_clock::now();
+            bool produced = child->next(row);
+            node->millis += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            node->executed = true;
+            if (produced)
+                node->rowsOut++;
+            return produced;
+        }
+    };
+
+    // Produces the rows of a planned table access one at a time. The access
+    // must outlive the source.
+    class AccessSource : public RowSource
+    {
+    private:
+        const TableAccess &access;
+        bool lookupDone = false;
+        std::variant<std::monostate, KeyCursor<int>, KeyCursor<std::string>> keys;
+        TableStorage::Scanner scanner;
+
+        template <typename K>
+        bool nextInRange(KeyCursor<K> &cursor, int64_t &rowId, IndexNode &location, Row &row)
+        {
+            for (; cursor.valid(); cursor.next())
+            {
+                if (access.range.aboveHigh(FieldValue(cursor.key())))
+                    return false;
+                location = cursor.value();
+                if constexpr (std::is_same_v<K, std::string>)
+                {
+                    if (access.indexOnly)
+                    {
+                        // Columns outside the index stay NULL, nothing reads them
+                        row.assign(access.layout.names.size(), nullptr);
+                        rowId = -1;
+                        if (!CompositeKey::decode(cursor.key(), *access.compositeIndex, row))
+                            continue;
+                    }
+                }
+                if (!access.indexOnly && !access.storage->readRow(location, row, &rowId))
+                    continue;
+                access.rowsExamined++;
+                if (access.passes(row))
+                {
+                    cursor.next();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    public:
+        explicit AccessSource(const TableAccess &access) : access(access)
+        {
+            if (access.lookupIndex)
+                return;
+            if (!access.rangeIndex)
+            {
+                scanner = TableStorage::Scanner(*access.storage, access.columns, access.columnFilters);
+                return;
+            }
+
+            const KeyRange &range = access.range;
+            std::visit([&](const auto &tree)
+                       {
+                           using Tree = std::decay_t<decltype(tree)>;
+                           if constexpr (OrderedIndex<Tree>::value)
+                           {
+                               using K = IndexKey<Tree>;
+                               keys = range.hasLow ? KeyCursor<K>(tree, std::get<K>(range.low), range.lowInclusive, access.firstKeyBatch)
+                                                   : KeyCursor<K>(tree, access.firstKeyBatch);
+                           } },
+                       *access.rangeIndex);
+        }
+
+        bool next(int64_t &rowId, IndexNode &location, Row &row)
+        {
+            if (access.lookupIndex)
+            {
+                if (lookupDone)
+                    return false;
+                lookupDone = true;
+                if (!indexSearch(*access.lookupIndex, access.lookupKey, location) ||
+                    !access.storage->readRow(location, row, &rowId))
+                    return false;
+                access.rowsExamined++;
+                return access.passes(row);
+            }
+
+            if (access.rangeIndex)
+            {
+                if (auto *cursor = std::get_if<KeyCursor<int>>(&keys))
+                    return nextInRange(*cursor, rowId, location, row);
+                return nextInRange(std::get<KeyCursor<std::string>>(keys), rowId, location, row);
+            }
+
+            while (scanner.next(rowId, location, row))
+            {
+                access.rowsExamined++;
+                if (access.passes(row))
+                    return true;
+            }
+            return false;
+        }
+
+        bool next(Row &row) override
+        {
+            int64_t rowId;
+            IndexNode location;
+            return next(rowId, location, row);
+        }
+    };
+
+    // Visit every row the access produces with its row id and location,
+    // stops early when fn returns false
+    inline void forEachMatch(const TableAccess &access,
+                             const std::function<bool(int64_t, const IndexNode &, const Row &)> &fn)
+    {
+        AccessSource source(access);
+        int64_t rowId;
+        IndexNode location;
+        Row row;
+        while (source.next(rowId, location, row))
+        {
+            if (!fn(rowId, location, row))
+                break;
+        }
+    }
+
+    inline JoinExecutor::JoinInput makeJoinInput(const std::string &dbName, const TableAccess &access,
+                                                 const std::string &column)
+    {
+        JoinExecutor::JoinInput input;
+        input.table = access.table;
+        input.column = column;
+        input.keyPosition = access.layout.resolve(column);
+        input.storage = access.storage;
+        input.tableRows = access.tableRows;
+        input.estimatedRows = access.estimatedRows;
+        input.accessCost = access.cost;
+
+        // Index probes and merge walks fetch one row per key, so only a key
+        // that cannot repeat may be joined through its index
+        const auto &columnNode = access.storage->getColumns()[input.keyPosition];
+        input.index = uniqueIndex(*access.entry, *columnNode);
+        auto stats = Statistics::getStatistics(dbName, access.table);
+        const Statistics::ColumnStatistics *columnStats = stats ? stats->column(column) : nullptr;
+        if (columnStats)
+            input.keyDistinct = columnStats->distinct;
+        else if (columnNode->isPrimary || columnNode->isUnique)
+            input.keyDistinct = access.tableRows;
+        else
+            input.keyDistinct = access.tableRows * EQUALITY_SELECTIVITY;
+        return input;
+    }
+
+    // ORDER BY that no index walk provides: drains its input, then returns it
+    // sorted on one column. Under a LIMIT only the first `limit` rows are kept,
+    // in a bounded heap, so memory stays proportional to the page size.
+    class SortSource : public RowSource
+    {
+    private:
+        std::unique_ptr<RowSource> child;
+        int position;
+        bool descending;
+        size_t limit;
+        std::vector<Row> rows;
+        size_t pos = 0;
+        bool sorted = false;
+
+        bool before(const Row &a, const Row &b) const
+        {
+            int c = compareFields(a[position], b[position]);
+            return descending ? c > 0 : c < 0;
+        }
+
+        void sortInput()
+        {
+            auto less = [this](const Row &a, const Row &b)
+            { return before(a, b); };
+            bool heap = false;
+            Row row;
+            while (limit > 0 && child->next(row))
+            {
+                if (rows.size() < limit)
+                {
+                    rows.push_back(row);
+                    if (rows.size() == limit && limit != SIZE_MAX)
+                    {
+                        std::make_heap(rows.begin(), rows.end(), less);
+                        heap = true;
+                    }
+                }
+                else if (less(row, rows.front()))
+                {
+                    std::pop_heap(rows.begin(), rows.end(), less);
+                    rows.back() = row;
+                    std::push_heap(rows.begin(), rows.end(), less);
+                }
+            }
+            if (heap)
+                std::sort_heap(rows.begin(), rows.end(), less);
+            else
+                std::stable_sort(rows.begin(), rows.end(), less);
+            sorted = true;
+        }
+
+    public:
+        SortSource(std::unique_ptr<RowSource> child, int position, bool descending, size_t limit)
+            : child(std::move(child)), position(position), descending(descending), limit(limit) {}
+
+        bool next(Row &row) override
+        {
+            if (!sorted)
+                sortInput();
+            if (pos >= rows.size())
+                return false;
+            row = std::move(rows[pos++]);
+            return true;
+        }
+    };
+
+    // Fetch buffer reused across Cursor::fetch calls, rows [0, size) are valid
+    struct RowBatch
+    {
+        std::vector<Row> rows;
+        size_t size = 0;
+    };
+
+    // Pull-based SELECT shared by the shell, the embedded API and the server:
+    // constructing it plans the query, fetch() streams up to n rows into a
+    // reusable batch and close() releases the table locks. Only a hash join's
+    // build side is ever held in memory. With a PlanNode the physical plan is
+    // described into it and every operator is timed while rows are pulled.
+    class Cursor
+    {
+    private:
+        struct State
+        {
+            const SelectStatement *stmt = nullptr;
+            std::vector<std::unique_ptr<TableAccess>> accesses; // sources point into these
+            std::unique_ptr<RowSource> root;
+            RowLayout layout;
+            std::vector<int> projection;
+            std::vector<std::string> columns;
+            size_t remaining = SIZE_MAX;
+            Row scratch;
+
+            PlanNode *plan = nullptr;
+            PlanNode *limitNode = nullptr;
+            size_t emitted = 0;
+            std::vector<std::function<void()>> finalizers; // fill in actuals once the cursor is drained
+        };
+        std::unique_ptr<State> state;
+
+        std::unique_ptr<RowSource> accessSource(const TableAccess &access, PlanNode *node)
+        {
+            std::unique_ptr<RowSource> source = std::make_unique<AccessSource>(access);
+            if (!node)
+                return source;
+
+            auto ioStart = access.storage->ioCounters();
+            state->finalizers.push_back([node, &access, ioStart]
+                                        {
+                                            auto io = access.storage->ioCounters();
+                                            node->executed = true;
+                                            node->rowsIn = access.rowsExamined;
+                                            node->pagesRead = io.pagesRead - ioStart.pagesRead;
+                                            node->pageHits = io.pageHits - ioStart.pageHits; });
+            return std::make_unique<ProfiledSource>(std::move(source), node);
+        }
+
+        // Filter for a join side that is read inside the join itself, counts its rows when profiling
+        JoinExecutor::RowPredicate sideFilter(const TableAccess &access, PlanNode *node)
+        {
+            if (!node)
+                return [&access](const Row &row)
+                { return access.passes(row); };
+
+            auto ioStart = access.storage->ioCounters();
+            state->finalizers.push_back([node, &access, ioStart]
+                                        {
+                                            auto io = access.storage->ioCounters();
+                                            node->executed = true;
+                                            node->pagesRead = io.pagesRead - ioStart.pagesRead;
+                                            node->pageHits = io.pageHits - ioStart.pageHits; });
+            return [node, &access](const Row &row)
+            {
+                bool pass = access.passes(row);
+                node->rowsIn++;
+                node->rowsOut += pass;
+                return pass;
+            };
+        }
+
+        std::unique_ptr<RowSource> openJoin(const std::vector<const Expression *> &conjuncts, PlanNode *plan)
+        {
+            const SelectStatement &stmt = *state->stmt;
+            const JoinClause &join = *stmt.joinClause;
+            if (join.table == stmt.table)
+            {
+                throw std::runtime_error("Self joins are not supported");
+            }
+
+            state->accesses.push_back(std::make_unique<TableAccess>(planTableAccess(currentDatabase, stmt.table, conjuncts)));
+            state->accesses.push_back(std::make_unique<TableAccess>(planTableAccess(currentDatabase, join.table, conjuncts)));
+            for (const auto &access : state->accesses)
+                restrictColumns(*access, stmt, conjuncts);
+            const TableAccess &left = *state->accesses[0];
+            const TableAccess &right = *state->accesses[1];
+            RowLayout &layout = state->layout;
+            layout.addTable(left.table, *left.storage);
+            layout.addTable(right.table, *right.storage);
+
+            // Each side takes the conjuncts it can resolve, so a bare name must
+            // be checked against both tables together first
+            for (const Expression *conjunct : conjuncts)
+            {
+                std::vector<std::string> refs;
+                collectColumnRefs(conjunct, refs);
+                for (const auto &ref : refs)
+                    layout.resolve(ref);
+            }
+
+            std::string leftColumn, rightColumn;
+            if (join.leftTable == left.table && join.rightTable == right.table)
+            {
+                leftColumn = join.leftColumn;
+                rightColumn = join.rightColumn;
+            }
+            else if (join.leftTable == right.table && join.rightTable == left.table)
+            {
+                leftColumn = join.rightColumn;
+                rightColumn = join.leftColumn;
+            }
+            else
+            {
+                throw std::runtime_error("JOIN condition must compare " + left.table + " and " + right.table + " columns");
+            }
+
+            JoinExecutor::JoinInput leftInput = makeJoinInput(currentDatabase, left, leftColumn);
+            JoinExecutor::JoinInput rightInput = makeJoinInput(currentDatabase, right, rightColumn);
+            JoinExecutor::JoinPlan joinPlan = JoinExecutor::chooseJoinPlan(leftInput, rightInput);
+            bool buildLeft = left.estimatedRows <= right.estimatedRows;
+
+            std::vector<const Expression *> residual;
+            for (const Expression *conjunct : conjuncts)
+            {
+                if (!referencesOnly(conjunct, left.layout) && !referencesOnly(conjunct, right.layout))
+                    residual.push_back(conjunct);
+            }
+
+            // Children are listed outer (or build) side first
+            PlanNode *leftNode = nullptr, *rightNode = nullptr;
+            if (plan)
+            {
+                plan->op = JoinExecutor::algorithmName(joinPlan.algorithm);
+                plan->detail = left.table + "." + leftColumn + " = " + right.table + "." + rightColumn;
+                if (!residual.empty())
+                    plan->detail += " filter: " + joinExpressions(residual);
+                plan->estimatedRows = joinPlan.estimatedRows;
+                plan->cost = joinPlan.cost;
+
+                bool leftFirst = joinPlan.algorithm == JoinExecutor::JoinAlgorithm::HASH ? buildLeft
+                                 : joinPlan.algorithm == JoinExecutor::JoinAlgorithm::INDEX_NESTED_LOOP ? joinPlan.leftIsOuter
+                                                                                                          : true;
+                plan->children.push_back(describeAccess(leftFirst ? left : right));
+                plan->children.push_back(describeAccess(leftFirst ? right : left));
+                leftNode = &plan->children[leftFirst ? 0 : 1];
+                rightNode = &plan->children[leftFirst ? 1 : 0];
+
+                if (joinPlan.algorithm == JoinExecutor::JoinAlgorithm::HASH)
+                {
+                    plan->detail += " build: " + (buildLeft ? left.table : right.table);
+                }
+                if (joinPlan.algorithm == JoinExecutor::JoinAlgorithm::MERGE)
+                {
+                    // Both sides walk their join-key index in key order
+                    leftNode->op = rightNode->op = "Ordered Index Scan";
+                    leftNode->detail = "on " + left.table + " using " + leftColumn;
+                    rightNode->detail = "on " + right.table + " using " + rightColumn;
+                    if (!left.filters.empty())
+                        leftNode->detail += " filter: " + joinExpressions(left.filters);
+                    if (!right.filters.empty())
+                        rightNode->detail += " filter: " + joinExpressions(right.filters);
+                }
+                if (joinPlan.algorithm == JoinExecutor::JoinAlgorithm::INDEX_NESTED_LOOP)
+                {
+                    PlanNode *inner = joinPlan.leftIsOuter ? rightNode : leftNode;
+                    const TableAccess &innerAccess = joinPlan.leftIsOuter ? right : left;
+                    inner->op = "Index Probe";
+                    inner->detail = "on " + innerAccess.table + " using " + (joinPlan.leftIsOuter ? rightColumn : leftColumn);
+                    if (!innerAccess.filters.empty())
+                        inner->detail += " filter: " + joinExpressions(innerAccess.filters);
+                    // Per probe: at most one row, the inner join key is unique
+                    inner->estimatedRows = 1;
+                    inner->cost = JoinExecutor::probeCost(innerAccess.tableRows,
+                                                          joinPlan.leftIsOuter ? rightInput.index : leftInput.index);
+                }
+            }
+
+            JoinExecutor::RowPredicate residualCheck;
+            if (!residual.empty())
+            {
+                residualCheck = [residual, &layout](const Row &row)
+                {
+                    for (const Expression *conjunct : residual)
+                    {
+                        if (!evaluate(conjunct, layout, row))
+                            return false;
+                    }
+                    return true;
+                };
+            }
+
+            std::unique_ptr<RowSource> source;
+            switch (joinPlan.algorithm)
+            {
+            case JoinExecutor::JoinAlgorithm::HASH:
+                if (buildLeft)
+                    source = std::make_unique<JoinExecutor::HashJoinSource>(accessSource(left, leftNode), leftInput.keyPosition,
+                                                                            accessSource(right, rightNode), rightInput.keyPosition,
+                                                                            true, residualCheck);
+                else
+                    source = std::make_unique<JoinExecutor::HashJoinSource>(accessSource(right, rightNode), rightInput.keyPosition,
+                                                                            accessSource(left, leftNode), leftInput.keyPosition,
+                                                                            false, residualCheck);
+                break;
+            case JoinExecutor::JoinAlgorithm::INDEX_NESTED_LOOP:
+                if (joinPlan.leftIsOuter)
+                    source = std::make_unique<JoinExecutor::IndexNestedLoopSource>(accessSource(left, leftNode), leftInput.keyPosition,
+                                                                                   *right.storage, *rightInput.index,
+                                                                                   sideFilter(right, rightNode), true, residualCheck);
+                else
+                    source = std::make_unique<JoinExecutor::IndexNestedLoopSource>(accessSource(right, rightNode), rightInput.keyPosition,
+                                                                                   *left.storage, *leftInput.index,
+                                                                                   sideFilter(left, leftNode), false, residualCheck);
+                break;
+            case JoinExecutor::JoinAlgorithm::MERGE:
+                source = JoinExecutor::makeMergeJoin(leftInput, sideFilter(left, leftNode),
+                                                     rightInput, sideFilter(right, rightNode), residualCheck);
+                break;
+            }
+
+            if (!plan)
+                return source;
+
+            bool nestedLoop = joinPlan.algorithm == JoinExecutor::JoinAlgorithm::INDEX_NESTED_LOOP;
+            PlanNode *outer = joinPlan.leftIsOuter ? leftNode : rightNode;
+            PlanNode *inner = joinPlan.leftIsOuter ? rightNode : leftNode;
+            state->finalizers.push_back([plan, leftNode, rightNode, nestedLoop, outer, inner]
+                                        {
+                                            plan->rowsIn = leftNode->rowsOut + rightNode->rowsOut;
+                                            if (nestedLoop)
+                                                inner->loops = outer->rowsOut; });
+            return std::make_unique<ProfiledSource>(std::move(source), plan);
+        }
+
+        // Run the finalizers, then drop the sources and with them the table locks
+        void finish()
+        {
+            if (!state || !state->root)
+                return;
+            for (const auto &finalize : state->finalizers)
+                finalize();
+            state->finalizers.clear();
+            state->root.reset();
+            state->accesses.clear();
+        }
+
+    public:
+        Cursor() = default;
+        Cursor(Cursor &&) = default;
+        Cursor &operator=(Cursor &&) = default;
+
+        explicit Cursor(const SelectStatement &stmt, PlanNode *plan = nullptr) : state(std::make_unique<State>())
+        {
+            state->stmt = &stmt;
+            state->plan = plan;
+
+            std::vector<const Expression *> conjuncts;
+            if (stmt.whereClause)
+                collectConjuncts(stmt.whereClause->condition.get(), conjuncts);
+            if (stmt.limitClause)
+                state->remaining = stmt.limitClause->limit;
+
+            // Project -> [Limit] -> [Sort] -> Join | table access
+            PlanNode *input = plan;
+            if (plan)
+            {
+                plan->op = "Project";
+                plan->millis = 0;
+                plan->children.emplace_back();
+                input = &plan->children.back();
+                if (stmt.limitClause)
+                {
+                    state->limitNode = input;
+                    input->op = "Limit";
+                    input->detail = std::to_string(stmt.limitClause->limit);
+                    input->children.emplace_back();
+                    input = &input->children.back();
+                }
+            }
+            PlanNode *limitInput = input;
+
+            const OrderByClause *order = stmt.orderByClause.get();
+            bool sort = order != nullptr;
+            if (!stmt.joinClause)
+            {
+                std::vector<std::string> refs;
+                bool partial = selectReferences(stmt, conjuncts, refs);
+                auto access = std::make_unique<TableAccess>(planTableAccess(currentDatabase, stmt.table, conjuncts,
+                                                                            order, state->remaining,
+                                                                            partial ? &refs : nullptr));
+                for (const Expression *conjunct : conjuncts)
+                {
+                    if (!referencesOnly(conjunct, access->layout))
+                        throw std::runtime_error("WHERE references a column that is not in table '" + stmt.table + "'");
+                }
+                restrictColumns(*access, stmt, conjuncts);
+                state->layout = access->layout;
+                sort = access->needsSort;
+                state->accesses.push_back(std::move(access));
+            }
+
+            PlanNode *sortNode = nullptr;
+            if (sort && input)
+            {
+                sortNode = input;
+                sortNode->op = "Sort";
+                sortNode->detail = "by " + order->column + (order->descending ? " DESC" : "");
+                if (state->remaining != SIZE_MAX)
+                    sortNode->detail += " top " + std::to_string(state->remaining);
+                sortNode->children.emplace_back();
+                input = &sortNode->children.back();
+            }
+
+            if (stmt.joinClause)
+            {
+                state->root = openJoin(conjuncts, input);
+            }
+            else
+            {
+                const TableAccess &access = *state->accesses.back();
+                if (input)
+                    *input = describeAccess(access);
+                state->root = accessSource(access, input);
+            }
+
+            if (sort)
+            {
+                int position = state->layout.resolve(order->column);
+                state->root = std::make_unique<SortSource>(std::move(state->root), position, order->descending, state->remaining);
+                if (sortNode)
+                {
+                    sortNode->estimatedRows = input->estimatedRows;
+                    sortNode->cost = input->cost + sortCost(input->estimatedRows);
+                    state->finalizers.push_back([sortNode, input]
+                                                { sortNode->rowsIn = input->rowsOut; });
+                    state->root = std::make_unique<ProfiledSource>(std::move(state->root), sortNode);
+                }
+            }
+
+            const RowLayout &layout = state->layout;
+            for (const auto &column : stmt.columns)
+            {
+                if (column == "*")
+                {
+                    for (size_t i = 0; i < layout.names.size(); ++i)
+                    {
+                        state->projection.push_back(static_cast<int>(i));
+                        state->columns.push_back(stmt.joinClause ? layout.tables[i] + "." + layout.names[i] : layout.names[i]);
+                    }
+                    continue;
+                }
+                state->projection.push_back(layout.resolve(column));
+                state->columns.push_back(column);
+            }
+
+            if (plan)
+            {
+                if (state->limitNode)
+                {
+                    state->limitNode->estimatedRows = std::min(limitInput->estimatedRows, static_cast<double>(state->remaining));
+                    state->limitNode->cost = limitInput->cost;
+                }
+                for (const auto &column : state->columns)
+                    plan->detail += (plan->detail.empty() ? "" : ", ") + column;
+                plan->estimatedRows = plan->children[0].estimatedRows;
+                plan->cost = plan->children[0].cost;
+            }
+        }
+
+        ~Cursor()
+        {
+            close();
+        }
+
+        const std::vector<std::string> &columns() const
+        {
+            return state->columns;
+        }
+
+        bool isOpen() const
+        {
+            return state && state->root;
+        }
+
+        // Fill batch with up to n rows, returns how many; 0 once the cursor is drained
+        size_t fetch(RowBatch &batch, size_t n)
+        {
+            batch.size = 0;
+            if (!isOpen())
+                return 0;
+            if (batch.rows.size() < n)
+                batch.rows.resize(n);
+
+            auto start = std::chrono::steady_clock::now();
+            while (batch.size < n)
+            {
+                if (state->remaining == 0 || !state->root->next(state->scratch))
+                {
+                    finish();
+                    break;
+                }
+                Row &out = batch.rows[batch.size++];
+                out.resize(state->projection.size());
+                for (size_t i = 0; i < state->projection.size(); ++i)
+                    out[i] = state->scratch[state->projection[i]];
+                state->remaining--;
+            }
+            state->emitted += batch.size;
+
+            if (PlanNode *plan = state->plan)
+            {
+                plan->millis += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+                plan->executed = true;
+                plan->rowsIn = plan->rowsOut = state->emitted;
+                if (PlanNode *limit = state->limitNode)
+                {
+                    limit->executed = true;
+                    limit->millis = plan->millis;
+                    limit->rowsIn = limit->children[0].rowsOut;
+                    limit->rowsOut = state->emitted;
+                }
+            }
+            return batch.size;
+        }
+
+        void close()
+        {
+            finish();
+        }
+    };
+
+    // Drain a cursor into a ResultSet, for callers that want every row at once
+    inline ResultSet executeSelect(const SelectStatement &stmt)
+    {
+        Cursor cursor(stmt);
+        ResultSet result;
+        result.columns = cursor.columns();
+        RowBatch batch;
+        while (size_t n = cursor.fetch(batch, 1024))
+        {
+            for (size_t i = 0; i < n; ++i)
+                result.rows.push_back(std::move(batch.rows[i]));
+        }
+        return result;
+    }
+
+    inline void printPlanNode(const PlanNode &node, int depth, bool analyze)
+    {
+        std::cout << std::string(depth * 4, ' ') << (depth ? "-> " : "") << node.op;
+        if (!node.detail.empty())
+            std::cout << " (" << node.detail << ")";
+        std::cout << "  [est rows=" << node.estimatedRows << " cost=" << node.cost << "]";
+        if (analyze && node.executed)
+        {
+            std::cout << "  [actual ";
+            if (node.millis >= 0)
+                std::cout << "time=" << node.millis << " ms ";
+            else
+                std::cout << "time=(in parent) ";
+            std::cout << "loops=" << node.loops << " rows in=" << node.rowsIn << " out=" << node.rowsOut
+                      << " pages read=" << node.pagesRead << " hits=" << node.pageHits
+                      << " spill=" << node.spillBytes << " B]";
+        }
+        std::cout << "\n";
+        for (const PlanNode &child : node.children)
+            printPlanNode(child, depth + 1, analyze);
+    }
+
+    // EXPLAIN prints the chosen plan, EXPLAIN ANALYZE also runs it and
+    // reports what every operator actually did. Pages are 4 KiB data-file
+    // pages, hits are rows served from a page the scan already loaded, and
+    // spill stays 0 since every operator runs in memory.
+    inline void explainSelect(const SelectStatement &stmt, bool analyze)
+    {
+        PlanNode plan;
+        size_t rows = 0;
+        {
+            Cursor cursor(stmt, &plan);
+            RowBatch batch;
+            while (analyze && cursor.fetch(batch, 1024))
+                rows += batch.size;
+        }
+        printPlanNode(plan, 0, analyze);
+        if (analyze)
+            std::cout << "Execution time: " << plan.millis << " ms, " << rows << " rows\n";
+    }
+
+    // Stream a cursor to stdout a batch at a time, the first rows print before the scan finishes
+    inline void printCursor(Cursor &cursor)
+    {
+        const auto &columns = cursor.columns();
+        for (size_t i = 0; i < columns.size(); ++i)
+        {
+            std::cout << (i ? " | " : "") << columns[i];
+        }
+        std::cout << "\n";
+
+        RowBatch batch;
+        size_t total = 0;
+        while (size_t n = cursor.fetch(batch, 256))
+        {
+            for (size_t r = 0; r < n; ++r)
+            {
+                const Row &row = batch.rows[r];
+                for (size_t i = 0; i < row.size(); ++i)
+                {
+                    std::cout << (i ? " | " : "") << fieldToString(row[i]);
+                }
+                std::cout << "\n";
+            }
+            total += n;
+        }
+        std::cout << "(" << total << " rows)\n";
+    }
+
+    inline void writeField(JSONWriter &writer, const FieldValue &value)
+    {
+        if (const int *number = std::get_if<int>(&value))
+            writer.value(*number);
+        else if (const std::string *text = std::get_if<std::string>(&value))
+            writer.value(*text);
+        else
+            writer.value(nullptr);
+    }
+
+    // Stream a cursor as {"columns": [...], "rows": [[...], ...], "row_count": n}.
+    // A writer on a file descriptor sends each batch on as it fills.
+    inline void writeCursorJSON(Cursor &cursor, JSONWriter &writer)
+    {
+        writer.beginObject().key("columns").beginArray();
+        for (const auto &column : cursor.columns())
+            writer.value(column);
+        writer.endArray();
+
+        writer.key("rows").beginArray();
+        RowBatch batch;
+        uint64_t total = 0;
+        while (size_t n = cursor.fetch(batch, 256))
+        {
+            for (size_t r = 0; r < n; ++r)
+            {
+                writer.beginArray();
+                for (const FieldValue &field : batch.rows[r])
+                    writeField(writer, field);
+                writer.endArray();
+            }
+            total += n;
+        }
+        writer.endArray();
+        writer.key("row_count").value(total);
+        writer.endObject();
+    }
+
+    inline void printResultSet(const ResultSet &result)
+    {
+        for (size_t i = 0; i < result.columns.size(); ++i)
+        {
+            std::cout << (i ? " | " : "") << result.columns[i];
+        }
+        std::cout << "\n";
+        for (const Row &row : result.rows)
+        {
+            for (size_t i = 0; i < row.size(); ++i)
+            {
+                std::cout << (i ? " | " : "") << fieldToString(row[i]);
+            }
+            std::cout << "\n";
+        }
+        std::cout << "(" << result.rows.size() << " rows)\n";
+    }
+};
+
+#endif // __QUERY_EXECUTOR
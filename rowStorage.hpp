@@ -0,0 +1,1175 @@
+#ifndef __ROW_STORAGE
+#define __ROW_STORAGE
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <shared_mutex>
+#include <map>
+#include <thread>
+#include <chrono>
+#include <filesystem>
+#include <variant>
+#include <unordered_map>
+#include <stdexcept>
+#include <type_traits>
+#include "global.hpp"
+#include "sequence.hpp"
+#include "columnStore.hpp"
+
+// One entry of <table>.index, row number -> [row_start, row_end) in <table>.data
+struct RowIndex {
+    int64_t row_start;
+    int64_t row_end;
+};
+
+enum class FieldTag : uint8_t
+{
+    NULL_VALUE = 0,
+    INT_VALUE = 1,
+    STRING_VALUE = 2
+};
+
+inline std::string fieldToString(const FieldValue &value)
+{
+    if (std::holds_alternative<int>(value))
+        return std::to_string(std::get<int>(value));
+    if (std::holds_alternative<std::string>(value))
+        return std::get<std::string>(value);
+    return "NULL";
+}
+
+// Three-way comparison, NULL sorts before everything else and ints before strings
+inline int compareFields(const FieldValue &a, const FieldValue &b)
+{
+    if (a.index() != b.index())
+        return a.index() < b.index() ? -1 : 1;
+    if (std::holds_alternative<int>(a))
+    {
+        int x = std::get<int>(a), y = std::get<int>(b);
+        return x < y ? -1 : (x > y ? 1 : 0);
+    }
+    if (std::holds_alternative<std::string>(a))
+    {
+        int c = std::get<std::string>(a).compare(std::get<std::string>(b));
+        return c < 0 ? -1 : (c > 0 ? 1 : 0);
+    }
+    return 0;
+}
+
+// Free byte ranges of a data file. Neighbouring ranges are coalesced and
+// allocation is best fit, so reused holes stay as large as possible.
+class FreeSpaceMap
+{
+private:
+    std::map<int64_t, int64_t> byStart;       // start -> length
+    std::multimap<int64_t, int64_t> byLength; // length -> start
+    int64_t total = 0;
+
+    void addExtent(int64_t start, int64_t length)
+    {
+        byStart[start] = length;
+        byLength.emplace(length, start);
+        total += length;
+    }
+
+    void eraseExtent(std::map<int64_t, int64_t>::iterator it)
+    {
+        auto range = byLength.equal_range(it->second);
+        for (auto l = range.first; l != range.second; ++l)
+        {
+            if (l->second == it->first)
+            {
+                byLength.erase(l);
+                break;
+            }
+        }
+        total -= it->second;
+        byStart.erase(it);
+    }
+
+public:
+    void clear()
+    {
+        byStart.clear();
+        byLength.clear();
+        total = 0;
+    }
+
+    void release(int64_t start, int64_t length)
+    {
+        if (length <= 0)
+            return;
+
+        auto next = byStart.lower_bound(start);
+        if (next != byStart.end() && next->first == start + length)
+        {
+            length += next->second;
+            eraseExtent(next);
+        }
+        auto prev = byStart.lower_bound(start);
+        if (prev != byStart.begin())
+        {
+            --prev;
+            if (prev->first + prev->second == start)
+            {
+                start = prev->first;
+                length += prev->second;
+                eraseExtent(prev);
+            }
+        }
+        addExtent(start, length);
+    }
+
+    // Start of a free range of `length` bytes, or -1 when nothing fits
+    int64_t allocate(int64_t length)
+    {
+        auto fit = byLength.lower_bound(length);
+        if (fit == byLength.end())
+            return -1;
+
+        int64_t start = fit->second;
+        int64_t available = fit->first;
+        eraseExtent(byStart.find(start));
+        if (available > length)
+            addExtent(start + length, available - length);
+        return start;
+    }
+
+    int64_t freeBytes() const
+    {
+        return total;
+    }
+};
+
+// Row layout inside <table>.data:
+//   int64 header: rowId in the low 48 bits, the schema version the row was
+//   written with in the high 16, then for every column of that version in
+//   schema order a FieldTag byte followed by
+//   int    -> 8 byte value
+//   string -> uint16 length + bytes
+//
+// ALTER TABLE ADD COLUMN only bumps the schema version. Rows of an older
+// version lack the newer columns, which read as their defaults, and pick
+// them up when an UPDATE rewrites them. Files from before versioning hold
+// version 0 rows.
+//
+// Deleted rows are tombstoned in the <table>.tomb bitmap (bit rowId set) and
+// their bytes go to the free-space map, which later inserts and row moves
+// reuse. Vacuum compacts what is left and truncates the file.
+//
+// ENGINE=COLUMNAR tables hand their encoded rows to a ColumnStore instead,
+// which seals them into per-column row groups. Their locations are row ids,
+// tombstones and sequences work as for row tables, an UPDATE appends the new
+// version under a new row id and vacuum leaves them alone.
+class TableStorage
+{
+private:
+    std::string dbName;
+    std::string tableName;
+    std::string dataFileName;
+    std::string indexFileName;
+    std::string tombstoneFileName;
+    std::string sequenceFileName;
+    std::vector<std::shared_ptr<TableGlobalColumnNode>> columns;
+    uint32_t schemaVersion = 0; // newest column's version, written into every encoded row
+    std::unique_ptr<ColumnStorage::ColumnStore> columnStore; // ENGINE=COLUMNAR only
+
+    mutable std::ifstream dataReader;
+    mutable std::mutex ioMutex;
+
+    // Statements hold this shared, vacuum holds it exclusively while it moves rows
+    mutable std::shared_mutex statementMutex;
+
+    std::vector<uint8_t> tombstones;
+    int64_t tombstoneCount = 0;
+
+    FreeSpaceMap freeSpace;
+    bool freeSpaceLoaded = false;
+    bool compacting = false;
+
+    // AUTO_INCREMENT column position -> allocator, fixed after construction
+    std::map<int, std::unique_ptr<SequenceAllocator>> sequences;
+    std::mutex sequenceFileMutex;
+
+    void loadTombstones()
+    {
+        std::ifstream in(tombstoneFileName, std::ios::binary | std::ios::ate);
+        if (!in)
+            return;
+        tombstones.resize(static_cast<size_t>(in.tellg()));
+        in.seekg(0);
+        in.read(reinterpret_cast<char *>(tombstones.data()), tombstones.size());
+        for (uint8_t byte : tombstones)
+            tombstoneCount += __builtin_popcount(byte);
+    }
+
+    // <table>.seq holds one "<column> <high-water mark>" line per AUTO_INCREMENT
+    // column. It is rewritten through a temporary file, so a crash leaves either
+    // the old marks or the new ones.
+    void writeSequenceFile(int position, int64_t mark)
+    {
+        std::lock_guard<std::mutex> lock(sequenceFileMutex);
+        std::string tempName = sequenceFileName + ".tmp";
+        {
+            std::ofstream out(tempName, std::ios::trunc);
+            for (const auto &entry : sequences)
+            {
+                int64_t value = entry.first == position ? mark : entry.second->highWater();
+                out << columns[entry.first]->name << " " << value << "\n";
+            }
+            if (!out.flush())
+                throw std::runtime_error("❌ Failed to write sequence file for '" + tableName + "'");
+        }
+        std::filesystem::rename(tempName, sequenceFileName);
+    }
+
+    // Resume every AUTO_INCREMENT column above its persisted mark. Tables
+    // created before the marks existed are scanned once for their largest value.
+    void loadSequences()
+    {
+        std::map<std::string, int64_t> marks;
+        std::ifstream in(sequenceFileName);
+        std::string name;
+        int64_t value;
+        while (in >> name >> value)
+            marks[name] = value;
+
+        std::map<int, int64_t> missing;
+        for (size_t i = 0; i < columns.size(); ++i)
+        {
+            if (!columns[i]->autoIncrement || !isIntColumn(*columns[i]))
+                continue;
+            int position = static_cast<int>(i);
+            auto mark = marks.find(columns[i]->name);
+            if (mark == marks.end())
+                missing[position] = 0;
+            sequences[position] = std::make_unique<SequenceAllocator>(
+                mark == marks.end() ? 0 : mark->second,
+                [this, position](int64_t high)
+                { writeSequenceFile(position, high); });
+        }
+        if (missing.empty())
+            return;
+
+        scan([&missing](int64_t, const IndexNode &, const Row &row)
+             {
+                 for (auto &entry : missing)
+                 {
+                     if (const int *v = std::get_if<int>(&row[entry.first]))
+                         entry.second = std::max<int64_t>(entry.second, *v);
+                 }
+                 return true; });
+        for (const auto &entry : missing)
+            sequences[entry.first]->observe(entry.second);
+        writeSequenceFile(-1, 0); // record the marks even when nothing was observed
+    }
+
+    RowIndex readIndexEntry(int64_t rowId) const
+    {
+        RowIndex entry{-1, -1};
+        std::ifstream indexFile(indexFileName, std::ios::binary);
+        indexFile.seekg(rowId * sizeof(RowIndex));
+        indexFile.read(reinterpret_cast<char *>(&entry), sizeof(RowIndex));
+        return entry;
+    }
+
+    std::vector<std::pair<int64_t, RowIndex>> readLiveEntries() const
+    {
+        std::vector<std::pair<int64_t, RowIndex>> live;
+        std::ifstream indexFile(indexFileName, std::ios::binary);
+        RowIndex entry;
+        for (int64_t rowId = 0; indexFile.read(reinterpret_cast<char *>(&entry), sizeof(RowIndex)); ++rowId)
+        {
+            if (entry.row_end > entry.row_start && !isDeleted(rowId))
+                live.emplace_back(rowId, entry);
+        }
+        return live;
+    }
+
+    // Free space is every gap between live rows, rebuilt from <table>.index
+    void ensureFreeSpaceLoaded()
+    {
+        if (freeSpaceLoaded)
+            return;
+        freeSpace.clear();
+
+        auto live = readLiveEntries();
+        std::sort(live.begin(), live.end(), [](const auto &a, const auto &b)
+                  { return a.second.row_start < b.second.row_start; });
+
+        int64_t cursor = 0;
+        for (const auto &entry : live)
+        {
+            freeSpace.release(cursor, entry.second.row_start - cursor);
+            cursor = std::max(cursor, entry.second.row_end);
+        }
+        freeSpace.release(cursor, getFileSize(dataFileName) - cursor);
+        freeSpaceLoaded = true;
+    }
+
+    void writeBytes(int64_t start, const std::string &bytes)
+    {
+        std::fstream dataFile(dataFileName, std::ios::binary | std::ios::in | std::ios::out);
+        if (!dataFile)
+        {
+            throw std::runtime_error("❌ Failed to open data file for writing: " + dataFileName);
+        }
+        dataFile.seekp(start);
+        dataFile.write(bytes.data(), bytes.size());
+    }
+
+    // Place bytes into a reused hole, or at the end of the data file
+    int64_t placeBytes(const std::string &bytes)
+    {
+        ensureFreeSpaceLoaded();
+        int64_t start = compacting ? -1 : freeSpace.allocate(bytes.size());
+        if (start >= 0)
+        {
+            writeBytes(start, bytes);
+            return start;
+        }
+
+        start = getFileSize(dataFileName);
+        std::ofstream dataFile(dataFileName, std::ios::binary | std::ios::app);
+        if (!dataFile)
+        {
+            throw std::runtime_error("❌ Failed to open data file for appending: " + dataFileName);
+        }
+        dataFile.write(bytes.data(), bytes.size());
+        return start;
+    }
+
+    void releaseBytes(int64_t start, int64_t end)
+    {
+        if (end > start && freeSpaceLoaded)
+            freeSpace.release(start, end - start);
+    }
+
+    // appendRow() with ioMutex already held
+    IndexNode appendRowLocked(const Row &row, int64_t *appendedId = nullptr)
+    {
+        int64_t rowId = getRowCount();
+        if (appendedId)
+            *appendedId = rowId;
+        std::string encoded = encodeRow(rowId, row);
+        if (columnStore)
+        {
+            columnStore->append(encoded, [this](int64_t id)
+                                { return isDeleted(id); });
+            return IndexNode{rowId, rowId + 1};
+        }
+        int64_t row_start = placeBytes(encoded);
+
+        RowIndex entry{row_start, row_start + static_cast<int64_t>(encoded.size())};
+        std::ofstream indexFile(indexFileName, std::ios::binary | std::ios::app);
+        if (!indexFile)
+        {
+            throw std::runtime_error("❌ Failed to open index file: " + indexFileName);
+        }
+        indexFile.write(reinterpret_cast<const char *>(&entry), sizeof(RowIndex));
+        indexFile.close();
+
+        return IndexNode{entry.row_start, entry.row_end};
+    }
+
+    // Set the tombstone bit of rowId, false when it was already set. ioMutex is held.
+    bool markDeleted(int64_t rowId)
+    {
+        if (isDeleted(rowId))
+            return false;
+
+        size_t byte = static_cast<size_t>(rowId / 8);
+        if (tombstones.size() <= byte)
+            tombstones.resize(byte + 1, 0);
+        tombstones[byte] |= static_cast<uint8_t>(1u << (rowId % 8));
+        tombstoneCount++;
+
+        std::ofstream create(tombstoneFileName, std::ios::binary | std::ios::app);
+        create.close();
+        std::fstream tombFile(tombstoneFileName, std::ios::binary | std::ios::in | std::ios::out);
+        if (!tombFile)
+        {
+            throw std::runtime_error("❌ Failed to open tombstone file: " + tombstoneFileName);
+        }
+        tombFile.seekp(byte);
+        tombFile.write(reinterpret_cast<const char *>(&tombstones[byte]), 1);
+        return true;
+    }
+
+    // Data-file pages fetched and row reads served from an already fetched page
+    mutable std::atomic<uint64_t> pagesRead{0};
+    mutable std::atomic<uint64_t> pageHits{0};
+
+    static uint64_t pagesSpanned(int64_t start, int64_t end)
+    {
+        return static_cast<uint64_t>((end - 1) / PAGE_SIZE - start / PAGE_SIZE + 1);
+    }
+
+    std::ifstream &reader() const
+    {
+        if (!dataReader.is_open())
+        {
+            dataReader.open(dataFileName, std::ios::binary);
+        }
+        dataReader.clear();
+        return dataReader;
+    }
+
+public:
+    static constexpr int ROW_VERSION_SHIFT = 48;
+    static constexpr int64_t ROW_ID_MASK = (int64_t(1) << ROW_VERSION_SHIFT) - 1;
+    static constexpr uint32_t MAX_SCHEMA_VERSION = 0xFFFF;
+
+    static constexpr int64_t PAGE_SIZE = 4096;
+    static constexpr int64_t SCAN_BLOCK_SIZE = 64 * 1024;
+
+    struct IoCounters
+    {
+        uint64_t pagesRead = 0;
+        uint64_t pageHits = 0;
+    };
+
+    IoCounters ioCounters() const
+    {
+        uint64_t columnPages = columnStore ? columnStore->pagesRead.load() : 0;
+        return IoCounters{pagesRead.load() + columnPages, pageHits.load()};
+    }
+
+    TableStorage(const std::string &dbName, const std::string &tableName, const std::string &basePath,
+                 const std::vector<std::shared_ptr<TableGlobalColumnNode>> &columns,
+                 StorageEngine engine = StorageEngine::ROW)
+        : dbName(dbName), tableName(tableName), dataFileName(basePath + ".data"),
+          indexFileName(basePath + ".index"), tombstoneFileName(basePath + ".tomb"),
+          sequenceFileName(basePath + ".seq"), columns(columns)
+    {
+        for (const auto &column : columns)
+            schemaVersion = std::max(schemaVersion, column->schemaVersion);
+        // A table imported from the JSON schema alone has no directory yet
+        std::filesystem::create_directories(std::filesystem::path(basePath).parent_path());
+        if (engine == StorageEngine::COLUMNAR)
+        {
+            columnStore = std::make_unique<ColumnStorage::ColumnStore>(
+                basePath, this->columns, [this](const std::string &buffer, int64_t &rowId, Row &row)
+                { return decodeRow(buffer, rowId, row); });
+        }
+        loadTombstones();
+        loadSequences();
+    }
+
+    bool isColumnar() const
+    {
+        return columnStore != nullptr;
+    }
+
+    const std::string &getDatabaseName() const
+    {
+        return dbName;
+    }
+
+    const std::string &getTableName() const
+    {
+        return tableName;
+    }
+
+    // Allocator of an AUTO_INCREMENT INT column, nullptr for any other column
+    SequenceAllocator *sequence(int position) const
+    {
+        auto it = sequences.find(position);
+        return it == sequences.end() ? nullptr : it->second.get();
+    }
+
+    std::shared_lock<std::shared_mutex> statementLock() const
+    {
+        return std::shared_lock<std::shared_mutex>(statementMutex);
+    }
+
+    const std::vector<std::shared_ptr<TableGlobalColumnNode>> &getColumns() const
+    {
+        return columns;
+    }
+
+    uint32_t getSchemaVersion() const
+    {
+        return schemaVersion;
+    }
+
+    // ALTER TABLE ADD COLUMN, under exclusiveStatementLock; stored rows stay as they are
+    void addColumn(const std::shared_ptr<TableGlobalColumnNode> &column)
+    {
+        std::lock_guard<std::mutex> lock(ioMutex);
+        columns.push_back(column);
+        schemaVersion = std::max(schemaVersion, column->schemaVersion);
+    }
+
+    // Waits for running statements and keeps new ones out until released,
+    // so CREATE INDEX fills the new index from a table nobody is changing
+    std::unique_lock<std::shared_mutex> exclusiveStatementLock() const
+    {
+        return std::unique_lock<std::shared_mutex>(statementMutex);
+    }
+
+    // CREATE INDEX swaps in the column with its new index flags, under exclusiveStatementLock
+    void replaceColumn(int position, const std::shared_ptr<TableGlobalColumnNode> &column)
+    {
+        std::lock_guard<std::mutex> lock(ioMutex);
+        columns[position] = column;
+    }
+
+    int columnPosition(const std::string &name) const
+    {
+        for (size_t i = 0; i < columns.size(); ++i)
+        {
+            if (columns[i]->name == name)
+                return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    // Get current file size
+    int64_t getFileSize(const std::string &filename) const
+    {
+        std::ifstream file(filename, std::ios::binary | std::ios::ate);
+        if (!file)
+            return 0;
+        return file.tellg();
+    }
+
+    // Get total number of rows without loading all indices
+    int64_t getRowCount() const
+    {
+        if (columnStore)
+            return columnStore->rowCount();
+        return getFileSize(indexFileName) / sizeof(RowIndex);
+    }
+
+    int64_t getLiveRowCount() const
+    {
+        return getRowCount() - tombstoneCount;
+    }
+
+    bool isDeleted(int64_t rowId) const
+    {
+        size_t byte = static_cast<size_t>(rowId / 8);
+        return byte < tombstones.size() && (tombstones[byte] >> (rowId % 8)) & 1;
+    }
+
+    // Dead bytes in the data file and the share of the file they take up
+    std::pair<int64_t, double> fragmentation()
+    {
+        if (columnStore)
+            return {0, 0.0};
+        std::lock_guard<std::mutex> lock(ioMutex);
+        ensureFreeSpaceLoaded();
+        int64_t size = getFileSize(dataFileName);
+        return {freeSpace.freeBytes(), size > 0 ? static_cast<double>(freeSpace.freeBytes()) / size : 0.0};
+    }
+
+    std::string encodeRow(int64_t rowId, const Row &row) const
+    {
+        if (row.size() != columns.size())
+        {
+            throw std::runtime_error("Row has " + std::to_string(row.size()) + " values but table has " + std::to_string(columns.size()) + " columns");
+        }
+
+        std::string buffer;
+        int64_t header = rowId | static_cast<int64_t>(schemaVersion) << ROW_VERSION_SHIFT;
+        buffer.append(reinterpret_cast<const char *>(&header), sizeof(int64_t));
+
+        for (size_t i = 0; i < columns.size(); ++i)
+        {
+            const FieldValue &value = row[i];
+            if (std::holds_alternative<std::nullptr_t>(value))
+            {
+                buffer.push_back(static_cast<char>(FieldTag::NULL_VALUE));
+            }
+            else if (std::holds_alternative<int>(value))
+            {
+                int64_t v = std::get<int>(value);
+                buffer.push_back(static_cast<char>(FieldTag::INT_VALUE));
+                buffer.append(reinterpret_cast<const char *>(&v), sizeof(int64_t));
+            }
+            else
+            {
+                const std::string &v = std::get<std::string>(value);
+                if (v.size() > static_cast<size_t>(std::min(columns[i]->length, 65535)))
+                {
+                    throw std::runtime_error("Value too long for column '" + columns[i]->name + "'");
+                }
+                uint16_t len = static_cast<uint16_t>(v.size());
+                buffer.push_back(static_cast<char>(FieldTag::STRING_VALUE));
+                buffer.append(reinterpret_cast<const char *>(&len), sizeof(uint16_t));
+                buffer.append(v);
+            }
+        }
+        return buffer;
+    }
+
+    bool decodeRow(const std::string &buffer, int64_t &rowId, Row &row) const
+    {
+        size_t pos = 0;
+        if (buffer.size() < sizeof(int64_t))
+            return false;
+        int64_t header;
+        std::memcpy(&header, buffer.data(), sizeof(int64_t));
+        pos += sizeof(int64_t);
+        rowId = header & ROW_ID_MASK;
+        uint32_t version = static_cast<uint32_t>(static_cast<uint64_t>(header) >> ROW_VERSION_SHIFT);
+        if (version > schemaVersion)
+            return false;
+
+        row.clear();
+        row.reserve(columns.size());
+        for (size_t i = 0; i < columns.size(); ++i)
+        {
+            // Added after this row was written
+            if (columns[i]->schemaVersion > version)
+            {
+                row.push_back(columns[i]->defaultValue);
+                continue;
+            }
+            if (pos >= buffer.size())
+                return false;
+            FieldTag tag = static_cast<FieldTag>(buffer[pos++]);
+            switch (tag)
+            {
+            case FieldTag::NULL_VALUE:
+                row.emplace_back(nullptr);
+                break;
+            case FieldTag::INT_VALUE:
+            {
+                int64_t v;
+                if (pos + sizeof(int64_t) > buffer.size())
+                    return false;
+                std::memcpy(&v, buffer.data() + pos, sizeof(int64_t));
+                pos += sizeof(int64_t);
+                row.emplace_back(static_cast<int>(v));
+                break;
+            }
+            case FieldTag::STRING_VALUE:
+            {
+                uint16_t len;
+                if (pos + sizeof(uint16_t) > buffer.size())
+                    return false;
+                std::memcpy(&len, buffer.data() + pos, sizeof(uint16_t));
+                pos += sizeof(uint16_t);
+                if (pos + len > buffer.size())
+                    return false;
+                row.emplace_back(buffer.substr(pos, len));
+                pos += len;
+                break;
+            }
+            default:
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Store a row and append its location to the index file
+    IndexNode appendRow(const Row &row, int64_t *rowId = nullptr)
+    {
+        std::lock_guard<std::mutex> lock(ioMutex);
+        return appendRowLocked(row, rowId);
+    }
+
+    // Point the index entry of rowId at a new location
+    void writeIndexEntry(int64_t rowId, const RowIndex &entry)
+    {
+        std::fstream indexFile(indexFileName, std::ios::binary | std::ios::in | std::ios::out);
+        if (!indexFile)
+        {
+            throw std::runtime_error("❌ Failed to open index file: " + indexFileName);
+        }
+        indexFile.seekp(rowId * sizeof(RowIndex));
+        indexFile.write(reinterpret_cast<const char *>(&entry), sizeof(RowIndex));
+    }
+
+    // Rewrite a row. The new encoding overwrites the old bytes when it fits,
+    // otherwise it moves to a free hole or the end and only the index entry changes.
+    IndexNode updateRow(int64_t rowId, const IndexNode &oldLocation, const Row &row, bool *inPlace = nullptr)
+    {
+        std::lock_guard<std::mutex> lock(ioMutex);
+        if (columnStore)
+        {
+            // Sealed segments are immutable: the old version is tombstoned
+            markDeleted(rowId);
+            if (inPlace)
+                *inPlace = false;
+            return appendRowLocked(row);
+        }
+
+        std::string encoded = encodeRow(rowId, row);
+        int64_t start;
+        bool fits = static_cast<int64_t>(encoded.size()) <= oldLocation.end - oldLocation.start;
+
+        if (fits)
+        {
+            start = oldLocation.start;
+            writeBytes(start, encoded);
+            releaseBytes(start + encoded.size(), oldLocation.end);
+        }
+        else
+        {
+            start = placeBytes(encoded);
+            releaseBytes(oldLocation.start, oldLocation.end);
+        }
+
+        RowIndex entry{start, start + static_cast<int64_t>(encoded.size())};
+        writeIndexEntry(rowId, entry);
+        if (inPlace)
+            *inPlace = fits;
+        return IndexNode{entry.row_start, entry.row_end};
+    }
+
+    // Tombstone the row, a single byte of <table>.tomb is written
+    void deleteRow(int64_t rowId, const IndexNode &location)
+    {
+        std::lock_guard<std::mutex> lock(ioMutex);
+        if (markDeleted(rowId))
+            releaseBytes(location.start, location.end);
+    }
+
+    struct CompactionStats
+    {
+        int64_t rowsMoved = 0;
+        int64_t bytesMoved = 0;
+        int64_t bytesReclaimed = 0;
+    };
+
+    // Called for every row vacuum relocates so indexes can be re-pointed
+    using MoveCallback = std::function<void(const Row &, const IndexNode &, const IndexNode &)>;
+
+    static constexpr int64_t COMPACTION_CHUNK_BYTES = 64 * 1024;
+
+    // Slide live rows towards the start of the data file and truncate the
+    // free tail. Works in chunks so statements can run in between, and sleeps
+    // after each chunk to stay under bytesPerSecond (0 = unthrottled).
+    CompactionStats compact(int64_t bytesPerSecond, const MoveCallback &onMove)
+    {
+        CompactionStats stats;
+        if (columnStore)
+            return stats;
+        std::vector<std::pair<int64_t, RowIndex>> live;
+        {
+            std::unique_lock<std::shared_mutex> statement(statementMutex);
+            std::lock_guard<std::mutex> lock(ioMutex);
+            ensureFreeSpaceLoaded();
+            if (freeSpace.freeBytes() == 0)
+                return stats;
+            compacting = true;
+            live = readLiveEntries();
+        }
+        std::sort(live.begin(), live.end(), [](const auto &a, const auto &b)
+                  { return a.second.row_start < b.second.row_start; });
+
+        int64_t cursor = 0;
+        size_t next = 0;
+        std::string buffer;
+        Row row;
+        while (next < live.size())
+        {
+            int64_t chunkBytes = 0;
+            {
+                std::unique_lock<std::shared_mutex> statement(statementMutex);
+                std::lock_guard<std::mutex> lock(ioMutex);
+
+                for (; next < live.size() && chunkBytes < COMPACTION_CHUNK_BYTES; ++next)
+                {
+                    int64_t rowId = live[next].first;
+                    RowIndex current = readIndexEntry(rowId);
+                    // Deleted or moved elsewhere by an update since the snapshot
+                    if (isDeleted(rowId) || current.row_start != live[next].second.row_start)
+                        continue;
+
+                    int64_t len = current.row_end - current.row_start;
+                    if (current.row_start <= cursor)
+                    {
+                        cursor = std::max(cursor, current.row_end);
+                        continue;
+                    }
+
+                    buffer.resize(len);
+                    std::ifstream &in = reader();
+                    in.seekg(current.row_start);
+                    if (!in.read(buffer.data(), len))
+                        continue;
+                    writeBytes(cursor, buffer);
+
+                    RowIndex moved{cursor, cursor + len};
+                    writeIndexEntry(rowId, moved);
+                    int64_t decodedId;
+                    if (onMove && decodeRow(buffer, decodedId, row))
+                        onMove(row, IndexNode{current.row_start, current.row_end}, IndexNode{moved.row_start, moved.row_end});
+
+                    cursor += len;
+                    chunkBytes += len;
+                    stats.rowsMoved++;
+                }
+            }
+            stats.bytesMoved += chunkBytes;
+
+            if (bytesPerSecond > 0 && chunkBytes > 0)
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(chunkBytes * 1000000 / bytesPerSecond));
+            }
+        }
+
+        {
+            std::unique_lock<std::shared_mutex> statement(statementMutex);
+            std::lock_guard<std::mutex> lock(ioMutex);
+
+            // Rows written while compacting went to the end, keep them
+            int64_t end = cursor;
+            for (const auto &entry : readLiveEntries())
+                end = std::max(end, entry.second.row_end);
+
+            int64_t size = getFileSize(dataFileName);
+            if (end < size)
+            {
+                dataReader.close();
+                std::filesystem::resize_file(dataFileName, end);
+                stats.bytesReclaimed = size - end;
+            }
+            compacting = false;
+            freeSpaceLoaded = false;
+        }
+        return stats;
+    }
+
+    // Read the row stored at [location.start, location.end)
+    bool readRow(const IndexNode &location, Row &row, int64_t *rowId = nullptr) const
+    {
+        if (columnStore)
+        {
+            if (!columnStore->readRow(location.start, row))
+                return false;
+            if (rowId)
+                *rowId = location.start;
+            return true;
+        }
+
+        int64_t len = location.end - location.start;
+        if (len <= 0)
+            return false;
+
+        std::string buffer(len, '\0');
+        {
+            std::lock_guard<std::mutex> lock(ioMutex);
+            std::ifstream &in = reader();
+            if (!in)
+                return false;
+            in.seekg(location.start);
+            if (!in.read(buffer.data(), len))
+                return false;
+        }
+        pagesRead += pagesSpanned(location.start, location.end);
+
+        int64_t id;
+        if (!decodeRow(buffer, id, row))
+            return false;
+        if (rowId)
+            *rowId = id;
+        return true;
+    }
+
+    // Resumable sequential scan in row-number order, the pull form of scan().
+    // Rows are served from a page-aligned block, refilled only when a row falls outside it.
+    // A columnar table decodes only the columns set in `wanted` (empty = all), the
+    // others are left NULL, and may drop rows failing one of `filters` early.
+    class Scanner
+    {
+    private:
+        const TableStorage *storage = nullptr;
+        ColumnStorage::ColumnStore::Scanner columnar;
+        std::ifstream indexFile;
+        std::ifstream dataFile;
+        std::string block;
+        std::string buffer;
+        int64_t blockStart = 0, blockEnd = 0;
+        int64_t rowNum = 0, rowCount = 0;
+
+    public:
+        Scanner() = default;
+
+        explicit Scanner(const TableStorage &storage, std::vector<bool> wanted = {},
+                         std::vector<ColumnStorage::ColumnFilter> filters = {})
+            : storage(&storage),
+              // Rows appended after the scan started may sit in a hole of an already loaded block
+              rowCount(storage.getRowCount())
+        {
+            if (storage.columnStore)
+            {
+                columnar = ColumnStorage::ColumnStore::Scanner(
+                    *storage.columnStore, std::move(wanted), [&storage](int64_t id)
+                    { return storage.isDeleted(id); },
+                    std::move(filters));
+                return;
+            }
+            indexFile.open(storage.indexFileName, std::ios::binary);
+            dataFile.open(storage.dataFileName, std::ios::binary);
+            if (!indexFile || !dataFile)
+                rowCount = 0;
+        }
+
+        bool next(int64_t &rowId, IndexNode &location, Row &row)
+        {
+            if (storage && storage->columnStore)
+            {
+                if (!columnar.next(rowId, row))
+                    return false;
+                location = IndexNode{rowId, rowId + 1};
+                return true;
+            }
+
+            RowIndex entry;
+            while (rowNum < rowCount && indexFile.read(reinterpret_cast<char *>(&entry), sizeof(RowIndex)))
+            {
+                int64_t current = rowNum++;
+                int64_t len = entry.row_end - entry.row_start;
+                if (len <= 0 || storage->isDeleted(current))
+                    continue;
+
+                if (entry.row_start >= blockStart && entry.row_end <= blockEnd)
+                {
+                    storage->pageHits++;
+                }
+                else
+                {
+                    blockStart = entry.row_start - entry.row_start % PAGE_SIZE;
+                    block.resize(std::max(SCAN_BLOCK_SIZE, entry.row_end - blockStart));
+                    dataFile.clear();
+                    dataFile.seekg(blockStart);
+                    dataFile.read(block.data(), block.size());
+                    blockEnd = blockStart + dataFile.gcount();
+                    if (entry.row_end > blockEnd)
+                        break;
+                    storage->pagesRead += pagesSpanned(blockStart, blockEnd);
+                }
+                buffer.assign(block, entry.row_start - blockStart, len);
+
+                if (!storage->decodeRow(buffer, rowId, row))
+                    continue;
+                location = IndexNode{entry.row_start, entry.row_end};
+                return true;
+            }
+            rowNum = rowCount;
+            return false;
+        }
+    };
+
+    // Sequential scan in row-number order, stops early when fn returns false
+    void scan(const std::function<bool(int64_t, const IndexNode &, const Row &)> &fn) const
+    {
+        Scanner scanner(*this);
+        int64_t rowId;
+        IndexNode location;
+        Row row;
+        while (scanner.next(rowId, location, row))
+        {
+            if (!fn(rowId, location, row))
+                break;
+        }
+    }
+};
+
+// Pull-based row producer shared by table access, joins and cursors.
+// next() fills row and returns false once the input is exhausted.
+class RowSource
+{
+public:
+    virtual ~RowSource() = default;
+    virtual bool next(Row &row) = 0;
+};
+
+// --- Index helpers over TreeVariant ---
+// Key type of one TreeVariant alternative
+template <typename Tree>
+using IndexKey = typename std::decay_t<Tree>::element_type::key_type;
+
+// Alternatives that keep their keys in order, so KeyCursor can walk them
+template <typename Tree>
+struct OrderedIndex : std::false_type
+{
+};
+
+template <typename K>
+struct OrderedIndex<std::shared_ptr<BPlusTree<K, IndexNode>>> : std::true_type
+{
+};
+
+template <typename K>
+struct OrderedIndex<std::shared_ptr<AdaptiveRadixTree<K, IndexNode>>> : std::true_type
+{
+};
+
+template <typename K>
+inline void makeIndexOfKind(IndexKind kind, TreeVariant &tree)
+{
+    if (kind == IndexKind::HASH)
+        tree = std::make_shared<HashIndex<K, IndexNode>>();
+    else if (kind == IndexKind::ART)
+        tree = std::make_shared<AdaptiveRadixTree<K, IndexNode>>();
+    else
+        tree = std::make_shared<BPlusTree<K, IndexNode>>();
+}
+
+inline bool makeIndexTree(const std::string &type, TreeVariant &tree, IndexKind kind = IndexKind::BTREE)
+{
+    if (type == "int")
+    {
+        makeIndexOfKind<int>(kind, tree);
+        return true;
+    }
+    if (type == "string" || type == "varchar" || type == "text")
+    {
+        makeIndexOfKind<std::string>(kind, tree);
+        return true;
+    }
+    return false;
+}
+
+// Range scans, ORDER BY walks and merge joins need an ordered index
+inline bool indexOrdered(const TreeVariant &tree)
+{
+    return std::visit([](const auto &t)
+                      { return OrderedIndex<std::decay_t<decltype(t)>>::value; },
+                      tree);
+}
+
+// Keys of another type than the index (NULL, or text against an INT index) are never stored
+inline bool indexSearch(const TreeVariant &tree, const FieldValue &key, IndexNode &location)
+{
+    return std::visit([&](const auto &t)
+                      {
+                          const auto *typed = std::get_if<IndexKey<decltype(t)>>(&key);
+                          return typed && t->search(*typed, location); },
+                      tree);
+}
+
+inline void indexInsert(const TreeVariant &tree, const FieldValue &key, const IndexNode &location)
+{
+    std::visit([&](const auto &t)
+               {
+                   if (const auto *typed = std::get_if<IndexKey<decltype(t)>>(&key))
+                       t->insert(*typed, location); },
+               tree);
+}
+
+// Insert unless the key is taken, false for a duplicate. NULL keys are never stored, so they never clash.
+inline bool indexInsertIfAbsent(const TreeVariant &tree, const FieldValue &key, const IndexNode &location)
+{
+    return std::visit([&](const auto &t)
+                      {
+                          const auto *typed = std::get_if<IndexKey<decltype(t)>>(&key);
+                          return !typed || t->insert_if_absent(*typed, location); },
+                      tree);
+}
+
+inline bool indexRemove(const TreeVariant &tree, const FieldValue &key)
+{
+    return std::visit([&](const auto &t)
+                      {
+                          const auto *typed = std::get_if<IndexKey<decltype(t)>>(&key);
+                          return typed && t->remove(*typed); },
+                      tree);
+}
+
+inline size_t indexSize(const TreeVariant &tree)
+{
+    return std::visit([](const auto &t) { return t->size(); }, tree);
+}
+
+// Walks an ordered index (B+ tree or ART) in key order a batch of keys at a
+// time. No lock is held between batches, so a slow consumer never blocks writers. Batches
+// start at firstBatch keys and double up to KEY_BATCH, so a consumer that
+// only wants a few rows (a LIMIT over an ordered walk) reads a few leaves.
+template <typename K>
+class KeyCursor
+{
+private:
+    std::variant<std::shared_ptr<BPlusTree<K, IndexNode>>, std::shared_ptr<AdaptiveRadixTree<K, IndexNode>>> tree;
+    std::vector<std::pair<K, IndexNode>> batch;
+    size_t pos = 0;
+    size_t batchSize = KEY_BATCH;
+    bool exhausted = false;
+    bool hasLast = false;
+    K last{};
+    bool hasLow = false, lowInclusive = true;
+    K low{};
+
+    void refill()
+    {
+        batch.clear();
+        pos = 0;
+        std::visit([this](const auto &t)
+                   {
+                       auto it = hasLast || hasLow ? t->lower_bound(hasLast ? last : low) : t->begin();
+                       for (; it.valid() && batch.size() < batchSize; it.next())
+                       {
+                           bool skip = hasLast ? !(last < it.key()) : (hasLow && !lowInclusive && !(low < it.key()));
+                           if (!skip)
+                               batch.emplace_back(it.key(), it.value());
+                       } },
+                   tree);
+        exhausted = batch.size() < batchSize;
+        batchSize = std::min(batchSize * 2, KEY_BATCH);
+        if (!batch.empty())
+        {
+            hasLast = true;
+            last = batch.back().first;
+        }
+    }
+
+public:
+    static constexpr size_t KEY_BATCH = 256;
+
+    KeyCursor() : exhausted(true) {}
+
+    template <typename Tree>
+    explicit KeyCursor(std::shared_ptr<Tree> tree, size_t firstBatch = KEY_BATCH)
+        : tree(std::move(tree)), batchSize(std::clamp<size_t>(firstBatch, 1, KEY_BATCH))
+    {
+        refill();
+    }
+
+    // Start at the first key >= low (> low when not inclusive)
+    template <typename Tree>
+    KeyCursor(std::shared_ptr<Tree> tree, const K &low, bool inclusive, size_t firstBatch = KEY_BATCH)
+        : tree(std::move(tree)), batchSize(std::clamp<size_t>(firstBatch, 1, KEY_BATCH)),
+          hasLow(true), lowInclusive(inclusive), low(low)
+    {
+        refill();
+    }
+
+    bool valid() const
+    {
+        return pos < batch.size();
+    }
+
+    const K &key() const
+    {
+        return batch[pos].first;
+    }
+
+    const IndexNode &value() const
+    {
+        return batch[pos].second;
+    }
+
+    void next()
+    {
+        if (++pos >= batch.size() && !exhausted)
+            refill();
+    }
+};
+
+#endif // __ROW_STORAGE
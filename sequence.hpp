@@ -0,0 +1,107 @@
+#ifndef __SEQUENCE
+#define __SEQUENCE
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+// AUTO_INCREMENT values for one column. A writer claims RANGE_SIZE ids with a
+// single atomic add and numbers its rows from that thread-local range, so
+// concurrent inserts never wait on each other. The end of a range is made
+// durable before any id from it is handed out. After a crash, counting
+// resumes above that high-water mark. At most the unused tails of the ranges
+// that were live are skipped.
+class SequenceAllocator
+{
+private:
+    struct Range
+    {
+        int64_t next = 1;
+        int64_t end = 0; // empty until the first claim
+    };
+
+    std::atomic<int64_t> reserved;     // last id given to any range
+    std::atomic<int64_t> durable;      // last id covered by the persisted high-water mark
+    std::atomic<int64_t> explicitMax;  // largest value a writer supplied itself
+    std::mutex persistMutex;           // taken once per range, never per id
+    std::function<void(int64_t)> persist;
+    uint64_t id;                       // keys the thread-local ranges, never reused
+
+    static std::unordered_map<uint64_t, Range> &localRanges()
+    {
+        thread_local std::unordered_map<uint64_t, Range> ranges;
+        return ranges;
+    }
+
+    static uint64_t nextId()
+    {
+        static std::atomic<uint64_t> counter{0};
+        return ++counter;
+    }
+
+    void makeDurable(int64_t mark)
+    {
+        if (durable.load() >= mark)
+            return;
+        std::lock_guard<std::mutex> lock(persistMutex);
+        if (durable.load() >= mark)
+            return;
+        // Ranges claimed meanwhile by other threads are covered by the same write
+        int64_t value = std::max(mark, reserved.load());
+        persist(value);
+        durable.store(value);
+    }
+
+public:
+    static constexpr int64_t RANGE_SIZE = 64;
+
+    // highWater: the last persisted mark, every id above it is unused
+    SequenceAllocator(int64_t highWater, std::function<void(int64_t)> persist)
+        : reserved(highWater), durable(highWater), explicitMax(0), persist(std::move(persist)), id(nextId()) {}
+
+    int64_t next()
+    {
+        Range &range = localRanges()[id];
+        // An explicit value may have landed inside the cached range, drop it
+        if (range.next > range.end || range.next <= explicitMax.load(std::memory_order_relaxed))
+        {
+            range.next = reserved.fetch_add(RANGE_SIZE) + 1;
+            range.end = range.next + RANGE_SIZE - 1;
+            makeDurable(range.end);
+        }
+        return range.next++;
+    }
+
+    // Hands back the id next() just returned, for a row rejected after all.
+    // Only the latest id of this thread's range can go back.
+    void release(int64_t value)
+    {
+        Range &range = localRanges()[id];
+        if (range.next - 1 == value)
+            range.next = value;
+    }
+
+    // A row arrived with its own value, later ids must be larger
+    void observe(int64_t value)
+    {
+        int64_t current = explicitMax.load();
+        while (current < value && !explicitMax.compare_exchange_weak(current, value))
+        {
+        }
+        current = reserved.load();
+        while (current < value && !reserved.compare_exchange_weak(current, value))
+        {
+        }
+        makeDurable(value);
+    }
+
+    int64_t highWater() const
+    {
+        return durable.load();
+    }
+};
+
+#endif // __SEQUENCE
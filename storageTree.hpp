@@ -7,9 +7,13 @@
 #include <mutex>
 #include <shared_mutex>
 #include <memory>
+#include <atomic>
 
 template<typename K, typename V>
 class BPlusTree {
+public:
+    using key_type = K;
+
 private:
     static const int DEGREE = 100;
     static const int MAX_KEYS = 2 * DEGREE - 1;
@@ -43,13 +47,16 @@ private:
     // Tree-level mutex for structural changes
     mutable std::shared_mutex tree_mutex;
 
+    // Number of keys stored in the leaves, used as a cardinality estimate
+    std::atomic<size_t> key_count{0};
+
     Node* find_leaf(const K& key) {
         std::shared_lock<std::shared_mutex> tree_lock(tree_mutex);
         
         Node* node = root;
         while (!node->is_leaf) {
             std::shared_lock<std::shared_mutex> node_lock(node->mutex);
-            int i = 0;
+            size_t i = 0;
             while (i < node->keys.size() && key >= node->keys[i]) {
                 i++;
             }
@@ -73,6 +80,7 @@ private:
             // Insert new key-value pair
             leaf->keys.insert(it, key);
             leaf->values.insert(leaf->values.begin() + pos, value);
+            key_count++;
         }
     }
 
@@ -166,6 +174,7 @@ private:
         int pos = it - leaf->keys.begin();
         leaf->keys.erase(it);
         leaf->values.erase(leaf->values.begin() + pos);
+        key_count--;
 
         bool needs_rebalance = (leaf != root && leaf->keys.size() < MIN_KEYS);
         leaf_lock.unlock();
@@ -184,7 +193,7 @@ private:
 
         std::unique_lock<std::shared_mutex> parent_lock(parent->mutex);
         
-        int pos = 0;
+        size_t pos = 0;
         while (pos < parent->children.size() && parent->children[pos] != node) {
             pos++;
         }
@@ -211,7 +220,10 @@ private:
             }
         }
 
-        // Merge with sibling
+        // Merge with sibling. The exclusive tree lock already keeps other
+        // writers out of internal nodes, and the merge may delete or re-lock
+        // the parent, so it must not stay locked here.
+        parent_lock.unlock();
         if (pos > 0) {
             merge_with_left(node, parent->children[pos - 1], pos - 1);
         } else {
@@ -291,8 +303,9 @@ private:
 
     void merge_with_left(Node* node, Node* left_sibling, int parent_key_pos) {
         Node* parent = node->parent;
-        std::unique_lock<std::shared_mutex> node_lock(node->mutex);
+        // Lock left to right, the same order leaf iterators use
         std::unique_lock<std::shared_mutex> left_lock(left_sibling->mutex);
+        std::unique_lock<std::shared_mutex> node_lock(node->mutex);
 
         if (node->is_leaf) {
             left_sibling->keys.insert(left_sibling->keys.end(), node->keys.begin(), node->keys.end());
@@ -315,6 +328,8 @@ private:
 
         node_lock.unlock();
         left_lock.unlock();
+        // The children now belong to left_sibling, keep ~Node from freeing them
+        node->children.clear();
         delete node;
 
         if (parent != root && parent->keys.size() < MIN_KEYS) {
@@ -322,6 +337,7 @@ private:
         } else if (parent == root && parent->keys.empty()) {
             root = left_sibling;
             left_sibling->parent = nullptr;
+            parent->children.clear();
             delete parent;
         }
     }
@@ -353,6 +369,7 @@ private:
 
         node_lock.unlock();
         right_lock.unlock();
+        right_sibling->children.clear();
         delete right_sibling;
 
         if (parent != root && parent->keys.size() < MIN_KEYS) {
@@ -360,6 +377,7 @@ private:
         } else if (parent == root && parent->keys.empty()) {
             root = node;
             node->parent = nullptr;
+            parent->children.clear();
             delete parent;
         }
     }
@@ -401,6 +419,45 @@ private:
     }
 
 public:
+    // Forward cursor over the leaf chain. Holds a shared lock on the leaf it
+    // currently points at and hands it over to the next leaf while advancing,
+    // so range scans and merge joins never see a half-split node.
+    class LeafIterator {
+    private:
+        Node* leaf;
+        size_t pos;
+        std::shared_lock<std::shared_mutex> leaf_lock;
+
+        void skip_exhausted() {
+            while (leaf && pos >= leaf->keys.size()) {
+                Node* next_leaf = leaf->next;
+                leaf_lock = next_leaf ? std::shared_lock<std::shared_mutex>(next_leaf->mutex)
+                                      : std::shared_lock<std::shared_mutex>();
+                leaf = next_leaf;
+                pos = 0;
+            }
+        }
+
+    public:
+        LeafIterator() : leaf(nullptr), pos(0) {}
+        LeafIterator(Node* start, size_t start_pos) : leaf(start), pos(start_pos) {
+            if (leaf) {
+                leaf_lock = std::shared_lock<std::shared_mutex>(leaf->mutex);
+            }
+            skip_exhausted();
+        }
+
+        bool valid() const { return leaf != nullptr; }
+        const K& key() const { return leaf->keys[pos]; }
+        const V& value() const { return leaf->values[pos]; }
+
+        void next() {
+            if (!leaf) return;
+            pos++;
+            skip_exhausted();
+        }
+    };
+
     BPlusTree() {
         root = new Node(true);
     }
@@ -424,12 +481,39 @@ public:
         }
     }
 
+    // Insert unless the key is present, checking and inserting in the same
+    // descent. False if the key was there, its value goes to `existing`.
+    bool insert_if_absent(const K& key, const V& value, V* existing = nullptr) {
+        Node* leaf = find_leaf(key);
+        bool needs_split;
+        {
+            std::unique_lock<std::shared_mutex> leaf_lock(leaf->mutex);
+            auto it = std::lower_bound(leaf->keys.begin(), leaf->keys.end(), key);
+            int pos = it - leaf->keys.begin();
+            if (it != leaf->keys.end() && *it == key) {
+                if (existing) {
+                    *existing = leaf->values[pos];
+                }
+                return false;
+            }
+            leaf->keys.insert(it, key);
+            leaf->values.insert(leaf->values.begin() + pos, value);
+            key_count++;
+            needs_split = leaf->keys.size() > MAX_KEYS;
+        }
+
+        if (needs_split) {
+            split_leaf(leaf);
+        }
+        return true;
+    }
+
     bool search(const K& key, V& value) {
         Node* leaf = find_leaf(key);
         std::shared_lock<std::shared_mutex> leaf_lock(leaf->mutex);
         
-        auto it = std::find(leaf->keys.begin(), leaf->keys.end(), key);
-        if (it != leaf->keys.end()) {
+        auto it = std::lower_bound(leaf->keys.begin(), leaf->keys.end(), key);
+        if (it != leaf->keys.end() && *it == key) {
             int pos = it - leaf->keys.begin();
             value = leaf->values[pos];
             return true;
@@ -442,6 +526,36 @@ public:
         return delete_from_leaf(leaf, key);
     }
 
+    size_t size() const {
+        return key_count.load();
+    }
+
+    // Iterator positioned at the smallest key in the tree
+    LeafIterator begin() {
+        std::shared_lock<std::shared_mutex> tree_lock(tree_mutex);
+
+        Node* node = root;
+        while (!node->is_leaf) {
+            std::shared_lock<std::shared_mutex> node_lock(node->mutex);
+            Node* next_node = node->children[0];
+            node_lock.unlock();
+            node = next_node;
+        }
+        tree_lock.unlock();
+        return LeafIterator(node, 0);
+    }
+
+    // Iterator positioned at the first key that is not less than `key`
+    LeafIterator lower_bound(const K& key) {
+        Node* leaf = find_leaf(key);
+        size_t pos;
+        {
+            std::shared_lock<std::shared_mutex> leaf_lock(leaf->mutex);
+            pos = std::lower_bound(leaf->keys.begin(), leaf->keys.end(), key) - leaf->keys.begin();
+        }
+        return LeafIterator(leaf, pos);
+    }
+
     void print() {
         std::shared_lock<std::shared_mutex> tree_lock(tree_mutex);
         std::cout << "B+ Tree Structure:" << std::endl;
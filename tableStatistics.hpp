@@ -0,0 +1,329 @@
+#ifndef __TABLE_STATISTICS
+#define __TABLE_STATISTICS
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <cmath>
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+#include <filesystem>
+#include "global.hpp"
+#include "jsonWriter.hpp"
+#include "rowStorage.hpp"
+#include "catalogFile.hpp"
+
+// Per-column statistics collected by ANALYZE and persisted next to the
+// table as <table>.stats (JSON). The planner reads them to estimate
+// selectivities; tables that were never analyzed fall back to defaults.
+namespace Statistics
+{
+    constexpr size_t HISTOGRAM_BUCKETS = 32;
+    constexpr size_t SAMPLE_SIZE = 10000;
+    constexpr int HLL_PRECISION = 12; // 4096 registers, ~1.6% standard error
+
+    struct ColumnStatistics
+    {
+        double distinct = 0;      // estimated number of distinct non-NULL values
+        double nullFraction = 0;  // share of rows that are NULL
+        std::vector<FieldValue> bounds; // equi-depth histogram, bounds.size() - 1 buckets
+
+        // Share of non-NULL values below `value` (or at most `value` when inclusive)
+        double fractionBelow(const FieldValue &value, bool inclusive) const
+        {
+            if (bounds.size() < 2)
+                return RANGE_FALLBACK;
+
+            size_t buckets = bounds.size() - 1;
+            double below = 0;
+            for (size_t i = 0; i < buckets; ++i)
+            {
+                const FieldValue &low = bounds[i];
+                const FieldValue &high = bounds[i + 1];
+                int vsHigh = compareFields(value, high);
+                if (vsHigh > 0 || (vsHigh == 0 && inclusive))
+                {
+                    below += 1.0;
+                    continue;
+                }
+                int vsLow = compareFields(value, low);
+                if (vsLow > 0 || (vsLow == 0 && inclusive))
+                {
+                    // Linear interpolation inside the bucket for ints, half a bucket otherwise
+                    if (std::holds_alternative<int>(value) && std::holds_alternative<int>(low) &&
+                        std::holds_alternative<int>(high) && std::get<int>(high) > std::get<int>(low))
+                    {
+                        below += static_cast<double>(std::get<int>(value) - std::get<int>(low)) /
+                                 (static_cast<double>(std::get<int>(high)) - std::get<int>(low));
+                    }
+                    else
+                    {
+                        below += 0.5;
+                    }
+                }
+                break;
+            }
+            return below / buckets;
+        }
+
+        static constexpr double RANGE_FALLBACK = 0.33;
+    };
+
+    struct TableStatistics
+    {
+        double rowCount = 0;
+        std::unordered_map<std::string, ColumnStatistics> columns;
+
+        const ColumnStatistics *column(const std::string &name) const
+        {
+            auto it = columns.find(name);
+            return it == columns.end() ? nullptr : &it->second;
+        }
+    };
+
+    // HyperLogLog distinct-count sketch
+    class DistinctCounter
+    {
+    private:
+        std::vector<uint8_t> registers;
+
+        static uint64_t mix(uint64_t h)
+        {
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdULL;
+            h ^= h >> 33;
+            h *= 0xc4ceb9fe1a85ec53ULL;
+            h ^= h >> 33;
+            return h;
+        }
+
+    public:
+        DistinctCounter() : registers(size_t(1) << HLL_PRECISION, 0) {}
+
+        void add(const FieldValue &value)
+        {
+            uint64_t h = mix(std::hash<FieldValue>{}(value));
+            size_t bucket = h >> (64 - HLL_PRECISION);
+            uint64_t rest = h << HLL_PRECISION;
+            uint8_t rank = rest == 0 ? 64 - HLL_PRECISION + 1 : __builtin_clzll(rest) + 1;
+            registers[bucket] = std::max(registers[bucket], rank);
+        }
+
+        double estimate() const
+        {
+            double m = static_cast<double>(registers.size());
+            double sum = 0;
+            size_t zeros = 0;
+            for (uint8_t r : registers)
+            {
+                sum += std::ldexp(1.0, -r);
+                if (r == 0)
+                    zeros++;
+            }
+            double alpha = 0.7213 / (1 + 1.079 / m);
+            double e = alpha * m * m / sum;
+            // Small-range correction: linear counting
+            if (e <= 2.5 * m && zeros > 0)
+                e = m * std::log(m / zeros);
+            return e;
+        }
+    };
+
+    inline std::string statsFileName(const std::string &dbName, const std::string &tableName)
+    {
+        return tableDirectory + "/" + dbName + "/" + tableName + ".stats";
+    }
+
+    // Full pass over the table: exact row count and null fraction, HLL
+    // distinct counts, histograms from a reservoir sample
+    inline TableStatistics analyzeTable(const TableStorage &storage)
+    {
+        const auto &columns = storage.getColumns();
+        size_t columnCount = columns.size();
+
+        std::vector<DistinctCounter> counters(columnCount);
+        std::vector<double> nulls(columnCount, 0);
+        std::vector<std::vector<FieldValue>> samples(columnCount);
+        std::mt19937_64 random(0x5eed);
+        double rows = 0;
+
+        storage.scan([&](int64_t, const IndexNode &, const Row &row)
+                     {
+                         rows++;
+                         for (size_t c = 0; c < columnCount && c < row.size(); ++c)
+                         {
+                             if (std::holds_alternative<std::nullptr_t>(row[c]))
+                             {
+                                 nulls[c]++;
+                                 continue;
+                             }
+                             counters[c].add(row[c]);
+
+                             // Reservoir sampling over the non-NULL values seen so far
+                             double seen = rows - nulls[c];
+                             if (samples[c].size() < SAMPLE_SIZE)
+                             {
+                                 samples[c].push_back(row[c]);
+                             }
+                             else
+                             {
+                                 uint64_t slot = random() % static_cast<uint64_t>(seen);
+                                 if (slot < SAMPLE_SIZE)
+                                     samples[c][slot] = row[c];
+                             }
+                         }
+                         return true; });
+
+        TableStatistics stats;
+        stats.rowCount = rows;
+        for (size_t c = 0; c < columnCount; ++c)
+        {
+            ColumnStatistics column;
+            column.nullFraction = rows > 0 ? nulls[c] / rows : 0;
+            column.distinct = std::min(std::round(counters[c].estimate()), rows - nulls[c]);
+
+            auto &sample = samples[c];
+            std::sort(sample.begin(), sample.end(), [](const FieldValue &a, const FieldValue &b)
+                      { return compareFields(a, b) < 0; });
+            if (!sample.empty())
+            {
+                size_t buckets = std::min(HISTOGRAM_BUCKETS, sample.size());
+                for (size_t b = 0; b <= buckets; ++b)
+                {
+                    size_t at = std::min(sample.size() - 1, b * sample.size() / buckets);
+                    column.bounds.push_back(sample[at]);
+                }
+            }
+            stats.columns[columns[c]->name] = std::move(column);
+        }
+        return stats;
+    }
+
+    inline void writeField(JSONWriter &writer, const FieldValue &value)
+    {
+        if (std::holds_alternative<int>(value))
+            writer.value(std::get<int>(value));
+        else if (std::holds_alternative<std::string>(value))
+            writer.value(std::get<std::string>(value));
+        else
+            writer.value(nullptr);
+    }
+
+    inline FieldValue fromJSON(const JSONView &value)
+    {
+        if (value.isInt())
+            return value.getInt();
+        if (value.isString())
+            return std::string(value.getString());
+        return nullptr;
+    }
+
+    // A one-element array holding the statistics object, keys in sorted order
+    inline void saveStatistics(const std::string &dbName, const std::string &tableName, const TableStatistics &stats)
+    {
+        std::map<std::string, const ColumnStatistics *> columns;
+        for (const auto &entry : stats.columns)
+            columns[entry.first] = &entry.second;
+
+        JSONWriter writer(JSONWriter::Style::Pretty);
+        writer.beginArray().beginObject().key("columns").beginObject();
+        for (const auto &[name, column] : columns)
+        {
+            writer.key(name).beginObject();
+            writer.key("distinct").value(column->distinct);
+            writer.key("histogram").beginArray();
+            for (const auto &bound : column->bounds)
+                writeField(writer, bound);
+            writer.endArray();
+            writer.key("null_fraction").value(column->nullFraction);
+            writer.endObject();
+        }
+        writer.endObject();
+        writer.key("row_count").value(stats.rowCount);
+        writer.endObject().endArray();
+        CatalogFile::replaceFile(statsFileName(dbName, tableName), writer.str());
+    }
+
+    inline std::shared_ptr<TableStatistics> loadStatistics(const std::string &dbName, const std::string &tableName)
+    {
+        std::string path = statsFileName(dbName, tableName);
+        if (!std::filesystem::exists(path))
+            return nullptr;
+
+        JSONDocument document;
+        if (!document.loadFromFile(path))
+            return nullptr;
+
+        // The file is written as a one-element array holding the statistics object
+        JSONView root = document.root();
+        if (root.isArray())
+        {
+            if (root.size() == 0)
+                return nullptr;
+            root = root[0];
+        }
+        auto rowCount = root.find("row_count");
+        auto columns = root.find("columns");
+        if (!rowCount || !columns || !columns->isObject())
+            return nullptr;
+
+        auto stats = std::make_shared<TableStatistics>();
+        stats->rowCount = rowCount->getDouble();
+        for (auto [name, object] : columns->members())
+        {
+            if (!object.isObject())
+                continue;
+            ColumnStatistics column;
+            if (auto distinct = object.find("distinct"))
+                column.distinct = distinct->getDouble();
+            if (auto nullFraction = object.find("null_fraction"))
+                column.nullFraction = nullFraction->getDouble();
+            if (auto bounds = object.find("histogram"); bounds && bounds->isArray())
+            {
+                for (JSONView bound : bounds->elements())
+                    column.bounds.push_back(fromJSON(bound));
+            }
+            stats->columns[std::string(name)] = std::move(column);
+        }
+        return stats;
+    }
+
+    // --- Statistics Cache ---
+    // db_name -> table_name -> statistics, nullptr when the table has none
+    inline std::unordered_map<std::string, std::unordered_map<std::string, std::shared_ptr<const TableStatistics>>> statisticsCache;
+    inline std::mutex statisticsCacheMutex;
+
+    inline std::shared_ptr<const TableStatistics> getStatistics(const std::string &dbName, const std::string &tableName)
+    {
+        std::lock_guard<std::mutex> lock(statisticsCacheMutex);
+        auto &tables = statisticsCache[dbName];
+        auto it = tables.find(tableName);
+        if (it != tables.end())
+            return it->second;
+
+        auto stats = loadStatistics(dbName, tableName);
+        tables[tableName] = stats;
+        return stats;
+    }
+
+    inline void setStatistics(const std::string &dbName, const std::string &tableName, const TableStatistics &stats)
+    {
+        saveStatistics(dbName, tableName, stats);
+        std::lock_guard<std::mutex> lock(statisticsCacheMutex);
+        statisticsCache[dbName][tableName] = std::make_shared<const TableStatistics>(stats);
+    }
+
+    inline void forgetStatistics(const std::string &dbName, const std::string &tableName)
+    {
+        std::error_code ec;
+        std::filesystem::remove(statsFileName(dbName, tableName), ec);
+        std::lock_guard<std::mutex> lock(statisticsCacheMutex);
+        statisticsCache[dbName].erase(tableName);
+    }
+};
+
+#endif // __TABLE_STATISTICS
@@ -0,0 +1,62 @@
+#!/bin/bash
+# Builds the SQL test driver and runs every tests/sql/*.sql script in a
+# scratch directory, comparing its output with the matching .expected file.
+# A `-- restart` line ends one process and starts the next on the same
+# database files, to check what survives a restart. Files under
+# sql/<name>.files/ are copied into the scratch directory first, for scripts
+# that start from existing database files. `-- repeat FROM TO statement`
+# runs a statement for every i in the range, see sqlTestDriver.cpp.
+#
+# usage: tests/run_tests.sh [--update] [name ...]
+#   --update  rewrite the .expected files from the current output
+
+set -u
+cd "$(dirname "$0")"
+TESTS_DIR="$(pwd)"
+BUILD_DIR="${BUILD_DIR:-$TESTS_DIR/../_test_build}"
+mkdir -p "$BUILD_DIR"
+
+update=0
+if [ "${1:-}" == "--update" ]; then
+    update=1
+    shift
+fi
+
+g++ -std=c++17 -O1 -pthread -o "$BUILD_DIR/sqlTestDriver" sqlTestDriver.cpp || exit 1
+
+if [ $# -gt 0 ]; then
+    scripts=()
+    for name in "$@"; do scripts+=("sql/$name.sql"); done
+else
+    scripts=(sql/*.sql)
+fi
+
+failed=0
+for script in "${scripts[@]}"; do
+    name="$(basename "$script" .sql)"
+    work="$(mktemp -d)"
+    mkdir -p "$work/parts"
+    [ -d "sql/$name.files" ] && cp -r "sql/$name.files/." "$work/"
+    awk -v dir="$work/parts" 'BEGIN { part = 0 } /^-- restart/ { part++; next } { print > (dir "/" part ".sql") }' "$script"
+
+    actual="$work/actual"
+    : > "$actual"
+    for part in $(ls "$work/parts" | sort -n); do
+        (cd "$work" && "$BUILD_DIR/sqlTestDriver" "parts/$part") >> "$actual" 2>/dev/null
+        [ "$part" != "$(ls "$work/parts" | sort -n | tail -1)" ] && echo "-- restart" >> "$actual"
+    done
+
+    expected="sql/$name.expected"
+    if [ $update -eq 1 ]; then
+        cp "$actual" "$expected"
+        echo "updated $name"
+    elif diff -u "$expected" "$actual" > "$work/diff"; then
+        echo "PASS $name"
+    else
+        echo "FAIL $name"
+        cat "$work/diff"
+        failed=1
+    fi
+    rm -rf "$work"
+done
+exit $failed
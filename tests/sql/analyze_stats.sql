@@ -0,0 +1,50 @@
+-- ANALYZE writes <table>.stats quietly and the planner reads it after a restart
+CREATE DATABASE stattest;
+CREATE TABLE t (id INT PRIMARY KEY, grp INT, name VARCHAR(10));
+INSERT INTO t (id, grp, name) VALUES (1, 1, 'n1');
+INSERT INTO t (id, grp, name) VALUES (2, 1, 'n2');
+INSERT INTO t (id, grp, name) VALUES (3, 1, 'n3');
+INSERT INTO t (id, grp, name) VALUES (4, 1, 'n4');
+INSERT INTO t (id, grp, name) VALUES (5, 1, 'n5');
+INSERT INTO t (id, grp, name) VALUES (6, 1, 'n6');
+INSERT INTO t (id, grp, name) VALUES (7, 1, 'n7');
+INSERT INTO t (id, grp, name) VALUES (8, 1, 'n8');
+INSERT INTO t (id, grp, name) VALUES (9, 1, 'n9');
+INSERT INTO t (id, grp, name) VALUES (10, 1, 'n10');
+INSERT INTO t (id, grp, name) VALUES (11, 1, 'n11');
+INSERT INTO t (id, grp, name) VALUES (12, 1, 'n12');
+INSERT INTO t (id, grp, name) VALUES (13, 1, 'n13');
+INSERT INTO t (id, grp, name) VALUES (14, 1, 'n14');
+INSERT INTO t (id, grp, name) VALUES (15, 1, 'n15');
+INSERT INTO t (id, grp, name) VALUES (16, 1, 'n16');
+INSERT INTO t (id, grp, name) VALUES (17, 1, 'n17');
+INSERT INTO t (id, grp, name) VALUES (18, 1, 'n18');
+INSERT INTO t (id, grp, name) VALUES (19, 1, 'n19');
+INSERT INTO t (id, grp, name) VALUES (20, 1, 'n20');
+INSERT INTO t (id, grp, name) VALUES (21, 1, 'n21');
+INSERT INTO t (id, grp, name) VALUES (22, 1, 'n22');
+INSERT INTO t (id, grp, name) VALUES (23, 1, 'n23');
+INSERT INTO t (id, grp, name) VALUES (24, 1, 'n24');
+INSERT INTO t (id, grp, name) VALUES (25, 1, 'n25');
+INSERT INTO t (id, grp, name) VALUES (26, 1, 'n26');
+INSERT INTO t (id, grp, name) VALUES (27, 1, 'n27');
+INSERT INTO t (id, grp, name) VALUES (28, 1, 'n28');
+INSERT INTO t (id, grp, name) VALUES (29, 1, 'n29');
+INSERT INTO t (id, grp, name) VALUES (30, 1, 'n30');
+INSERT INTO t (id, grp, name) VALUES (31, 1, 'n31');
+INSERT INTO t (id, grp, name) VALUES (32, 1, 'n32');
+INSERT INTO t (id, grp, name) VALUES (33, 1, 'n33');
+INSERT INTO t (id, grp, name) VALUES (34, 1, 'n34');
+INSERT INTO t (id, grp, name) VALUES (35, 1, 'n35');
+INSERT INTO t (id, grp, name) VALUES (36, 1, 'n36');
+INSERT INTO t (id, grp, name) VALUES (37, 37, 'n37');
+INSERT INTO t (id, grp, name) VALUES (38, 38, 'n38');
+INSERT INTO t (id, grp, name) VALUES (39, 39, 'n39');
+INSERT INTO t (id, grp, name) VALUES (40, 40, 'n40');
+ANALYZE t;
+EXPLAIN SELECT id FROM t WHERE grp = 1;
+EXPLAIN SELECT id FROM t WHERE grp = 40;
+-- restart
+EXPLAIN SELECT id FROM t WHERE grp = 1;
+EXPLAIN SELECT id FROM t WHERE grp = 40;
+SELECT id FROM t WHERE grp = 40;
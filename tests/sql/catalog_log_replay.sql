@@ -0,0 +1,21 @@
+-- DDL is logged and replayed at startup, then folded into a checkpoint
+CREATE DATABASE logtest;
+CREATE TABLE t (id INT PRIMARY KEY, name VARCHAR(10));
+INSERT INTO t (id, name) VALUES (1, 'one');
+INSERT INTO t (id, name) VALUES (2, 'two');
+ALTER TABLE t ADD COLUMN score INT DEFAULT 5;
+ALTER TABLE t ADD COLUMN tag VARCHAR(8);
+INSERT INTO t (id, name, score, tag) VALUES (3, 'three', 9, 'x');
+CREATE INDEX ON t (score) INCLUDE (name);
+CREATE TABLE u (id INT PRIMARY KEY AUTO_INCREMENT, t_id INT UNIQUE);
+INSERT INTO u (t_id) VALUES (3);
+-- restart
+SELECT id, name, score, tag FROM t;
+EXPLAIN SELECT name FROM t WHERE score = 5;
+SELECT name FROM t WHERE score = 5;
+INSERT INTO t (id, name, tag) VALUES (4, 'four', 'y');
+INSERT INTO u (t_id) VALUES (1);
+ALTER TABLE u ADD COLUMN note VARCHAR(10) DEFAULT 'none';
+-- restart
+SELECT id, t_id, note FROM u;
+SELECT t.name, u.note FROM t JOIN u ON t.id = u.t_id;
@@ -0,0 +1,21 @@
+-- Columnar tables: a full row group is sealed into encoded segments with zone maps
+CREATE DATABASE coltest;
+CREATE TABLE events (id INT PRIMARY KEY, kind VARCHAR(10), value INT, code VARCHAR(12) UNIQUE) ENGINE = COLUMNAR;
+-- One sealed group of 65536 rows plus a tail
+-- repeat 1 65600 INSERT INTO events (id, kind, value, code) VALUES ({i}, 'k{i%3}', {i%1000}, 'e{i}');
+SELECT id, kind, value, code FROM events WHERE id < 4;
+-- The sealed group's zone map on id rules it out, only the tail is read
+EXPLAIN ANALYZE SELECT kind FROM events WHERE id > 65590 AND value > 0;
+SELECT kind FROM events WHERE id > 65590 AND value > 0;
+-- Reads inside the group decode its dictionary and integer segments
+SELECT id, kind FROM events WHERE value = 999 AND id < 5000;
+SELECT id FROM events WHERE kind = 'k2' AND value < 3 AND id < 9000;
+SELECT id, value FROM events WHERE code = 'e65536';
+UPDATE events SET kind = 'buy' WHERE id = 9;
+DELETE FROM events WHERE id = 3;
+ALTER TABLE events ADD COLUMN tag VARCHAR(4) DEFAULT 'new';
+-- restart
+SELECT id, kind, value, code, tag FROM events WHERE id < 10;
+SELECT id, tag FROM events WHERE id > 65598;
+INSERT INTO events (id, kind, value, code) VALUES (65601, 'k1', 1, 'e1');
+SELECT id FROM events WHERE code = 'e1';
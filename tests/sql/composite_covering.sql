@@ -0,0 +1,68 @@
+-- Composite keys serve equality prefixes and a range on the next column; INCLUDE makes scans index-only
+CREATE DATABASE comptest;
+CREATE TABLE orders (id INT PRIMARY KEY, customer INT, day INT, amount INT, note VARCHAR(10));
+INSERT INTO orders (id, customer, day, amount, note) VALUES (1, 1, 1, 10, 'o1');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (2, 2, 2, 20, 'o2');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (3, 3, 3, 30, 'o3');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (4, 4, 4, 40, 'o4');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (5, 5, 5, 50, 'o5');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (6, 0, 6, 60, 'o6');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (7, 1, 7, 70, 'o7');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (8, 2, 0, 80, 'o8');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (9, 3, 1, 90, 'o9');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (10, 4, 2, 100, 'o10');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (11, 5, 3, 110, 'o11');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (12, 0, 4, 120, 'o12');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (13, 1, 5, 130, 'o13');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (14, 2, 6, 140, 'o14');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (15, 3, 7, 150, 'o15');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (16, 4, 0, 160, 'o16');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (17, 5, 1, 170, 'o17');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (18, 0, 2, 180, 'o18');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (19, 1, 3, 190, 'o19');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (20, 2, 4, 200, 'o20');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (21, 3, 5, 210, 'o21');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (22, 4, 6, 220, 'o22');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (23, 5, 7, 230, 'o23');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (24, 0, 0, 240, 'o24');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (25, 1, 1, 250, 'o25');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (26, 2, 2, 260, 'o26');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (27, 3, 3, 270, 'o27');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (28, 4, 4, 280, 'o28');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (29, 5, 5, 290, 'o29');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (30, 0, 6, 300, 'o30');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (31, 1, 7, 310, 'o31');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (32, 2, 0, 320, 'o32');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (33, 3, 1, 330, 'o33');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (34, 4, 2, 340, 'o34');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (35, 5, 3, 350, 'o35');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (36, 0, 4, 360, 'o36');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (37, 1, 5, 370, 'o37');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (38, 2, 6, 380, 'o38');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (39, 3, 7, 390, 'o39');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (40, 4, 0, 400, 'o40');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (41, 5, 1, 410, 'o41');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (42, 0, 2, 420, 'o42');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (43, 1, 3, 430, 'o43');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (44, 2, 4, 440, 'o44');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (45, 3, 5, 450, 'o45');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (46, 4, 6, 460, 'o46');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (47, 5, 7, 470, 'o47');
+INSERT INTO orders (id, customer, day, amount, note) VALUES (48, 0, 0, 480, 'o48');
+INSERT INTO orders (id, note) VALUES (49, 'nulls');
+CREATE INDEX cust_day ON orders (customer, day) INCLUDE (amount) USING ART;
+CREATE INDEX ON orders (customer, day);
+EXPLAIN SELECT id, amount FROM orders WHERE customer = 2 AND day = 2;
+SELECT id, amount FROM orders WHERE customer = 2 AND day = 2;
+EXPLAIN SELECT day, amount FROM orders WHERE customer = 3 AND day > 3;
+SELECT day, amount FROM orders WHERE customer = 3 AND day > 3;
+SELECT amount FROM orders WHERE customer = 1;
+EXPLAIN SELECT note FROM orders WHERE customer = 5 AND day = 5;
+SELECT note FROM orders WHERE customer = 5 AND day = 5;
+SELECT id FROM orders WHERE day = 4 AND customer = 4;
+CREATE INDEX bad ON orders (customer, missing);
+UPDATE orders SET amount = 1 WHERE id = 26;
+DELETE FROM orders WHERE id = 2;
+-- restart
+SELECT id, amount FROM orders WHERE customer = 2 AND day = 2;
+SELECT id, amount FROM orders WHERE customer = 2 AND day < 3;
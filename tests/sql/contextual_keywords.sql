@@ -0,0 +1,20 @@
+-- Words that became keywords with later statements still work as names
+CREATE DATABASE kwtest;
+CREATE TABLE index (id INT PRIMARY KEY, default INT, using VARCHAR(10) UNIQUE, include INT);
+INSERT INTO index (id, default, using, include) VALUES (1, 10, 'a', 100);
+INSERT INTO index (id, default, using, include) VALUES (2, 20, 'b', 200);
+INSERT INTO index (id, default, using, include) VALUES (3, 30, 'c', 300);
+SELECT index.id, default, using FROM index WHERE include > 100 ORDER BY default DESC;
+ALTER TABLE index ADD column INT DEFAULT 7;
+ALTER TABLE index ADD COLUMN engine VARCHAR(10) DEFAULT 'row';
+CREATE INDEX include ON index (using) INCLUDE (default) USING BTREE;
+EXPLAIN SELECT default FROM index WHERE using = 'b';
+UPDATE index SET default = 21 WHERE using = 'b';
+DELETE FROM index WHERE column = 7 AND id = 3;
+ANALYZE index;
+VACUUM index;
+-- restart
+SELECT id, default, using, include, column, engine FROM index;
+CREATE TABLE add (analyze INT PRIMARY KEY, explain VARCHAR(10)) ENGINE = COLUMNAR;
+INSERT INTO add (analyze, explain) VALUES (1, 'x');
+SELECT explain FROM add WHERE analyze = 1;
@@ -0,0 +1,16 @@
+-- A literal of another type matches the same rows on indexed and plain columns
+CREATE DATABASE typetest;
+CREATE TABLE t (id INT PRIMARY KEY, code VARCHAR(10) UNIQUE, grp INT);
+INSERT INTO t (id, code, grp) VALUES (1, '5', 1);
+INSERT INTO t (id, code, grp) VALUES (2, 'b', 2);
+INSERT INTO t (id, code, grp) VALUES (3, '7', 2);
+EXPLAIN SELECT id, code FROM t WHERE id = '2';
+SELECT id, code FROM t WHERE id = '2';
+SELECT id, code FROM t WHERE code = 5;
+SELECT id, code FROM t WHERE grp = '2';
+UPDATE t SET grp = 9 WHERE id = '1';
+UPDATE t SET grp = 8 WHERE code = 7;
+SELECT id, grp FROM t;
+DELETE FROM t WHERE code = 5;
+DELETE FROM t WHERE id = '2';
+SELECT id, code FROM t;
@@ -0,0 +1,37 @@
+-- Writes after ALTER TABLE and CREATE INDEX reach the new column and
+-- indexes, through vacuum relocation and a restart (DDL log replay)
+CREATE DATABASE ddltest;
+CREATE TABLE t (id INT PRIMARY KEY, grp INT, name VARCHAR(20));
+INSERT INTO t (id, grp, name) VALUES (1, 1, 'row1');
+INSERT INTO t (id, grp, name) VALUES (2, 2, 'row2');
+INSERT INTO t (id, grp, name) VALUES (3, 3, 'row3');
+INSERT INTO t (id, grp, name) VALUES (4, 0, 'row4');
+INSERT INTO t (id, grp, name) VALUES (5, 1, 'row5');
+INSERT INTO t (id, grp, name) VALUES (6, 2, 'row6');
+INSERT INTO t (id, grp, name) VALUES (7, 3, 'row7');
+INSERT INTO t (id, grp, name) VALUES (8, 0, 'row8');
+INSERT INTO t (id, grp, name) VALUES (9, 1, 'row9');
+INSERT INTO t (id, grp, name) VALUES (10, 2, 'row10');
+INSERT INTO t (id, grp, name) VALUES (11, 3, 'row11');
+INSERT INTO t (id, grp, name) VALUES (12, 0, 'row12');
+INSERT INTO t (id, grp, name) VALUES (13, 1, 'row13');
+INSERT INTO t (id, grp, name) VALUES (14, 2, 'row14');
+INSERT INTO t (id, grp, name) VALUES (15, 3, 'row15');
+INSERT INTO t (id, grp, name) VALUES (16, 0, 'row16');
+INSERT INTO t (id, grp, name) VALUES (17, 1, 'row17');
+INSERT INTO t (id, grp, name) VALUES (18, 2, 'row18');
+INSERT INTO t (id, grp, name) VALUES (19, 3, 'row19');
+INSERT INTO t (id, grp, name) VALUES (20, 0, 'row20');
+ALTER TABLE t ADD COLUMN score INT DEFAULT 7;
+CREATE INDEX gs ON t (grp, score);
+INSERT INTO t (id, grp, name, score) VALUES (21, 1, 'row21', 3);
+UPDATE t SET score = 1 WHERE id = 5;
+UPDATE t SET name = 'a much longer name' WHERE grp = 1;
+DELETE FROM t WHERE id = 9;
+VACUUM t;
+EXPLAIN SELECT id, score FROM t WHERE grp = 1 AND score < 7;
+SELECT id, score FROM t WHERE grp = 1 AND score < 7;
+SELECT id, name FROM t WHERE grp = 1 AND score = 7;
+-- restart
+SELECT id, score FROM t WHERE grp = 1 AND score < 7;
+SELECT id, score, name FROM t WHERE id = 13;
@@ -0,0 +1,50 @@
+-- EXPLAIN ANALYZE reports what each operator did; a LIMIT stops the scan early
+CREATE DATABASE pagetest;
+CREATE TABLE t (id INT PRIMARY KEY, name VARCHAR(10));
+INSERT INTO t (id, name) VALUES (1, 'n1');
+INSERT INTO t (id, name) VALUES (2, 'n2');
+INSERT INTO t (id, name) VALUES (3, 'n3');
+INSERT INTO t (id, name) VALUES (4, 'n4');
+INSERT INTO t (id, name) VALUES (5, 'n5');
+INSERT INTO t (id, name) VALUES (6, 'n6');
+INSERT INTO t (id, name) VALUES (7, 'n7');
+INSERT INTO t (id, name) VALUES (8, 'n8');
+INSERT INTO t (id, name) VALUES (9, 'n9');
+INSERT INTO t (id, name) VALUES (10, 'n10');
+INSERT INTO t (id, name) VALUES (11, 'n11');
+INSERT INTO t (id, name) VALUES (12, 'n12');
+INSERT INTO t (id, name) VALUES (13, 'n13');
+INSERT INTO t (id, name) VALUES (14, 'n14');
+INSERT INTO t (id, name) VALUES (15, 'n15');
+INSERT INTO t (id, name) VALUES (16, 'n16');
+INSERT INTO t (id, name) VALUES (17, 'n17');
+INSERT INTO t (id, name) VALUES (18, 'n18');
+INSERT INTO t (id, name) VALUES (19, 'n19');
+INSERT INTO t (id, name) VALUES (20, 'n20');
+INSERT INTO t (id, name) VALUES (21, 'n21');
+INSERT INTO t (id, name) VALUES (22, 'n22');
+INSERT INTO t (id, name) VALUES (23, 'n23');
+INSERT INTO t (id, name) VALUES (24, 'n24');
+INSERT INTO t (id, name) VALUES (25, 'n25');
+INSERT INTO t (id, name) VALUES (26, 'n26');
+INSERT INTO t (id, name) VALUES (27, 'n27');
+INSERT INTO t (id, name) VALUES (28, 'n28');
+INSERT INTO t (id, name) VALUES (29, 'n29');
+INSERT INTO t (id, name) VALUES (30, 'n30');
+INSERT INTO t (id, name) VALUES (31, 'n31');
+INSERT INTO t (id, name) VALUES (32, 'n32');
+INSERT INTO t (id, name) VALUES (33, 'n33');
+INSERT INTO t (id, name) VALUES (34, 'n34');
+INSERT INTO t (id, name) VALUES (35, 'n35');
+INSERT INTO t (id, name) VALUES (36, 'n36');
+INSERT INTO t (id, name) VALUES (37, 'n37');
+INSERT INTO t (id, name) VALUES (38, 'n38');
+INSERT INTO t (id, name) VALUES (39, 'n39');
+INSERT INTO t (id, name) VALUES (40, 'n40');
+-- Keyset pagination: each page seeks past the last id of the previous one
+EXPLAIN SELECT id, name FROM t WHERE id > 10 ORDER BY id LIMIT 3;
+SELECT id, name FROM t WHERE id > 10 ORDER BY id LIMIT 3;
+SELECT id, name FROM t WHERE id > 13 ORDER BY id LIMIT 3;
+EXPLAIN ANALYZE SELECT id, name FROM t WHERE id > 13 ORDER BY id LIMIT 3;
+EXPLAIN ANALYZE SELECT id FROM t WHERE name = 'n7';
+SELECT id FROM t ORDER BY id DESC LIMIT 2;
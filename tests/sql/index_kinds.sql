@@ -0,0 +1,81 @@
+-- HASH and ART indexes: both serve equality, only ART serves ranges and order
+CREATE DATABASE kindtest;
+CREATE TABLE t (id INT PRIMARY KEY, code VARCHAR(10) UNIQUE, serial INT UNIQUE);
+INSERT INTO t (id, code, serial) VALUES (1, 'c1', 7);
+INSERT INTO t (id, code, serial) VALUES (2, 'c2', 14);
+INSERT INTO t (id, code, serial) VALUES (3, 'c3', 21);
+INSERT INTO t (id, code, serial) VALUES (4, 'c4', 28);
+INSERT INTO t (id, code, serial) VALUES (5, 'c5', 35);
+INSERT INTO t (id, code, serial) VALUES (6, 'c6', 42);
+INSERT INTO t (id, code, serial) VALUES (7, 'c7', 49);
+INSERT INTO t (id, code, serial) VALUES (8, 'c8', 56);
+INSERT INTO t (id, code, serial) VALUES (9, 'c9', 63);
+INSERT INTO t (id, code, serial) VALUES (10, 'c10', 70);
+INSERT INTO t (id, code, serial) VALUES (11, 'c11', 77);
+INSERT INTO t (id, code, serial) VALUES (12, 'c12', 84);
+INSERT INTO t (id, code, serial) VALUES (13, 'c13', 91);
+INSERT INTO t (id, code, serial) VALUES (14, 'c14', 98);
+INSERT INTO t (id, code, serial) VALUES (15, 'c15', 105);
+INSERT INTO t (id, code, serial) VALUES (16, 'c16', 112);
+INSERT INTO t (id, code, serial) VALUES (17, 'c17', 119);
+INSERT INTO t (id, code, serial) VALUES (18, 'c18', 126);
+INSERT INTO t (id, code, serial) VALUES (19, 'c19', 133);
+INSERT INTO t (id, code, serial) VALUES (20, 'c20', 140);
+INSERT INTO t (id, code, serial) VALUES (21, 'c21', 147);
+INSERT INTO t (id, code, serial) VALUES (22, 'c22', 154);
+INSERT INTO t (id, code, serial) VALUES (23, 'c23', 161);
+INSERT INTO t (id, code, serial) VALUES (24, 'c24', 168);
+INSERT INTO t (id, code, serial) VALUES (25, 'c25', 175);
+INSERT INTO t (id, code, serial) VALUES (26, 'c26', 182);
+INSERT INTO t (id, code, serial) VALUES (27, 'c27', 189);
+INSERT INTO t (id, code, serial) VALUES (28, 'c28', 196);
+INSERT INTO t (id, code, serial) VALUES (29, 'c29', 203);
+INSERT INTO t (id, code, serial) VALUES (30, 'c30', 210);
+INSERT INTO t (id, code, serial) VALUES (31, 'c31', 217);
+INSERT INTO t (id, code, serial) VALUES (32, 'c32', 224);
+INSERT INTO t (id, code, serial) VALUES (33, 'c33', 231);
+INSERT INTO t (id, code, serial) VALUES (34, 'c34', 238);
+INSERT INTO t (id, code, serial) VALUES (35, 'c35', 245);
+INSERT INTO t (id, code, serial) VALUES (36, 'c36', 252);
+INSERT INTO t (id, code, serial) VALUES (37, 'c37', 259);
+INSERT INTO t (id, code, serial) VALUES (38, 'c38', 266);
+INSERT INTO t (id, code, serial) VALUES (39, 'c39', 273);
+INSERT INTO t (id, code, serial) VALUES (40, 'c40', 280);
+INSERT INTO t (id, code, serial) VALUES (41, 'c41', 287);
+INSERT INTO t (id, code, serial) VALUES (42, 'c42', 294);
+INSERT INTO t (id, code, serial) VALUES (43, 'c43', 301);
+INSERT INTO t (id, code, serial) VALUES (44, 'c44', 308);
+INSERT INTO t (id, code, serial) VALUES (45, 'c45', 315);
+INSERT INTO t (id, code, serial) VALUES (46, 'c46', 322);
+INSERT INTO t (id, code, serial) VALUES (47, 'c47', 329);
+INSERT INTO t (id, code, serial) VALUES (48, 'c48', 336);
+INSERT INTO t (id, code, serial) VALUES (49, 'c49', 343);
+INSERT INTO t (id, code, serial) VALUES (50, 'c50', 350);
+INSERT INTO t (id, code, serial) VALUES (51, 'c51', 357);
+INSERT INTO t (id, code, serial) VALUES (52, 'c52', 364);
+INSERT INTO t (id, code, serial) VALUES (53, 'c53', 371);
+INSERT INTO t (id, code, serial) VALUES (54, 'c54', 378);
+INSERT INTO t (id, code, serial) VALUES (55, 'c55', 385);
+INSERT INTO t (id, code, serial) VALUES (56, 'c56', 392);
+INSERT INTO t (id, code, serial) VALUES (57, 'c57', 399);
+INSERT INTO t (id, code, serial) VALUES (58, 'c58', 406);
+INSERT INTO t (id, code, serial) VALUES (59, 'c59', 413);
+INSERT INTO t (id, code, serial) VALUES (60, 'c60', 420);
+CREATE INDEX code_hash ON t (code) USING HASH;
+CREATE INDEX serial_art ON t (serial) USING ART;
+CREATE INDEX ON t (code) USING BANANA;
+EXPLAIN SELECT id FROM t WHERE code = 'c12';
+SELECT id FROM t WHERE code = 'c12';
+EXPLAIN SELECT id FROM t WHERE code > 'c18';
+EXPLAIN SELECT id FROM t WHERE serial = 49;
+SELECT id FROM t WHERE serial = 49;
+ANALYZE t;
+EXPLAIN SELECT serial FROM t WHERE serial >= 400 ORDER BY serial;
+SELECT serial FROM t WHERE serial >= 400 ORDER BY serial;
+INSERT INTO t (id, code, serial) VALUES (21, 'c12', 1);
+UPDATE t SET serial = 2 WHERE id = 20;
+DELETE FROM t WHERE code = 'c3';
+-- restart
+SELECT id FROM t WHERE code = 'c3';
+SELECT id, code FROM t WHERE serial = 2;
+SELECT id FROM t WHERE serial < 20;
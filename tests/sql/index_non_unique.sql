@@ -0,0 +1,46 @@
+-- CREATE INDEX on a column that repeats keeps every row reachable
+CREATE DATABASE idxtest;
+CREATE TABLE t (id INT PRIMARY KEY, grp INT, name VARCHAR(10) UNIQUE);
+INSERT INTO t (id, grp, name) VALUES (1, 1, 'n1');
+INSERT INTO t (id, grp, name) VALUES (2, 2, 'n2');
+INSERT INTO t (id, grp, name) VALUES (3, 0, 'n3');
+INSERT INTO t (id, grp, name) VALUES (4, 1, 'n4');
+INSERT INTO t (id, grp, name) VALUES (5, 2, 'n5');
+INSERT INTO t (id, grp, name) VALUES (6, 0, 'n6');
+INSERT INTO t (id, grp, name) VALUES (7, 1, 'n7');
+INSERT INTO t (id, grp, name) VALUES (8, 2, 'n8');
+INSERT INTO t (id, grp, name) VALUES (9, 0, 'n9');
+INSERT INTO t (id, grp, name) VALUES (10, 1, 'n10');
+INSERT INTO t (id, grp, name) VALUES (11, 2, 'n11');
+INSERT INTO t (id, grp, name) VALUES (12, 0, 'n12');
+INSERT INTO t (id, grp, name) VALUES (13, 1, 'n13');
+INSERT INTO t (id, grp, name) VALUES (14, 2, 'n14');
+INSERT INTO t (id, grp, name) VALUES (15, 0, 'n15');
+INSERT INTO t (id, grp, name) VALUES (16, 1, 'n16');
+INSERT INTO t (id, grp, name) VALUES (17, 2, 'n17');
+INSERT INTO t (id, grp, name) VALUES (18, 0, 'n18');
+INSERT INTO t (id, grp, name) VALUES (19, 1, 'n19');
+INSERT INTO t (id, grp, name) VALUES (20, 2, 'n20');
+INSERT INTO t (id, grp, name) VALUES (21, 0, 'n21');
+INSERT INTO t (id, grp, name) VALUES (22, 1, 'n22');
+INSERT INTO t (id, grp, name) VALUES (23, 2, 'n23');
+INSERT INTO t (id, grp, name) VALUES (24, 0, 'n24');
+INSERT INTO t (id, grp, name) VALUES (25, 1, 'n25');
+INSERT INTO t (id, grp, name) VALUES (26, 2, 'n26');
+INSERT INTO t (id, grp, name) VALUES (27, 0, 'n27');
+INSERT INTO t (id, grp, name) VALUES (28, 1, 'n28');
+INSERT INTO t (id, grp, name) VALUES (29, 2, 'n29');
+INSERT INTO t (id, grp, name) VALUES (30, 0, 'n30');
+CREATE INDEX ON t (grp);
+EXPLAIN SELECT id FROM t WHERE grp = 2;
+SELECT id FROM t WHERE grp = 2;
+SELECT id FROM t WHERE grp > 0 AND id < 8;
+CREATE INDEX grp_hash ON t (grp) USING HASH;
+-- Unique columns take any kind
+CREATE INDEX ON t (name) USING HASH;
+EXPLAIN SELECT id FROM t WHERE name = 'n7';
+SELECT id FROM t WHERE name = 'n7';
+DELETE FROM t WHERE grp = 1;
+-- restart
+SELECT id FROM t WHERE grp = 2 AND id > 20;
+SELECT id FROM t WHERE grp = 1;
@@ -0,0 +1,15 @@
+-- A rejected duplicate spends no AUTO_INCREMENT id
+CREATE DATABASE duptest;
+CREATE TABLE users (id INT PRIMARY KEY AUTO_INCREMENT, email VARCHAR(20) UNIQUE, name VARCHAR(10));
+INSERT INTO users (email, name) VALUES ('a@x', 'a');
+INSERT INTO users (email, name) VALUES ('a@x', 'again');
+INSERT INTO users (id, email, name) VALUES (1, 'c@x', 'c');
+INSERT INTO users (email, name) VALUES ('b@x', 'b');
+INSERT INTO users (email, name) VALUES ('b@x', 'again');
+INSERT INTO users (email, name) VALUES ('d@x', 'd');
+SELECT id, email, name FROM users;
+INSERT INTO users (name) VALUES ('e');
+INSERT INTO users (name) VALUES ('f');
+-- restart
+INSERT INTO users (email, name) VALUES ('g@x', 'g');
+SELECT id, email, name FROM users WHERE id > 2;
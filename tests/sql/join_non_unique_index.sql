@@ -0,0 +1,66 @@
+-- Joins on an indexed column that repeats must return every matching row
+CREATE DATABASE jointest;
+CREATE TABLE a (id INT PRIMARY KEY, grp INT);
+CREATE TABLE b (id INT PRIMARY KEY, grp INT, label VARCHAR(10));
+INSERT INTO a (id, grp) VALUES (1, 1);
+INSERT INTO a (id, grp) VALUES (2, 2);
+INSERT INTO a (id, grp) VALUES (3, 3);
+INSERT INTO a (id, grp) VALUES (4, 4);
+INSERT INTO a (id, grp) VALUES (5, 5);
+INSERT INTO b (id, grp, label) VALUES (1, 2, 'b1');
+INSERT INTO b (id, grp, label) VALUES (2, 3, 'b2');
+INSERT INTO b (id, grp, label) VALUES (3, 4, 'b3');
+INSERT INTO b (id, grp, label) VALUES (4, 5, 'b4');
+INSERT INTO b (id, grp, label) VALUES (5, 1, 'b5');
+INSERT INTO b (id, grp, label) VALUES (6, 2, 'b6');
+INSERT INTO b (id, grp, label) VALUES (7, 3, 'b7');
+INSERT INTO b (id, grp, label) VALUES (8, 4, 'b8');
+INSERT INTO b (id, grp, label) VALUES (9, 5, 'b9');
+INSERT INTO b (id, grp, label) VALUES (10, 1, 'b10');
+INSERT INTO b (id, grp, label) VALUES (11, 2, 'b11');
+INSERT INTO b (id, grp, label) VALUES (12, 3, 'b12');
+INSERT INTO b (id, grp, label) VALUES (13, 4, 'b13');
+INSERT INTO b (id, grp, label) VALUES (14, 5, 'b14');
+INSERT INTO b (id, grp, label) VALUES (15, 1, 'b15');
+INSERT INTO b (id, grp, label) VALUES (16, 2, 'b16');
+INSERT INTO b (id, grp, label) VALUES (17, 3, 'b17');
+INSERT INTO b (id, grp, label) VALUES (18, 4, 'b18');
+INSERT INTO b (id, grp, label) VALUES (19, 5, 'b19');
+INSERT INTO b (id, grp, label) VALUES (20, 1, 'b20');
+INSERT INTO b (id, grp, label) VALUES (21, 2, 'b21');
+INSERT INTO b (id, grp, label) VALUES (22, 3, 'b22');
+INSERT INTO b (id, grp, label) VALUES (23, 4, 'b23');
+INSERT INTO b (id, grp, label) VALUES (24, 5, 'b24');
+INSERT INTO b (id, grp, label) VALUES (25, 1, 'b25');
+INSERT INTO b (id, grp, label) VALUES (26, 2, 'b26');
+INSERT INTO b (id, grp, label) VALUES (27, 3, 'b27');
+INSERT INTO b (id, grp, label) VALUES (28, 4, 'b28');
+INSERT INTO b (id, grp, label) VALUES (29, 5, 'b29');
+INSERT INTO b (id, grp, label) VALUES (30, 1, 'b30');
+INSERT INTO b (id, grp, label) VALUES (31, 2, 'b31');
+INSERT INTO b (id, grp, label) VALUES (32, 3, 'b32');
+INSERT INTO b (id, grp, label) VALUES (33, 4, 'b33');
+INSERT INTO b (id, grp, label) VALUES (34, 5, 'b34');
+INSERT INTO b (id, grp, label) VALUES (35, 1, 'b35');
+INSERT INTO b (id, grp, label) VALUES (36, 2, 'b36');
+INSERT INTO b (id, grp, label) VALUES (37, 3, 'b37');
+INSERT INTO b (id, grp, label) VALUES (38, 4, 'b38');
+INSERT INTO b (id, grp, label) VALUES (39, 5, 'b39');
+INSERT INTO b (id, grp, label) VALUES (40, 1, 'b40');
+INSERT INTO b (id, grp, label) VALUES (41, 2, 'b41');
+INSERT INTO b (id, grp, label) VALUES (42, 3, 'b42');
+INSERT INTO b (id, grp, label) VALUES (43, 4, 'b43');
+INSERT INTO b (id, grp, label) VALUES (44, 5, 'b44');
+INSERT INTO b (id, grp, label) VALUES (45, 1, 'b45');
+INSERT INTO b (id, grp, label) VALUES (46, 2, 'b46');
+INSERT INTO b (id, grp, label) VALUES (47, 3, 'b47');
+INSERT INTO b (id, grp, label) VALUES (48, 4, 'b48');
+INSERT INTO b (id, grp, label) VALUES (49, 5, 'b49');
+INSERT INTO b (id, grp, label) VALUES (50, 1, 'b50');
+CREATE INDEX ON b (grp);
+EXPLAIN SELECT a.id, b.id FROM a JOIN b ON a.grp = b.grp WHERE a.id = 3;
+SELECT a.id, b.id FROM a JOIN b ON a.grp = b.grp WHERE a.id = 3;
+SELECT b.label FROM b JOIN a ON b.grp = a.grp WHERE a.id = 1;
+-- A unique inner key still gets the index probe
+EXPLAIN SELECT a.id, b.id FROM b JOIN a ON b.grp = a.id WHERE b.id = 7;
+SELECT a.id, b.id FROM b JOIN a ON b.grp = a.id WHERE b.id = 7;
@@ -0,0 +1,38 @@
+-- Each join strategy returns the same rows; the chooser picks by cost
+CREATE DATABASE jointest;
+CREATE TABLE a (id INT PRIMARY KEY, name VARCHAR(10));
+CREATE TABLE b (id INT PRIMARY KEY, aid INT UNIQUE, v INT);
+INSERT INTO a (id, name) VALUES (1, 'a1');
+INSERT INTO a (id, name) VALUES (2, 'a2');
+INSERT INTO a (id, name) VALUES (3, 'a3');
+INSERT INTO a (id, name) VALUES (4, 'a4');
+INSERT INTO a (id, name) VALUES (5, 'a5');
+INSERT INTO a (id, name) VALUES (6, 'a6');
+INSERT INTO a (id, name) VALUES (7, 'a7');
+INSERT INTO a (id, name) VALUES (8, 'a8');
+INSERT INTO a (id, name) VALUES (9, 'a9');
+INSERT INTO a (id, name) VALUES (10, 'a10');
+INSERT INTO a (id, name) VALUES (11, 'a11');
+INSERT INTO a (id, name) VALUES (12, 'a12');
+INSERT INTO b (id, aid, v) VALUES (101, 2, 1);
+INSERT INTO b (id, aid, v) VALUES (102, 4, 2);
+INSERT INTO b (id, aid, v) VALUES (103, 6, 3);
+INSERT INTO b (id, aid, v) VALUES (104, 8, 4);
+INSERT INTO b (id, aid, v) VALUES (105, 10, 5);
+INSERT INTO b (id, aid, v) VALUES (106, 12, 6);
+INSERT INTO b (id, aid, v) VALUES (107, 14, 7);
+INSERT INTO b (id, aid, v) VALUES (108, 16, 8);
+INSERT INTO b (id, aid, v) VALUES (109, 18, 9);
+INSERT INTO b (id, aid, v) VALUES (110, 20, 10);
+INSERT INTO b (id, aid, v) VALUES (111, 22, 11);
+INSERT INTO b (id, aid, v) VALUES (112, 24, 12);
+-- Both sides ordered on unique join columns
+EXPLAIN SELECT a.id, b.v FROM a JOIN b ON a.id = b.aid;
+SELECT a.id, b.v FROM a JOIN b ON a.id = b.aid;
+-- One outer row, probe the other side's primary key
+EXPLAIN SELECT a.name, b.v FROM a JOIN b ON a.id = b.aid WHERE b.id = 105;
+SELECT a.name, b.v FROM a JOIN b ON a.id = b.aid WHERE b.id = 105;
+-- A filtered scan probes the unique index on the other side
+EXPLAIN SELECT a.id, b.v FROM a JOIN b ON a.id = b.aid WHERE a.name = 'a4';
+SELECT a.id, b.v FROM a JOIN b ON a.id = b.aid WHERE a.name = 'a4';
+SELECT b.id, a.name FROM b JOIN a ON b.aid = a.id WHERE v > 4 ORDER BY b.id DESC LIMIT 2;
@@ -0,0 +1,12 @@
+-- Unqualified WHERE columns are resolved against both joined tables
+CREATE DATABASE ambtest;
+CREATE TABLE a (id INT PRIMARY KEY, x INT);
+CREATE TABLE b (id INT PRIMARY KEY, aid INT, y INT);
+INSERT INTO a (id, x) VALUES (1, 10);
+INSERT INTO a (id, x) VALUES (2, 20);
+INSERT INTO b (id, aid, y) VALUES (1, 2, 100);
+INSERT INTO b (id, aid, y) VALUES (2, 1, 200);
+SELECT a.x, b.y FROM a JOIN b ON a.id = b.aid WHERE id = 2;
+SELECT a.x, b.y FROM a JOIN b ON a.id = b.aid WHERE a.id = 2;
+SELECT a.x, b.y FROM a JOIN b ON a.id = b.aid WHERE y = 200;
+SELECT a.x, b.y FROM a JOIN b ON a.id = b.aid WHERE nope = 1;
@@ -0,0 +1,16 @@
+-- A database that only has the JSON schema is imported at startup, and
+-- legacy index constraints are migrated on the way in
+INSERT INTO people (name, grp) VALUES ('ann', 1);
+INSERT INTO people (name, city, grp) VALUES ('bob', 'Bern', 2);
+INSERT INTO people (name, grp) VALUES ('cat', 1);
+-- repeat 4 60 INSERT INTO people (name, grp) VALUES ('p{i}', {i});
+INSERT INTO people (name) VALUES ('ann');
+SELECT id, name, city, grp FROM people WHERE id < 5;
+EXPLAIN SELECT id FROM people WHERE name = 'bob';
+EXPLAIN SELECT id FROM people WHERE grp = 1;
+SELECT id, name FROM people WHERE grp = 1;
+INSERT INTO metrics (at, reading) VALUES (1, 10);
+SELECT at, reading, label FROM metrics;
+-- restart
+SELECT id, name, city FROM people WHERE grp = 1;
+EXPLAIN SELECT id FROM people WHERE name = 'cat';
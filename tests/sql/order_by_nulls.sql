@@ -0,0 +1,16 @@
+-- ORDER BY a nullable unique column keeps its NULL rows, with or without LIMIT
+CREATE DATABASE nulltest;
+CREATE TABLE t (id INT PRIMARY KEY, code VARCHAR(10) UNIQUE, n INT NOT NULL DEFAULT 0);
+-- repeat 1 197 INSERT INTO t (id, code) VALUES ({i}, 'c{i}');
+INSERT INTO t (id) VALUES (198);
+INSERT INTO t (id) VALUES (199);
+SELECT id, code FROM t WHERE id >= 196 ORDER BY code;
+EXPLAIN SELECT id, code FROM t ORDER BY code LIMIT 2;
+SELECT id, code FROM t ORDER BY code LIMIT 2;
+SELECT id, code FROM t WHERE id >= 196 ORDER BY code LIMIT 2;
+-- A comparison on the column rules NULLs out, so the walk is safe
+EXPLAIN SELECT id, code FROM t WHERE code > 'c1' ORDER BY code LIMIT 2;
+SELECT id, code FROM t WHERE code > 'c1' ORDER BY code LIMIT 2;
+-- The primary key is never NULL
+EXPLAIN SELECT id FROM t ORDER BY id LIMIT 2;
+SELECT id FROM t ORDER BY id LIMIT 2;
@@ -0,0 +1,8 @@
+-- Exports cut short before their rename leave .tmp files; startup ignores and removes them
+INSERT INTO t (id, item) VALUES (1, 'pen');
+SELECT id, item FROM t;
+CREATE TABLE u (id INT PRIMARY KEY);
+-- restart
+SELECT id, item FROM t;
+INSERT INTO u (id) VALUES (7);
+SELECT id FROM u;
@@ -0,0 +1,12 @@
+-- UPDATE of an AUTO_INCREMENT column moves the sequence past the new value
+CREATE DATABASE seqtest;
+CREATE TABLE t (id INT PRIMARY KEY AUTO_INCREMENT, name VARCHAR(10));
+INSERT INTO t (name) VALUES ('a');
+INSERT INTO t (name) VALUES ('b');
+UPDATE t SET id = 100 WHERE id = 2;
+UPDATE t SET id = 40 WHERE id = 1;
+INSERT INTO t (name) VALUES ('c');
+SELECT id, name FROM t;
+-- restart
+INSERT INTO t (name) VALUES ('d');
+SELECT id, name FROM t WHERE id > 100;
@@ -0,0 +1,29 @@
+-- UPDATE and DELETE keep every index pointing at the current rows
+CREATE DATABASE writetest;
+CREATE TABLE t (id INT PRIMARY KEY, code VARCHAR(10) UNIQUE, grp INT, note VARCHAR(40));
+INSERT INTO t (id, code, grp, note) VALUES (1, 'c1', 1, 'n');
+INSERT INTO t (id, code, grp, note) VALUES (2, 'c2', 2, 'n');
+INSERT INTO t (id, code, grp, note) VALUES (3, 'c3', 0, 'n');
+INSERT INTO t (id, code, grp, note) VALUES (4, 'c4', 1, 'n');
+INSERT INTO t (id, code, grp, note) VALUES (5, 'c5', 2, 'n');
+INSERT INTO t (id, code, grp, note) VALUES (6, 'c6', 0, 'n');
+INSERT INTO t (id, code, grp, note) VALUES (7, 'c7', 1, 'n');
+INSERT INTO t (id, code, grp, note) VALUES (8, 'c8', 2, 'n');
+INSERT INTO t (id, code, grp, note) VALUES (9, 'c9', 0, 'n');
+INSERT INTO t (id, code, grp, note) VALUES (10, 'c10', 1, 'n');
+CREATE INDEX ON t (grp);
+UPDATE t SET code = 'x3' WHERE id = 3;
+SELECT id FROM t WHERE code = 'c3';
+SELECT id, code FROM t WHERE code = 'x3';
+UPDATE t SET code = 'c4' WHERE id = 5;
+UPDATE t SET grp = 7, note = 'a note that no longer fits in place' WHERE grp = 1;
+SELECT id, grp FROM t WHERE grp = 1;
+SELECT id, code FROM t WHERE grp = 7;
+DELETE FROM t WHERE code = 'c10';
+DELETE FROM t WHERE id > 8;
+SELECT id FROM t WHERE id >= 8;
+INSERT INTO t (id, code, grp, note) VALUES (9, 'c10', 0, 'again');
+-- restart
+SELECT id, code, grp FROM t WHERE grp = 7;
+SELECT id, code FROM t WHERE code = 'c10';
+SELECT id FROM t WHERE id = 10;
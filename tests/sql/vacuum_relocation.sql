@@ -0,0 +1,42 @@
+-- VACUUM moves live rows into the freed space and re-points every index
+CREATE DATABASE vactest;
+CREATE TABLE t (id INT PRIMARY KEY, code VARCHAR(10) UNIQUE, grp INT, body VARCHAR(40));
+INSERT INTO t (id, code, grp, body) VALUES (1, 'k1', 1, 'row 1');
+INSERT INTO t (id, code, grp, body) VALUES (2, 'k2', 2, 'row 2');
+INSERT INTO t (id, code, grp, body) VALUES (3, 'k3', 3, 'row 3');
+INSERT INTO t (id, code, grp, body) VALUES (4, 'k4', 0, 'row 4');
+INSERT INTO t (id, code, grp, body) VALUES (5, 'k5', 1, 'row 5');
+INSERT INTO t (id, code, grp, body) VALUES (6, 'k6', 2, 'row 6');
+INSERT INTO t (id, code, grp, body) VALUES (7, 'k7', 3, 'row 7');
+INSERT INTO t (id, code, grp, body) VALUES (8, 'k8', 0, 'row 8');
+INSERT INTO t (id, code, grp, body) VALUES (9, 'k9', 1, 'row 9');
+INSERT INTO t (id, code, grp, body) VALUES (10, 'k10', 2, 'row 10');
+INSERT INTO t (id, code, grp, body) VALUES (11, 'k11', 3, 'row 11');
+INSERT INTO t (id, code, grp, body) VALUES (12, 'k12', 0, 'row 12');
+INSERT INTO t (id, code, grp, body) VALUES (13, 'k13', 1, 'row 13');
+INSERT INTO t (id, code, grp, body) VALUES (14, 'k14', 2, 'row 14');
+INSERT INTO t (id, code, grp, body) VALUES (15, 'k15', 3, 'row 15');
+INSERT INTO t (id, code, grp, body) VALUES (16, 'k16', 0, 'row 16');
+INSERT INTO t (id, code, grp, body) VALUES (17, 'k17', 1, 'row 17');
+INSERT INTO t (id, code, grp, body) VALUES (18, 'k18', 2, 'row 18');
+INSERT INTO t (id, code, grp, body) VALUES (19, 'k19', 3, 'row 19');
+INSERT INTO t (id, code, grp, body) VALUES (20, 'k20', 0, 'row 20');
+INSERT INTO t (id, code, grp, body) VALUES (21, 'k21', 1, 'row 21');
+INSERT INTO t (id, code, grp, body) VALUES (22, 'k22', 2, 'row 22');
+INSERT INTO t (id, code, grp, body) VALUES (23, 'k23', 3, 'row 23');
+INSERT INTO t (id, code, grp, body) VALUES (24, 'k24', 0, 'row 24');
+CREATE INDEX code_hash ON t (code) USING HASH;
+CREATE INDEX ON t (grp) INCLUDE (code);
+DELETE FROM t WHERE id < 13;
+VACUUM t;
+VACUUM t;
+SELECT id, code FROM t WHERE id = 20;
+SELECT id FROM t WHERE code = 'k17';
+EXPLAIN SELECT code FROM t WHERE grp = 2;
+SELECT code FROM t WHERE grp = 2;
+SELECT id FROM t WHERE id < 16;
+-- restart
+SELECT id, body FROM t WHERE code = 'k24';
+SELECT code FROM t WHERE grp = 3;
+INSERT INTO t (id, code, grp, body) VALUES (1, 'k1', 1, 'back');
+SELECT id, code FROM t WHERE grp = 1;
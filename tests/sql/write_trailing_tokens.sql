@@ -0,0 +1,9 @@
+-- UPDATE and DELETE refuse input they cannot parse instead of dropping the WHERE
+CREATE DATABASE trailtest;
+CREATE TABLE t (id INT PRIMARY KEY, n INT);
+INSERT INTO t (id, n) VALUES (1, 10);
+INSERT INTO t (id, n) VALUES (2, 20);
+UPDATE t SET n = n + 5 WHERE id = 1;
+DELETE FROM t x WHERE id = 1;
+UPDATE t SET n = 11 WHERE id = 1;
+SELECT id, n FROM t;
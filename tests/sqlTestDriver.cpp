@@ -0,0 +1,153 @@
+// Runs one SQL script against the database files in the working directory
+// and prints what every statement reports, for run_tests.sh to compare with
+// the script's .expected file. The vacuum worker is not started, so rows
+// only move when a script says VACUUM.
+//
+// usage: sqlTestDriver <script.sql>
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <regex>
+
+#include "../SQL_LEXER.hpp"
+#include "../SQL_PARSER.hpp"
+#include "../initialLoad.hpp"
+
+// `-- repeat FROM TO statement` runs the statement once for every i in
+// [FROM, TO], with {i} and {i%N} replaced, to fill tables beyond what is
+// worth spelling out line by line
+static void expandRepeat(const std::string &line, std::vector<std::string> &statements)
+{
+    std::istringstream in(line.substr(std::string("-- repeat").size()));
+    long from = 0, to = -1;
+    in >> from >> to;
+    std::string statement;
+    std::getline(in >> std::ws, statement);
+    static const std::regex placeholder("\\{i(%([0-9]+))?\\}");
+    for (long i = from; i <= to; ++i)
+    {
+        std::string expanded;
+        auto rest = statement.cbegin();
+        for (std::sregex_iterator match(statement.begin(), statement.end(), placeholder), end; match != end; ++match)
+        {
+            expanded.append(rest, (*match)[0].first);
+            expanded += std::to_string((*match)[2].matched ? i % std::stol((*match)[2].str()) : i);
+            rest = (*match)[0].second;
+        }
+        expanded.append(rest, statement.cend());
+        statements.push_back(expanded);
+    }
+}
+
+// Statements end at a ';' outside quotes, `--` starts a comment line
+static std::vector<std::string> splitStatements(const std::string &script)
+{
+    std::vector<std::string> statements;
+    std::string current;
+    std::istringstream lines(script);
+    std::string line;
+    while (std::getline(lines, line))
+    {
+        if (line.rfind("-- repeat ", 0) == 0)
+        {
+            expandRepeat(line, statements);
+            continue;
+        }
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line.compare(first, 2, "--") == 0)
+            continue;
+        bool quoted = false;
+        for (char c : line)
+        {
+            if (c == '\'')
+                quoted = !quoted;
+            current.push_back(c);
+            if (c == ';' && !quoted)
+            {
+                statements.push_back(current.substr(current.find_first_not_of(" \t\r\n")));
+                current.clear();
+            }
+        }
+        current.push_back('\n');
+    }
+    if (current.find_first_not_of(" \t\r\n") != std::string::npos)
+        statements.push_back(current.substr(current.find_first_not_of(" \t\r\n")));
+    return statements;
+}
+
+// Output that depends on the run rather than on the statement
+static bool isNoise(const std::string &line)
+{
+    return line.rfind("hfff", 0) == 0 || line.rfind("Created directory", 0) == 0 ||
+           (line.rfind("File '", 0) == 0 && line.find("created and initialized") != std::string::npos);
+}
+
+// EXPLAIN ANALYZE timings change from run to run
+static std::string normalize(const std::string &line)
+{
+    static const std::regex timing("[0-9]+(\\.[0-9]+)?(e-?[0-9]+)? ms");
+    return std::regex_replace(line, timing, "N ms");
+}
+
+int main(int argc, char const *argv[])
+{
+    if (argc != 2)
+    {
+        std::cerr << "usage: " << argv[0] << " <script.sql>" << std::endl;
+        return 2;
+    }
+    std::ifstream in(argv[1]);
+    if (!in)
+    {
+        std::cerr << "cannot read " << argv[1] << std::endl;
+        return 2;
+    }
+    std::stringstream script;
+    script << in.rdbuf();
+
+    std::filesystem::create_directories(tableDirectory);
+    std::ostringstream captured;
+    std::streambuf *stdoutBuffer = std::cout.rdbuf(captured.rdbuf());
+    initialDatabseLoad();
+    initializePrimaryIndexBtrees();
+
+    for (const auto &sql : splitStatements(script.str()))
+    {
+        captured.str("");
+        std::string error;
+        try
+        {
+            Lexer lexer(sql);
+            std::vector<Token *> tokens = lexer.tokenize();
+            Parser parser(tokens);
+            parser.parse();
+        }
+        catch (const std::exception &e)
+        {
+            error = e.what();
+        }
+
+        // INSERT echoes the whole statement, only its failures are worth comparing
+        bool insert = sql.size() >= 6 && strncasecmp(sql.c_str(), "insert", 6) == 0;
+        std::cout.rdbuf(stdoutBuffer);
+        if (!insert || !error.empty())
+            std::cout << ">> " << sql << "\n";
+        std::istringstream output(captured.str());
+        std::string line;
+        while (!insert && std::getline(output, line))
+        {
+            if (!isNoise(line))
+                std::cout << normalize(line) << "\n";
+        }
+        if (!error.empty())
+            std::cout << "Error: " << error << "\n";
+        std::cout.rdbuf(captured.rdbuf());
+    }
+
+    std::cout.rdbuf(stdoutBuffer);
+    return 0;
+}
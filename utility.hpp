@@ -11,6 +11,7 @@
 #include "global.hpp" // Assuming this is a necessary include
 #include <utility>
 #include "databaseSchemaReader.hpp"
+#include "catalog.hpp"
 namespace MyUtility
 {                                   // Define a namespace called MyUtility
     namespace fs = std::filesystem; // Shorthand for std::filesystem
@@ -78,29 +79,15 @@ namespace MyUtility
         }
     }
 
+    // Served from the in-memory catalog, which DDL keeps current, so no file is read
     std::pair<bool, std::string> checkIfTableExist(const std::string &table)
     {
-        std::stringstream s;
-        s << "./db/";
-        s << currentDatabase;
-        s << ".shivam.db";
-        PythonLikeJSONParser parser;
-
-        if (checkIfFileExist(s.str()))
-        {
-            std::cout << "\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n";
-            parser.loadFromFile(s.str());
-            JSONArrayWrapper columns = parser[0][std::string("tables")].asArray();
-            for(size_t i = 0;i<columns.size();i++){
-                std::string tableName = columns[i][std::string("name")];
-                if( tableName== table){
-                    return std::make_pair(true,"");
-                }
-            }
-            
-        }
-
-        return std::make_pair(false, "the database not exist");
+        auto snapshot = Catalog::current();
+        if (!snapshot->database(currentDatabase))
+            return std::make_pair(false, "the database not exist");
+        if (!snapshot->table(currentDatabase, table))
+            return std::make_pair(false, "Table '" + table + "' does not exist in DB '" + currentDatabase + "'");
+        return std::make_pair(true, "");
     }
 
 } // namespace MyUtility
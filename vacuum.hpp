@@ -0,0 +1,154 @@
+#ifndef __VACUUM
+#define __VACUUM
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include "global.hpp"
+#include "rowStorage.hpp"
+#include "catalog.hpp"
+
+// Compact one table and re-point its in-memory indexes at the moved rows.
+// bytesPerSecond = 0 runs unthrottled.
+inline TableStorage::CompactionStats vacuumTable(const std::shared_ptr<TableStorage> &storage, int64_t bytesPerSecond)
+{
+    // Moves run under the exclusive statement lock, which DDL also publishes
+    // under, so the entry is read per move and an index created meanwhile is kept up too
+    auto onMove = [&storage](const Row &row, const IndexNode &from, const IndexNode &to)
+    {
+        auto table = Catalog::findTable(storage->getDatabaseName(), storage->getTableName());
+        if (!table)
+            return;
+        for (const auto &entry : table->indexes)
+        {
+            const TreeVariant &index = entry.second;
+            Catalog::ColumnId position = table->column(entry.first);
+            IndexNode current;
+            if (indexSearch(index, row[position], current) && current.start == from.start)
+                indexInsert(index, row[position], to);
+        }
+        for (const auto &index : table->compositeIndexes)
+        {
+            compositeRemove(index, row, from);
+            compositeInsert(index, row, to);
+        }
+    };
+    return storage->compact(bytesPerSecond, onMove);
+}
+
+struct VacuumOptions
+{
+    int64_t bytesPerSecond = 8 * 1024 * 1024;
+    std::chrono::milliseconds interval{5000};
+    double fragmentationThreshold = 0.25; // dead share of the data file
+    int64_t minDeadBytes = 64 * 1024;
+};
+
+// Background thread that vacuums fragmented tables, throttled so it does not
+// starve foreground statements of disk bandwidth.
+class VacuumWorker
+{
+private:
+    VacuumOptions options;
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    bool running = false;
+    bool woken = false;
+
+    std::vector<std::shared_ptr<TableStorage>> openTables()
+    {
+        std::vector<std::shared_ptr<TableStorage>> tables;
+        for (const auto &table : Catalog::current()->tables)
+        {
+            if (auto storage = table->openStorage())
+                tables.push_back(storage);
+        }
+        return tables;
+    }
+
+    void runOnce()
+    {
+        for (const auto &storage : openTables())
+        {
+            auto [deadBytes, ratio] = storage->fragmentation();
+            if (deadBytes < options.minDeadBytes || ratio < options.fragmentationThreshold)
+                continue;
+
+            try
+            {
+                auto stats = vacuumTable(storage, options.bytesPerSecond);
+                std::cout << "🧹 Vacuumed '" << storage->getTableName() << "': moved " << stats.rowsMoved
+                          << " rows, reclaimed " << stats.bytesReclaimed << " bytes\n";
+            }
+            catch (const std::exception &e)
+            {
+                std::cerr << "❌ Vacuum of '" << storage->getTableName() << "' failed: " << e.what() << "\n";
+            }
+        }
+    }
+
+    void loop()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (running)
+        {
+            wakeup.wait_for(lock, options.interval, [this]
+                            { return !running || woken; });
+            if (!running)
+                break;
+            woken = false;
+
+            lock.unlock();
+            runOnce();
+            lock.lock();
+        }
+    }
+
+public:
+    ~VacuumWorker()
+    {
+        stop();
+    }
+
+    void start(const VacuumOptions &opts = VacuumOptions())
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (running)
+            return;
+        options = opts;
+        running = true;
+        worker = std::thread(&VacuumWorker::loop, this);
+    }
+
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!running)
+                return;
+            running = false;
+        }
+        wakeup.notify_all();
+        worker.join();
+    }
+
+    // Check the tables now instead of waiting for the next interval
+    void wake()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            woken = true;
+        }
+        wakeup.notify_all();
+    }
+};
+
+inline VacuumWorker vacuumWorker;
+
+#endif // __VACUUM